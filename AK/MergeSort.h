@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/InsertionSort.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Try.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// A stable sort: elements that compare equal keep the order they had before.
+// This is a bottom-up merge sort, which sorts short runs with insertion sort first and then keeps merging
+// neighbouring runs into runs twice as long. Merging needs a buffer for half of the elements.
+
+namespace Detail {
+
+static constexpr size_t merge_sort_run_length = 16;
+
+template<typename Collection, typename T, typename LessThan>
+void merge_runs(Collection& col, Vector<T>& buffer, size_t start, size_t middle, size_t end, LessThan& less_than)
+{
+    // If the runs are in order already (e.g. because the input was sorted), there is nothing to do.
+    if (!less_than(col[middle], col[middle - 1]))
+        return;
+
+    // We only ever move the shorter run into the buffer, and then fill the gap it left from the far side.
+    if (middle - start <= end - middle) {
+        for (size_t i = start; i < middle; ++i)
+            buffer.unchecked_append(move(col[i]));
+
+        size_t left = 0;
+        size_t right = middle;
+        size_t out = start;
+        while (left < buffer.size() && right < end) {
+            // NOTE: Equal elements are taken from the left run first, which is what makes this stable.
+            if (less_than(col[right], buffer[left]))
+                col[out++] = move(col[right++]);
+            else
+                col[out++] = move(buffer[left++]);
+        }
+        while (left < buffer.size())
+            col[out++] = move(buffer[left++]);
+    } else {
+        for (size_t i = middle; i < end; ++i)
+            buffer.unchecked_append(move(col[i]));
+
+        size_t left = middle;
+        size_t right = buffer.size();
+        size_t out = end;
+        while (right > 0 && left > start) {
+            // NOTE: Equal elements are taken from the right run first, as we are filling in from the back.
+            if (less_than(buffer[right - 1], col[left - 1]))
+                col[--out] = move(col[--left]);
+            else
+                col[--out] = move(buffer[--right]);
+        }
+        while (right > 0)
+            col[--out] = move(buffer[--right]);
+    }
+
+    buffer.clear_with_capacity();
+}
+
+}
+
+template<typename Collection, typename LessThan>
+ErrorOr<void> try_merge_sort(Collection& collection, LessThan less_than)
+{
+    using ElementType = RemoveCVReference<decltype(collection[0])>;
+
+    size_t size = collection.size();
+    if (size < 2)
+        return {};
+
+    for (size_t start = 0; start < size; start += Detail::merge_sort_run_length)
+        insertion_sort(collection, start, min(start + Detail::merge_sort_run_length, size) - 1, less_than);
+    if (size <= Detail::merge_sort_run_length)
+        return {};
+
+    Vector<ElementType> buffer;
+    TRY(buffer.try_ensure_capacity(size / 2));
+
+    for (size_t run_length = Detail::merge_sort_run_length; run_length < size; run_length *= 2) {
+        for (size_t start = 0; start + run_length < size; start += 2 * run_length)
+            Detail::merge_runs(collection, buffer, start, start + run_length, min(start + 2 * run_length, size), less_than);
+    }
+    return {};
+}
+
+template<typename Collection>
+ErrorOr<void> try_merge_sort(Collection& collection)
+{
+    return try_merge_sort(collection, [](auto& a, auto& b) { return a < b; });
+}
+
+template<typename Collection, typename LessThan>
+void merge_sort(Collection& collection, LessThan less_than)
+{
+    MUST(try_merge_sort(collection, move(less_than)));
+}
+
+template<typename Collection>
+void merge_sort(Collection& collection)
+{
+    MUST(try_merge_sort(collection));
+}
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::merge_sort;
+using AK::try_merge_sort;
+#endif
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/InsertionSort.h>
+#include <AK/IntegralMath.h>
 #include <AK/StdLibExtras.h>
 
 namespace AK {
@@ -104,6 +105,239 @@ void dual_pivot_quick_sort(Collection& col, int start, int end, LessThan less_th
     }
 }
 
+// This is a pattern-defeating quick sort, as described by Orson Peters in https://arxiv.org/abs/2106.05123.
+// It is what quick_sort() uses for collections. Unlike the dual pivot quick sort above, it can't go quadratic:
+// it recognizes inputs that are already (mostly) sorted or consist of many equal elements, shuffles things
+// around when it keeps getting bad partitions, and falls back to heap sort if that doesn't help either.
+//
+// Elements are only ever swapped, never moved into temporaries, so this also works for collections whose
+// operator[] returns a proxy object, as long as there is a swap() for it.
+
+namespace Detail {
+
+static constexpr ssize_t pdq_insertion_sort_threshold = 24;
+static constexpr ssize_t pdq_ninther_threshold = 128;
+static constexpr ssize_t pdq_partial_insertion_sort_limit = 8;
+
+template<typename Collection, typename LessThan>
+void sort2(Collection& col, ssize_t a, ssize_t b, LessThan& less_than)
+{
+    if (less_than(col[b], col[a]))
+        swap(col[a], col[b]);
+}
+
+template<typename Collection, typename LessThan>
+void sort3(Collection& col, ssize_t a, ssize_t b, ssize_t c, LessThan& less_than)
+{
+    sort2(col, a, b, less_than);
+    sort2(col, b, c, less_than);
+    sort2(col, a, b, less_than);
+}
+
+template<typename Collection, typename LessThan>
+void sift_down(Collection& col, ssize_t start, ssize_t root, ssize_t size, LessThan& less_than)
+{
+    for (;;) {
+        auto child = 2 * root + 1;
+        if (child >= size)
+            return;
+        if (child + 1 < size && less_than(col[start + child], col[start + child + 1]))
+            ++child;
+        if (!less_than(col[start + root], col[start + child]))
+            return;
+        swap(col[start + root], col[start + child]);
+        root = child;
+    }
+}
+
+// Heap sort, with `end` inclusive!
+template<typename Collection, typename LessThan>
+void heap_sort(Collection& col, ssize_t start, ssize_t end, LessThan& less_than)
+{
+    auto size = end - start + 1;
+    for (auto root = size / 2 - 1; root >= 0; --root)
+        sift_down(col, start, root, size, less_than);
+    for (auto last = size - 1; last > 0; --last) {
+        swap(col[start], col[start + last]);
+        sift_down(col, start, 0, last, less_than);
+    }
+}
+
+// Insertion sort that gives up once it had to move too many elements. Returns whether the range is sorted.
+template<typename Collection, typename LessThan>
+bool partial_insertion_sort(Collection& col, ssize_t start, ssize_t end, LessThan& less_than)
+{
+    ssize_t moves = 0;
+    for (auto i = start + 1; i <= end; ++i) {
+        auto j = i;
+        for (; j > start && less_than(col[j], col[j - 1]); --j)
+            swap(col[j], col[j - 1]);
+        moves += i - j;
+        if (moves > pdq_partial_insertion_sort_limit)
+            return false;
+    }
+    return true;
+}
+
+struct PartitionResult {
+    ssize_t pivot_position;
+    bool was_already_partitioned;
+};
+
+// Partitions the range around the pivot at `start` into elements less than it, and elements greater than or equal to it.
+// NOTE: The scans rely on the pivot selection to leave an element that is not less than the pivot in the range,
+//       and on the elements that were already swapped to stop them otherwise.
+template<typename Collection, typename LessThan>
+PartitionResult partition_right(Collection& col, ssize_t start, ssize_t end, LessThan& less_than)
+{
+    auto&& pivot = col[start];
+    auto first = start;
+    auto last = end + 1;
+
+    while (less_than(col[++first], pivot))
+        ;
+    if (first - 1 == start) {
+        while (first < last && !less_than(col[--last], pivot))
+            ;
+    } else {
+        while (!less_than(col[--last], pivot))
+            ;
+    }
+
+    bool was_already_partitioned = first >= last;
+    while (first < last) {
+        swap(col[first], col[last]);
+        while (less_than(col[++first], pivot))
+            ;
+        while (!less_than(col[--last], pivot))
+            ;
+    }
+
+    auto pivot_position = first - 1;
+    swap(col[start], col[pivot_position]);
+    return { pivot_position, was_already_partitioned };
+}
+
+// Partitions the range around the pivot at `start` into elements less than or equal to it, and elements greater than it.
+template<typename Collection, typename LessThan>
+ssize_t partition_left(Collection& col, ssize_t start, ssize_t end, LessThan& less_than)
+{
+    auto&& pivot = col[start];
+    auto first = start;
+    auto last = end + 1;
+
+    while (less_than(pivot, col[--last]))
+        ;
+    if (last == end) {
+        while (first < last && !less_than(pivot, col[++first]))
+            ;
+    } else {
+        while (!less_than(pivot, col[++first]))
+            ;
+    }
+
+    while (first < last) {
+        swap(col[first], col[last]);
+        while (less_than(pivot, col[--last]))
+            ;
+        while (!less_than(pivot, col[++first]))
+            ;
+    }
+
+    swap(col[start], col[last]);
+    return last;
+}
+
+template<typename Collection, typename LessThan>
+void pattern_defeating_quick_sort(Collection& col, ssize_t start, ssize_t end, LessThan& less_than, int bad_partitions_allowed, bool is_leftmost)
+{
+    for (;;) {
+        auto size = end - start + 1;
+        if (size <= pdq_insertion_sort_threshold) {
+            AK::insertion_sort(col, start, end, less_than);
+            return;
+        }
+
+        // Move the median of three (or of three medians of three, for large ranges) to the front, to use it as the pivot.
+        auto half = size / 2;
+        if (size > pdq_ninther_threshold) {
+            sort3(col, start, start + half, end, less_than);
+            sort3(col, start + 1, start + half - 1, end - 1, less_than);
+            sort3(col, start + 2, start + half + 1, end - 2, less_than);
+            sort3(col, start + half - 1, start + half, start + half + 1, less_than);
+            swap(col[start], col[start + half]);
+        } else {
+            sort3(col, start + half, start, end, less_than);
+        }
+
+        // If the element in front of the range is equal to the pivot, no element in the range can be less than the pivot.
+        // So we put all the elements that are equal to it on the left, and don't have to look at them ever again.
+        if (!is_leftmost && !less_than(col[start - 1], col[start])) {
+            start = partition_left(col, start, end, less_than) + 1;
+            continue;
+        }
+
+        auto [pivot_position, was_already_partitioned] = partition_right(col, start, end, less_than);
+        auto left_size = pivot_position - start;
+        auto right_size = end - pivot_position;
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_partitions_allowed == 0) {
+                heap_sort(col, start, end, less_than);
+                return;
+            }
+
+            // Shuffle some elements around, to break up whatever pattern gave us the bad pivot.
+            if (left_size >= pdq_insertion_sort_threshold) {
+                swap(col[start], col[start + left_size / 4]);
+                swap(col[pivot_position - 1], col[pivot_position - left_size / 4]);
+                if (left_size > pdq_ninther_threshold) {
+                    swap(col[start + 1], col[start + left_size / 4 + 1]);
+                    swap(col[start + 2], col[start + left_size / 4 + 2]);
+                    swap(col[pivot_position - 2], col[pivot_position - left_size / 4 - 1]);
+                    swap(col[pivot_position - 3], col[pivot_position - left_size / 4 - 2]);
+                }
+            }
+            if (right_size >= pdq_insertion_sort_threshold) {
+                swap(col[pivot_position + 1], col[pivot_position + right_size / 4 + 1]);
+                swap(col[end], col[end - right_size / 4 + 1]);
+                if (right_size > pdq_ninther_threshold) {
+                    swap(col[pivot_position + 2], col[pivot_position + right_size / 4 + 2]);
+                    swap(col[pivot_position + 3], col[pivot_position + right_size / 4 + 3]);
+                    swap(col[end - 1], col[end - right_size / 4]);
+                    swap(col[end - 2], col[end - right_size / 4 - 1]);
+                }
+            }
+        } else if (was_already_partitioned) {
+            // If nothing had to be swapped, the input might just be sorted already.
+            if (partial_insertion_sort(col, start, pivot_position - 1, less_than) && partial_insertion_sort(col, pivot_position + 1, end, less_than))
+                return;
+        }
+
+        // Recurse into the smaller part, to keep the stack depth at log(n).
+        if (left_size < right_size) {
+            pattern_defeating_quick_sort(col, start, pivot_position - 1, less_than, bad_partitions_allowed, is_leftmost);
+            start = pivot_position + 1;
+            is_leftmost = false;
+        } else {
+            pattern_defeating_quick_sort(col, pivot_position + 1, end, less_than, bad_partitions_allowed, false);
+            end = pivot_position - 1;
+        }
+    }
+}
+
+}
+
+// Pattern-defeating quick sort, with `end` inclusive!
+template<typename Collection, typename LessThan>
+void pattern_defeating_quick_sort(Collection& col, ssize_t start, ssize_t end, LessThan less_than)
+{
+    if (end <= start)
+        return;
+    auto size = static_cast<size_t>(end - start + 1);
+    Detail::pattern_defeating_quick_sort(col, start, end, less_than, static_cast<int>(AK::log2(size)), true);
+}
+
 template<typename Iterator, typename LessThan>
 void single_pivot_quick_sort(Iterator start, Iterator end, LessThan less_than)
 {
@@ -154,13 +388,13 @@ void quick_sort(Iterator start, Iterator end, LessThan less_than)
 template<typename Collection, typename LessThan>
 void quick_sort(Collection& collection, LessThan less_than)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1, move(less_than));
+    pattern_defeating_quick_sort(collection, 0, static_cast<ssize_t>(collection.size()) - 1, move(less_than));
 }
 
 template<typename Collection>
 void quick_sort(Collection& collection)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1,
+    pattern_defeating_quick_sort(collection, 0, static_cast<ssize_t>(collection.size()) - 1,
         [](auto& a, auto& b) { return a < b; });
 }
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// An I/O ring is a block of memory shared between a process and the kernel. It contains a ring of
+// submissions (written by userspace, consumed by the kernel in io_ring_enter()) and a ring of
+// completions (written by the kernel, consumed by userspace). The memory is laid out as follows:
+//
+//     [IORingHeader] ... [IORingSubmission * submission_entries] [IORingCompletion * completion_entries]
+//
+// Both rings are indexed with free-running u32 counters that are masked with (entries - 1).
+// The producer of a ring only ever advances its tail, the consumer only ever advances its head.
+
+#define IO_RING_MAX_ENTRIES 4096
+
+enum class IORingOpcode : u8 {
+    Nop = 0,
+    Read,
+    Write,
+    Poll,
+    Accept,
+};
+
+struct IORingSubmission {
+    IORingOpcode opcode;
+    u8 flags;
+    u16 reserved;
+    i32 fd;
+    // File offset for Read and Write, or -1 to use (and advance) the current offset of the description.
+    i64 offset;
+    u64 buffer;
+    u32 length;
+    // Requested events (POLLIN, POLLOUT) for Poll, SOCK_NONBLOCK and SOCK_CLOEXEC for Accept.
+    u32 op_flags;
+    u64 user_data;
+};
+
+struct IORingCompletion {
+    u64 user_data;
+    // The return value of the operation, or a negated errno value on failure.
+    i64 result;
+};
+
+struct IORingHeader {
+    u32 submission_head;
+    u32 submission_tail;
+    u32 submission_mask;
+    u32 submission_entries;
+    u32 submissions_offset;
+
+    u32 completion_head;
+    u32 completion_tail;
+    u32 completion_mask;
+    u32 completion_entries;
+    u32 completions_offset;
+};
+
+static_assert(sizeof(IORingSubmission) == 40);
+static_assert(sizeof(IORingCompletion) == 16);
+
+// The completion ring is twice as large as the submission ring, so that a full batch of
+// submissions can be processed while userspace still holds on to earlier completions.
+constexpr u32 io_ring_completion_entries(u32 submission_entries)
+{
+    return submission_entries * 2;
+}
+
+constexpr size_t io_ring_submissions_offset()
+{
+    return (sizeof(IORingHeader) + 63) & ~static_cast<size_t>(63);
+}
+
+constexpr size_t io_ring_completions_offset(u32 submission_entries)
+{
+    return (io_ring_submissions_offset() + submission_entries * sizeof(IORingSubmission) + 63) & ~static_cast<size_t>(63);
+}
+
+// The number of bytes that have to be mapped from an I/O ring file descriptor to access both rings.
+constexpr size_t io_ring_mapping_size(u32 submission_entries)
+{
+    return io_ring_completions_offset(submission_entries) + io_ring_completion_entries(submission_entries) * sizeof(IORingCompletion);
+}
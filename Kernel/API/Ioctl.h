@@ -143,6 +143,9 @@ enum IOCtlNumber {
     VIRGL_IOCTL_TRANSFER_DATA,
     KDSETMODE,
     KDGETMODE,
+    TRACE_IOCTL_GET_INFO,
+    TRACE_IOCTL_ENABLE,
+    TRACE_IOCTL_DISABLE,
 };
 
 #define TIOCGPGRP TIOCGPGRP
@@ -202,3 +205,6 @@ enum IOCtlNumber {
 #define VIRGL_IOCTL_TRANSFER_DATA VIRGL_IOCTL_TRANSFER_DATA
 #define KDSETMODE KDSETMODE
 #define KDGETMODE KDGETMODE
+#define TRACE_IOCTL_GET_INFO TRACE_IOCTL_GET_INFO
+#define TRACE_IOCTL_ENABLE TRACE_IOCTL_ENABLE
+#define TRACE_IOCTL_DISABLE TRACE_IOCTL_DISABLE
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// The memory pressure level is derived from how much physical memory is neither in use nor committed.
+// Reading /dev/memory_pressure returns a MemoryPressureEvent, and the device becomes readable again
+// whenever the level changes.
+enum class MemoryPressureLevel : u32 {
+    Normal = 0,
+    // The kernel has started purging volatile memory, and processes should trim their caches.
+    Moderate,
+    // Allocations are about to fail. Processes should release everything they can do without.
+    Critical,
+};
+
+struct MemoryPressureEvent {
+    MemoryPressureLevel level;
+    // Incremented on every change of the level.
+    u32 sequence;
+    u64 available_bytes;
+    u64 total_bytes;
+};
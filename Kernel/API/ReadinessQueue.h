@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// A readiness queue remembers a set of file descriptors and the events (POLLIN, POLLOUT) each of
+// them is interested in. Waiting on the queue only returns the descriptors that are actually ready,
+// so the cost of a wakeup does not depend on the number of registered descriptors.
+
+#define READINESS_QUEUE_ADD 1
+#define READINESS_QUEUE_MODIFY 2
+#define READINESS_QUEUE_REMOVE 3
+
+struct ReadinessEvent {
+    u64 user_data;
+    u32 events;
+    u32 reserved;
+};
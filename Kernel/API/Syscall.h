@@ -115,6 +115,8 @@ enum class NeedsBigProcessLock {
     S(getuid, NeedsBigProcessLock::No)                     \
     S(inode_watcher_add_watch, NeedsBigProcessLock::No)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::No) \
+    S(io_ring_create, NeedsBigProcessLock::No)             \
+    S(io_ring_enter, NeedsBigProcessLock::Yes)             \
     S(ioctl, NeedsBigProcessLock::Yes)                     \
     S(join_thread, NeedsBigProcessLock::Yes)               \
     S(jail_create, NeedsBigProcessLock::No)                \
@@ -149,6 +151,9 @@ enum class NeedsBigProcessLock {
     S(purge, NeedsBigProcessLock::Yes)                     \
     S(read, NeedsBigProcessLock::Yes)                      \
     S(pread, NeedsBigProcessLock::Yes)                     \
+    S(readiness_queue_create, NeedsBigProcessLock::No)     \
+    S(readiness_queue_ctl, NeedsBigProcessLock::No)        \
+    S(readiness_queue_wait, NeedsBigProcessLock::No)       \
     S(readlink, NeedsBigProcessLock::No)                   \
     S(readv, NeedsBigProcessLock::Yes)                     \
     S(realpath, NeedsBigProcessLock::No)                   \
@@ -160,6 +165,7 @@ enum class NeedsBigProcessLock {
     S(scheduler_get_parameters, NeedsBigProcessLock::No)   \
     S(scheduler_set_parameters, NeedsBigProcessLock::No)   \
     S(sendfd, NeedsBigProcessLock::No)                     \
+    S(sendfile, NeedsBigProcessLock::Yes)                  \
     S(sendmsg, NeedsBigProcessLock::Yes)                   \
     S(set_mmap_name, NeedsBigProcessLock::No)              \
     S(set_thread_name, NeedsBigProcessLock::No)            \
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// Tracepoints are fixed places in the kernel that can record a TraceRecord when they are enabled.
+// Every processor writes its records into its own trace buffer, which a reader maps by calling mmap()
+// on /dev/trace with an offset of (processor * TRACE_BUFFER_SIZE). A trace buffer is laid out as follows:
+//
+//     [TraceBufferHeader] ... [TraceRecord * record_count]
+//
+// The buffer is indexed with free-running u64 counters that are taken modulo record_count. The kernel
+// only ever advances head, the reader only ever advances tail. Records that don't fit are dropped.
+
+#define TRACE_BUFFER_SIZE (256 * 1024)
+
+enum class TracepointID : u16 {
+    // arguments: previous tid, next tid, previous thread state, next pid
+    ContextSwitch = 0,
+    // arguments: fault address, instruction pointer, TracePageFaultFlags
+    PageFault,
+    // arguments: device (major << 32 | minor), block index, block count, 1 for writes
+    BlockIOSubmit,
+    // arguments: device (major << 32 | minor), block index, block count, 1 for writes, AsyncDeviceRequest::RequestResult
+    BlockIOComplete,
+    // arguments: syscall function, first four syscall arguments
+    SyscallEnter,
+    // arguments: syscall function, return value (or negated errno)
+    SyscallExit,
+    // arguments: local address, peer address, local port << 16 | peer port, previous state, new state
+    TCPStateChange,
+    __Count,
+};
+
+enum TracePageFaultFlags : u64 {
+    TRACE_PAGE_FAULT_WRITE = 1 << 0,
+    TRACE_PAGE_FAULT_USER = 1 << 1,
+    TRACE_PAGE_FAULT_PROTECTION_VIOLATION = 1 << 2,
+};
+
+struct TraceRecord {
+    u64 timestamp_ns;
+    u32 pid;
+    u32 tid;
+    TracepointID id;
+    u16 processor;
+    u32 reserved;
+    u64 arguments[5];
+};
+
+struct TraceBufferHeader {
+    u64 head;
+    u64 tail;
+    // The number of records that were dropped because the buffer was full.
+    u64 dropped;
+    u32 record_count;
+    u32 records_offset;
+};
+
+struct TraceInfo {
+    u32 processor_count;
+    u32 buffer_size;
+};
+
+static_assert(sizeof(TraceRecord) == 64);
+static_assert(sizeof(TraceBufferHeader) <= sizeof(TraceRecord));
+
+constexpr u32 tracepoint_mask(TracepointID id)
+{
+    return 1u << static_cast<u16>(id);
+}
+
+constexpr u32 all_tracepoints_mask = (1u << static_cast<u16>(TracepointID::__Count)) - 1;
+
+// The records start right after the header, in the slot of the first record.
+constexpr u32 trace_buffer_records_offset()
+{
+    return sizeof(TraceRecord);
+}
+
+constexpr u32 trace_buffer_record_count()
+{
+    return (TRACE_BUFFER_SIZE - trace_buffer_records_offset()) / sizeof(TraceRecord);
+}
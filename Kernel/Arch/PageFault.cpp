@@ -11,6 +11,7 @@
 #include <Kernel/Arch/SafeMem.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Thread.h>
+#include <Kernel/Tasks/Tracepoints.h>
 
 namespace Kernel {
 
@@ -31,6 +32,17 @@ void PageFault::handle(RegisterState& regs)
             return;
     }
 
+    if (Tracepoints::is_enabled(TracepointID::PageFault)) {
+        u64 flags = 0;
+        if (is_write())
+            flags |= TRACE_PAGE_FAULT_WRITE;
+        if (!faulted_in_kernel)
+            flags |= TRACE_PAGE_FAULT_USER;
+        if (is_protection_violation())
+            flags |= TRACE_PAGE_FAULT_PROTECTION_VIOLATION;
+        Tracepoints::hit(TracepointID::PageFault, fault_address, regs.ip(), flags);
+    }
+
     auto current_thread = Thread::current();
 
     if (current_thread) {
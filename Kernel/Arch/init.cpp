@@ -22,9 +22,11 @@
 #include <Kernel/Devices/Generic/DeviceControlDevice.h>
 #include <Kernel/Devices/Generic/FullDevice.h>
 #include <Kernel/Devices/Generic/MemoryDevice.h>
+#include <Kernel/Devices/Generic/MemoryPressureDevice.h>
 #include <Kernel/Devices/Generic/NullDevice.h>
 #include <Kernel/Devices/Generic/RandomDevice.h>
 #include <Kernel/Devices/Generic/SelfTTYDevice.h>
+#include <Kernel/Devices/Generic/TraceDevice.h>
 #include <Kernel/Devices/Generic/ZeroDevice.h>
 #include <Kernel/Devices/HID/Management.h>
 #include <Kernel/Devices/KCOVDevice.h>
@@ -49,6 +51,8 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/MemoryPressureTask.h>
+#include <Kernel/Tasks/PageMergeTask.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
 #include <Kernel/Tasks/SyncTask.h>
@@ -384,6 +388,8 @@ void init_stage2(void*)
     ConsoleManagement::the().initialize();
 
     SyncTask::spawn();
+    PageMergeTask::spawn();
+    MemoryPressureTask::spawn();
     FinalizerTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
@@ -407,6 +413,8 @@ void init_stage2(void*)
     (void)FullDevice::must_create().leak_ref();
     (void)RandomDevice::must_create().leak_ref();
     (void)SelfTTYDevice::must_create().leak_ref();
+    (void)TraceDevice::must_create().leak_ref();
+    (void)MemoryPressureDevice::must_create().leak_ref();
     PTYMultiplexer::initialize();
 
     AudioManagement::the().initialize();
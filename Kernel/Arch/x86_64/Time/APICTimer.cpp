@@ -136,6 +136,15 @@ void APICTimer::enable_local_timer()
     APIC::the().setup_local_timer(m_timer_period, m_timer_mode, true);
 }
 
+void APICTimer::arm_one_shot(u64 nanoseconds)
+{
+    // m_timer_period is the number of bus clock cycles in one of our m_frequency ticks per second.
+    auto& apic = APIC::the();
+    u64 tick_ns = 1'000'000'000ull / m_frequency;
+    u64 bus_cycles = clamp(nanoseconds * m_timer_period / tick_ns, static_cast<u64>(apic.get_timer_divisor()), static_cast<u64>(NumericLimits<u32>::max()));
+    apic.setup_local_timer(static_cast<u32>(bus_cycles), APIC::TimerMode::OneShot, true);
+}
+
 void APICTimer::disable_local_timer()
 {
     APIC::the().setup_local_timer(0, APIC::TimerMode::OneShot, false);
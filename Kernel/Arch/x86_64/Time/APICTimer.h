@@ -31,6 +31,10 @@ public:
     virtual bool is_capable_of_frequency(size_t frequency) const override;
     virtual size_t calculate_nearest_possible_frequency(size_t frequency) const override;
 
+    // NOTE: This arms the timer of the current processor only.
+    virtual bool is_one_shot_capable() const override { return true; }
+    virtual void arm_one_shot(u64 nanoseconds) override;
+
     void will_be_destroyed() override { HardwareTimer<GenericInterruptHandler>::will_be_destroyed(); }
     void enable_local_timer();
     void disable_local_timer();
@@ -174,6 +174,11 @@ UNMAP_AFTER_INIT bool CommandLine::is_legacy_time_enabled() const
     return lookup("time"sv).value_or("modern"sv) == "legacy"sv;
 }
 
+UNMAP_AFTER_INIT bool CommandLine::is_tickless_enabled() const
+{
+    return lookup("tickless"sv).value_or("on"sv) == "on"sv;
+}
+
 bool CommandLine::is_pc_speaker_enabled() const
 {
     auto value = lookup("pcspeaker"sv).value_or("off"sv);
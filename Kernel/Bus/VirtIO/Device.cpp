@@ -455,11 +455,23 @@ bool Device::handle_irq(RegisterState const&)
 }
 
 void Device::supply_chain_and_notify(u16 queue_index, QueueChain& chain)
+{
+    supply_chain(queue_index, chain);
+    notify_queue_if_needed(queue_index);
+}
+
+void Device::supply_chain(u16 queue_index, QueueChain& chain)
 {
     auto& queue = get_queue(queue_index);
     VERIFY(&chain.queue() == &queue);
     VERIFY(queue.lock().is_locked());
     chain.submit_to_queue();
+}
+
+void Device::notify_queue_if_needed(u16 queue_index)
+{
+    auto& queue = get_queue(queue_index);
+    VERIFY(queue.lock().is_locked());
     if (queue.should_notify())
         notify_queue(queue_index);
 }
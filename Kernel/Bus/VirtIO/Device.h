@@ -109,6 +109,9 @@ protected:
     }
 
     void supply_chain_and_notify(u16 queue_index, QueueChain& chain);
+    // For handing several chains to the device at once: supply them one by one, then notify the device once.
+    void supply_chain(u16 queue_index, QueueChain& chain);
+    void notify_queue_if_needed(u16 queue_index);
 
     virtual bool handle_device_config_change() = 0;
     virtual void handle_queue_update(u16 queue_index) = 0;
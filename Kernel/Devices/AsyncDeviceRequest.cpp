@@ -41,6 +41,9 @@ AsyncDeviceRequest::~AsyncDeviceRequest()
 
 void AsyncDeviceRequest::request_finished()
 {
+    // NOTE: The device may drop the last reference to us while processing the next request.
+    NonnullLockRefPtr<AsyncDeviceRequest> protector(*this);
+
     if (m_parent_request)
         m_parent_request->sub_request_finished(*this);
 
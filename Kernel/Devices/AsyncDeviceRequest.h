@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Badge.h>
 #include <AK/IntrusiveList.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
 #include <Kernel/Library/UserOrKernelBuffer.h>
@@ -17,6 +18,7 @@
 namespace Kernel {
 
 class Device;
+class StorageRequestQueue;
 
 extern WorkQueue* g_io_work;
 
@@ -74,6 +76,16 @@ public:
 
     void complete(RequestResult result);
 
+    // NOTE: A request that is carried out as part of a larger, merged request is never start()ed itself.
+    void mark_started_as_part_of_merged_request(Badge<StorageRequestQueue>)
+    {
+        SpinlockLocker lock(m_lock);
+        VERIFY(m_result == Pending);
+        m_result = Started;
+    }
+
+    RequestResult get_request_result() const;
+
     void set_private(void* priv)
     {
         VERIFY(!m_private || !priv);
@@ -120,8 +132,6 @@ public:
 protected:
     AsyncDeviceRequest(Device&);
 
-    RequestResult get_request_result() const;
-
 private:
     void sub_request_finished(AsyncDeviceRequest&);
     void request_finished();
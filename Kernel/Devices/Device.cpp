@@ -69,6 +69,16 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> Device::open(int options)
     return File::open(options);
 }
 
+ErrorOr<void> Device::queue_request(AsyncDeviceRequest& request)
+{
+    SpinlockLocker lock(m_requests_lock);
+    bool was_empty = m_requests.is_empty();
+    TRY(m_requests.try_append(request));
+    if (was_empty)
+        request.do_start(move(lock));
+    return {};
+}
+
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
 {
     SpinlockLocker lock(m_requests_lock);
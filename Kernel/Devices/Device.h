@@ -52,22 +52,21 @@ public:
     virtual void will_be_destroyed() override;
     virtual ErrorOr<void> after_inserting();
     virtual bool is_openable_by_jailed_processes() const { return false; }
-    void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&);
+    virtual void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&);
 
     template<typename AsyncRequestType, typename... Args>
     ErrorOr<NonnullLockRefPtr<AsyncRequestType>> try_make_request(Args&&... args)
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
-        SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
-        TRY(m_requests.try_append(request));
-        if (was_empty)
-            request->do_start(move(lock));
+        TRY(queue_request(*request));
         return request;
     }
 
 protected:
     Device(MajorNumber major, MinorNumber minor);
+
+    // By default, requests are started one after another in the order they were made.
+    virtual ErrorOr<void> queue_request(AsyncDeviceRequest&);
     void set_uid(UserID uid) { m_uid = uid; }
     void set_gid(GroupID gid) { m_gid = gid; }
 
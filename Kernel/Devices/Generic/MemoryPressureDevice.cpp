@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Devices/Generic/MemoryPressureDevice.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/MemoryPressureTask.h>
+
+namespace Kernel {
+
+static MemoryPressureDevice* s_the;
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<MemoryPressureDevice> MemoryPressureDevice::must_create()
+{
+    auto memory_pressure_device_or_error = DeviceManagement::try_create_device<MemoryPressureDevice>();
+    // FIXME: Find a way to propagate errors
+    VERIFY(!memory_pressure_device_or_error.is_error());
+    auto device = memory_pressure_device_or_error.release_value();
+    s_the = device.ptr();
+    return device;
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::MemoryPressureDevice()
+    : CharacterDevice(32, 0)
+{
+}
+
+UNMAP_AFTER_INIT MemoryPressureDevice::~MemoryPressureDevice() = default;
+
+void MemoryPressureDevice::notify_level_changed()
+{
+    if (s_the)
+        s_the->evaluate_block_conditions();
+}
+
+void MemoryPressureDevice::detach(OpenFileDescription& description)
+{
+    m_last_read_sequences.with([&](auto& sequences) {
+        sequences.remove(&description);
+    });
+    CharacterDevice::detach(description);
+}
+
+bool MemoryPressureDevice::can_read(OpenFileDescription const& description, u64) const
+{
+    auto sequence = MemoryPressureTask::sequence();
+    return m_last_read_sequences.with([&](auto& sequences) {
+        auto last_read_sequence = sequences.get(&description);
+        return !last_read_sequence.has_value() || last_read_sequence.value() != sequence;
+    });
+}
+
+ErrorOr<size_t> MemoryPressureDevice::read(OpenFileDescription& description, u64, UserOrKernelBuffer& buffer, size_t size)
+{
+    if (size < sizeof(MemoryPressureEvent))
+        return EINVAL;
+
+    auto event = MemoryPressureTask::current_event();
+    TRY(m_last_read_sequences.with([&](auto& sequences) {
+        return sequences.try_set(&description, event.sequence);
+    }));
+    TRY(buffer.write(&event, sizeof(event)));
+    return sizeof(event);
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <Kernel/Devices/CharacterDevice.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// /dev/memory_pressure reports the memory pressure level. Every read returns a MemoryPressureEvent,
+// and a file description only becomes readable again once the level has changed since its last read.
+class MemoryPressureDevice final : public CharacterDevice {
+    friend class DeviceManagement;
+
+public:
+    static NonnullLockRefPtr<MemoryPressureDevice> must_create();
+    virtual ~MemoryPressureDevice() override;
+
+    static void notify_level_changed();
+
+private:
+    MemoryPressureDevice();
+
+    // ^File
+    virtual void detach(OpenFileDescription&) override;
+
+    // ^CharacterDevice
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual StringView class_name() const override { return "MemoryPressureDevice"sv; }
+
+    // The sequence number of the last event each file description has read.
+    SpinlockProtected<HashMap<OpenFileDescription const*, u32>, LockRank::None> m_last_read_sequences {};
+};
+
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/Ioctl.h>
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Devices/Generic/TraceDevice.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/Tracepoints.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<TraceDevice> TraceDevice::must_create()
+{
+    auto trace_device_or_error = DeviceManagement::try_create_device<TraceDevice>();
+    // FIXME: Find a way to propagate errors
+    VERIFY(!trace_device_or_error.is_error());
+    return trace_device_or_error.release_value();
+}
+
+UNMAP_AFTER_INIT TraceDevice::TraceDevice()
+    : CharacterDevice(31, 0)
+{
+}
+
+UNMAP_AFTER_INIT TraceDevice::~TraceDevice() = default;
+
+ErrorOr<NonnullRefPtr<OpenFileDescription>> TraceDevice::open(int options)
+{
+    // NOTE: Tracepoints see what every process on the system is doing.
+    if (!Process::current().credentials()->is_superuser())
+        return EPERM;
+
+    {
+        MutexLocker locker(m_lock);
+        TRY(Tracepoints::allocate_buffers());
+    }
+    return Device::open(options);
+}
+
+void TraceDevice::detach(OpenFileDescription& description)
+{
+    {
+        MutexLocker locker(m_lock);
+        if (m_owner == &description) {
+            Tracepoints::disable();
+            m_owner = nullptr;
+        }
+    }
+    CharacterDevice::detach(description);
+}
+
+ErrorOr<void> TraceDevice::ioctl(OpenFileDescription& description, unsigned request, Userspace<void*> arg)
+{
+    MutexLocker locker(m_lock);
+    switch (request) {
+    case TRACE_IOCTL_GET_INFO: {
+        TraceInfo info {};
+        info.processor_count = Processor::count();
+        info.buffer_size = TRACE_BUFFER_SIZE;
+        return copy_to_user(static_ptr_cast<TraceInfo*>(arg), &info);
+    }
+    case TRACE_IOCTL_ENABLE: {
+        auto mask = static_cast<u32>(arg.ptr());
+        if (mask == 0 || (mask & ~all_tracepoints_mask) != 0)
+            return EINVAL;
+        if (m_owner && m_owner != &description)
+            return EBUSY;
+        m_owner = &description;
+        Tracepoints::enable(mask);
+        return {};
+    }
+    case TRACE_IOCTL_DISABLE:
+        if (m_owner != &description)
+            return EPERM;
+        Tracepoints::disable();
+        m_owner = nullptr;
+        return {};
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> TraceDevice::vmobject_for_mmap(Process&, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    if (!shared)
+        return EINVAL;
+    if (offset % TRACE_BUFFER_SIZE != 0 || range.size() > TRACE_BUFFER_SIZE)
+        return EINVAL;
+
+    auto* buffer = Tracepoints::buffer_for_processor(offset / TRACE_BUFFER_SIZE);
+    if (!buffer)
+        return ENXIO;
+
+    // The offset only selects the processor, each buffer is a VMObject of its own.
+    offset = 0;
+    return buffer->vmobject();
+}
+
+}
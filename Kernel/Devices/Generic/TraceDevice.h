@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/Devices/CharacterDevice.h>
+#include <Kernel/Locking/Mutex.h>
+
+namespace Kernel {
+
+// /dev/trace gives the superuser access to the kernel tracepoints. The trace buffers are mapped with mmap(),
+// and the tracepoints stay enabled until they are disabled again, or the description that enabled them goes away.
+class TraceDevice final : public CharacterDevice {
+    friend class DeviceManagement;
+
+public:
+    static NonnullLockRefPtr<TraceDevice> must_create();
+    virtual ~TraceDevice() override;
+
+    // ^File
+    virtual ErrorOr<NonnullRefPtr<OpenFileDescription>> open(int options) override;
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+private:
+    TraceDevice();
+
+    // ^File
+    virtual void detach(OpenFileDescription&) override;
+
+    // ^CharacterDevice
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual bool can_read(OpenFileDescription const&, u64) const override { return true; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
+    virtual StringView class_name() const override { return "TraceDevice"sv; }
+
+    Mutex m_lock { "TraceDevice"sv };
+    // The description that enabled the tracepoints. Only one reader can trace at a time.
+    OpenFileDescription const* m_owner { nullptr };
+};
+
+}
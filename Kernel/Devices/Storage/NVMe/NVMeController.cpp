@@ -163,6 +163,26 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
         prp_dma_region = move(buffer);
     }
 
+    // The controller may limit the size of a single transfer further than our DMA buffers do.
+    size_t max_transfer_size = IO_MAX_TRANSFER_PAGES * PAGE_SIZE;
+    {
+        NVMeSubmission sub {};
+        u16 status = 0;
+        sub.op = OP_ADMIN_IDENTIFY;
+        sub.identify.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(prp_dma_buffer->paddr().as_ptr()));
+        sub.identify.cns = NVMe_CNS_ID_CTRL & 0xff;
+        status = submit_admin_command(sub, true);
+        if (status) {
+            dmesgln_pci(*this, "Failed to identify controller");
+            return EFAULT;
+        }
+        // MDTS is a power of two in units of the minimum memory page size, and 0 means that there is no limit.
+        u8 mdts = prp_dma_region->vaddr().as_ptr()[MDTS_INDEX];
+        if (mdts != 0)
+            max_transfer_size = min<u64>(max_transfer_size, CAP_MPSMIN_SIZE(m_controller_regs->cap) << mdts);
+        dbgln_if(NVME_DEBUG, "NVMe: Maximum transfer size is {} bytes", max_transfer_size);
+    }
+
     // Get the active namespace
     {
         NVMeSubmission sub {};
@@ -208,7 +228,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 
             dbgln_if(NVME_DEBUG, "NVMe: Block count is {} and Block size is {}", block_counts, block_size);
 
-            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size)));
+            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size, max_transfer_size / block_size)));
             m_device_count++;
             dbgln_if(NVME_DEBUG, "NVMe: Initialized namespace with NSID: {}", nsid);
         }
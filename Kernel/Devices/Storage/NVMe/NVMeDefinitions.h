@@ -53,6 +53,14 @@ static constexpr u32 CAP_TO(u64 cap)
     return (cap & CAP_TO_MASK) >> CAP_TO_SHIFT;
 }
 
+static constexpr u8 CAP_MPSMIN_SHIFT = 48;
+static constexpr u64 CAP_MPSMIN_MASK = 0xfull << CAP_MPSMIN_SHIFT;
+// Size of the smallest memory page the controller supports, in bytes.
+static constexpr u64 CAP_MPSMIN_SIZE(u64 cap)
+{
+    return 1ull << (12 + ((cap & CAP_MPSMIN_MASK) >> CAP_MPSMIN_SHIFT));
+}
+
 // CC – Controller Configuration
 static constexpr u8 CC_EN_BIT = 0x0;
 static constexpr u8 CSTS_RDY_BIT = 0x0;
@@ -96,11 +104,15 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
 }
 
 static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
+// Each IO queue has a DMA buffer of this many pages, which limits the size of a single transfer.
+static constexpr size_t IO_MAX_TRANSFER_PAGES = 16;
 
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
 static constexpr u8 NVMe_CNS_ID_ACTIVE_NS = 0x2;
 static constexpr u8 NVMe_CNS_ID_NS = 0x0;
+static constexpr u8 NVMe_CNS_ID_CTRL = 0x1;
+static constexpr u8 MDTS_INDEX = 77;
 static constexpr u8 FLBA_SIZE_INDEX = 26;
 static constexpr u8 FLBA_SIZE_MASK = 0xf;
 static constexpr u8 LBA_FORMAT_SUPPORT_INDEX = 128;
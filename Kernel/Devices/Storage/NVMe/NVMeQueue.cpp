@@ -14,23 +14,26 @@
 namespace Kernel {
 ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Memory::TypedMapping<DoorbellRegister volatile> db_regs, QueueType queue_type)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
+    // Note: Allocate DMA region for RW operation. Transfers are limited to IO_MAX_TRANSFER_PAGES (Storage device takes care of it).
+    //       The extra page at the end holds the PRP list that describes the data pages after the first one.
+    Vector<NonnullRefPtr<Memory::PhysicalPage>> rw_dma_pages;
+    auto rw_dma_region = TRY(MM.allocate_dma_buffer_pages((IO_MAX_TRANSFER_PAGES + 1) * PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_pages));
+    VERIFY(rw_dma_pages.size() == IO_MAX_TRANSFER_PAGES + 1);
 
-    if (rw_dma_page.is_null())
-        return ENOMEM;
+    auto* prp_list = reinterpret_cast<u64*>(rw_dma_region->vaddr().offset(IO_MAX_TRANSFER_PAGES * PAGE_SIZE).as_ptr());
+    for (size_t i = 1; i < IO_MAX_TRANSFER_PAGES; ++i)
+        prp_list[i - 1] = AK::convert_between_host_and_little_endian(rw_dma_pages[i]->paddr().get());
 
     if (queue_type == QueueType::Polled) {
-        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+        auto queue = NVMePollQueue::try_create(move(rw_dma_region), move(rw_dma_pages), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
         return queue;
     }
 
-    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_page.release_nonnull(), qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), move(rw_dma_pages), qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Memory::TypedMapping<DoorbellRegister volatile> db_regs)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Vector<NonnullRefPtr<Memory::PhysicalPage>> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Memory::TypedMapping<DoorbellRegister volatile> db_regs)
     : m_rw_dma_region(move(rw_dma_region))
     , m_qid(qid)
     , m_admin_queue(qid == 0)
@@ -38,7 +41,7 @@ UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_regio
     , m_cq_dma_region(move(cq_dma_region))
     , m_sq_dma_region(move(sq_dma_region))
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
+    , m_rw_dma_pages(move(rw_dma_pages))
 
 {
     m_requests.try_ensure_capacity(q_depth).release_value_but_fixme_should_propagate_errors();
@@ -127,6 +130,20 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     return cmd_status;
 }
 
+void NVMeQueue::set_data_pointer(DataPtr& data_ptr, size_t size) const
+{
+    VERIFY(size <= IO_MAX_TRANSFER_PAGES * PAGE_SIZE);
+    auto page_count = ceil_div(size, static_cast<size_t>(PAGE_SIZE));
+
+    // PRP1 points at the first page of the transfer. If there is a second page, PRP2 points at it,
+    // and for anything larger PRP2 points at the list of all the pages after the first one.
+    data_ptr.prp1 = m_rw_dma_pages[0]->paddr().get();
+    if (page_count == 2)
+        data_ptr.prp2 = m_rw_dma_pages[1]->paddr().get();
+    else if (page_count > 2)
+        data_ptr.prp2 = m_rw_dma_pages[IO_MAX_TRANSFER_PAGES]->paddr().get();
+}
+
 void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
 {
     NVMeSubmission sub {};
@@ -135,7 +152,7 @@ void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
+    set_data_pointer(sub.rw.data_ptr, request.buffer_size());
     sub.cmdid = get_request_cid();
 
     {
@@ -158,7 +175,7 @@ void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
+    set_data_pointer(sub.rw.data_ptr, request.buffer_size());
     sub.cmdid = get_request_cid();
 
     {
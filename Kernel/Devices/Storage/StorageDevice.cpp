@@ -24,6 +24,7 @@ StorageDevice::StorageDevice(LUNAddress logical_unit_number_address, u32 hardwar
     , m_hardware_relative_controller_id(hardware_relative_controller_id)
     , m_max_addressable_block(max_addressable_block)
     , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_request_queue(*this)
 {
 }
 
@@ -33,11 +34,13 @@ StorageDevice::StorageDevice(Badge<RamdiskDevice>, LUNAddress logical_unit_numbe
     , m_hardware_relative_controller_id(hardware_relative_controller_id)
     , m_max_addressable_block(max_addressable_block)
     , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_request_queue(*this)
 {
 }
 
 ErrorOr<void> StorageDevice::after_inserting()
 {
+    TRY(m_request_queue.initialize());
     auto sysfs_storage_device_directory = StorageDeviceSysFSDirectory::create(SysFSStorageDirectory::the(), *this);
     m_sysfs_device_directory = sysfs_storage_device_directory;
     SysFSStorageDirectory::the().plug({}, *sysfs_storage_device_directory);
@@ -61,6 +64,17 @@ void StorageDevice::will_be_destroyed()
     before_will_be_destroyed_remove_from_device_management();
 }
 
+ErrorOr<void> StorageDevice::queue_request(AsyncDeviceRequest& request)
+{
+    return m_request_queue.queue_request(static_cast<AsyncBlockDeviceRequest&>(request));
+}
+
+void StorageDevice::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
+{
+    m_request_queue.request_finished(completed_request);
+    evaluate_block_conditions();
+}
+
 StringView StorageDevice::class_name() const
 {
     return "StorageDevice"sv;
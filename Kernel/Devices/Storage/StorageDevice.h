@@ -10,6 +10,7 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/Storage/DiskPartition.h>
 #include <Kernel/Devices/Storage/StorageController.h>
+#include <Kernel/Devices/Storage/StorageRequestQueue.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Locking/Mutex.h>
 
@@ -55,6 +56,8 @@ public:
 
 public:
     virtual u64 max_addressable_block() const { return m_max_addressable_block; }
+    // NOTE: Most controller drivers can't transfer more than a single page in one command.
+    virtual size_t max_blocks_per_transfer() const { return PAGE_SIZE / block_size(); }
 
     // ^BlockDevice
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
@@ -75,6 +78,11 @@ public:
 
     StringView command_set_to_string_view() const;
 
+    StorageRequestQueue::Statistics request_queue_statistics() const { return m_request_queue.statistics(); }
+
+    // ^Device
+    virtual void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&) override;
+
     // ^File
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) final;
 
@@ -88,6 +96,9 @@ protected:
     // ^DiskDevice
     virtual StringView class_name() const override;
 
+    // ^Device
+    virtual ErrorOr<void> queue_request(AsyncDeviceRequest&) override;
+
 private:
     virtual ErrorOr<void> after_inserting() override;
     virtual void will_be_destroyed() override;
@@ -106,6 +117,8 @@ private:
 
     u64 m_max_addressable_block { 0 };
     size_t m_blocks_per_page { 0 };
+
+    StorageRequestQueue m_request_queue;
 };
 
 }
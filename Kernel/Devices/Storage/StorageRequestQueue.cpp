@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <Kernel/Devices/Storage/StorageDevice.h>
+#include <Kernel/Devices/Storage/StorageRequestQueue.h>
+#include <Kernel/Tasks/Thread.h>
+#include <Kernel/Tasks/Tracepoints.h>
+#include <Kernel/Tasks/WorkQueue.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// These match the defaults of the classic deadline I/O scheduler.
+static constexpr Duration read_expire = Duration::from_milliseconds(500);
+static constexpr Duration write_expire = Duration::from_seconds(5);
+// How many read transfers may be dispatched in a row while writes are waiting.
+static constexpr size_t writes_starved = 2;
+
+// Submissions from different threads that arrive within this window are considered a burst.
+static constexpr Duration plug_burst_window = Duration::from_microseconds(500);
+static constexpr Duration plug_delay = Duration::from_milliseconds(1);
+// Once this many requests are pending, there is plenty to merge, so stop waiting for more.
+static constexpr size_t unplug_threshold = 16;
+
+static MonotonicTime current_time()
+{
+    return TimeManagement::the().monotonic_time(TimePrecision::Precise);
+}
+
+static void trace_request(TracepointID id, StorageDevice const& device, AsyncBlockDeviceRequest const& request, u64 result = 0)
+{
+    if (!Tracepoints::is_enabled(id))
+        return;
+    u64 device_id = (static_cast<u64>(device.major().value()) << 32) | device.minor().value();
+    Tracepoints::hit(id, device_id, request.block_index(), request.block_count(), request.request_type() == AsyncBlockDeviceRequest::RequestType::Write, result);
+}
+
+StorageRequestQueue::StorageRequestQueue(StorageDevice& device)
+    : m_device(device)
+{
+}
+
+StorageRequestQueue::~StorageRequestQueue() = default;
+
+ErrorOr<void> StorageRequestQueue::initialize()
+{
+    m_max_blocks_per_transfer = m_device.max_blocks_per_transfer();
+    VERIFY(m_max_blocks_per_transfer > 0);
+
+    // NOTE: Without these we still work, but won't merge or plug.
+    if (m_max_blocks_per_transfer > 1)
+        m_merge_buffer = TRY(KBuffer::try_create_with_size("StorageRequestQueue: Merge buffer"sv, m_max_blocks_per_transfer * m_device.block_size()));
+    m_plug_timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer));
+    return {};
+}
+
+ErrorOr<void> StorageRequestQueue::queue_request(AsyncBlockDeviceRequest& request)
+{
+    auto now = current_time();
+    auto expire = request.request_type() == RequestType::Read ? read_expire : write_expire;
+
+    Locker locker(m_lock);
+    TRY(pending_requests(request.request_type()).try_append({ request, now, now + expire }));
+    statistics(request.request_type()).submitted++;
+    trace_request(TracepointID::BlockIOSubmit, m_device, request);
+    m_statistics.max_pending = max(m_statistics.max_pending, pending_count());
+
+    bool burst = is_burst(now);
+    if (m_in_flight)
+        return {};
+
+    if (m_plugged) {
+        if (pending_count() < unplug_threshold)
+            return {};
+        m_plugged = false;
+    } else if (burst && pending_count() < unplug_threshold && plug()) {
+        return {};
+    }
+
+    dispatch_next_request(move(locker));
+    return {};
+}
+
+bool StorageRequestQueue::is_burst(MonotonicTime now)
+{
+    VERIFY(m_lock.is_locked());
+    // NOTE: A thread that submits requests one after another waits for each of them, so there is
+    //       nothing to gain from holding its requests back. Only concurrent submitters are worth plugging for.
+    auto submitter = Thread::current()->tid();
+    bool burst = m_last_submission.has_value()
+        && submitter != m_last_submitter
+        && now - m_last_submission.value() < plug_burst_window;
+    m_last_submission = now;
+    m_last_submitter = submitter;
+    return burst;
+}
+
+bool StorageRequestQueue::plug()
+{
+    VERIFY(m_lock.is_locked());
+    if (!m_plug_timer)
+        return false;
+
+    // NOTE: If the timer of an earlier plug is still pending, it will unplug us a little early, which is fine.
+    if (!m_plug_timer_armed) {
+        auto deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC) + plug_delay;
+        m_plug_timer_armed = TimerQueue::the().add_timer_without_id(*m_plug_timer, CLOCK_MONOTONIC, deadline, [this, protector = NonnullRefPtr<StorageDevice>(m_device)] {
+            // NOTE: Timers fire with interrupts disabled, but starting a request may block, so leave that to the IO work queue.
+            auto result = g_io_work->try_queue([this, protector] {
+                unplug();
+            });
+            if (result.is_error()) {
+                // The next request that is queued or finished will get things going again.
+                Locker locker(m_lock);
+                m_plug_timer_armed = false;
+                m_plugged = false;
+            }
+        });
+        if (!m_plug_timer_armed)
+            return false;
+    }
+
+    m_plugged = true;
+    m_statistics.plugs++;
+    return true;
+}
+
+void StorageRequestQueue::unplug()
+{
+    Locker locker(m_lock);
+    m_plug_timer_armed = false;
+    if (!m_plugged)
+        return;
+    m_plugged = false;
+    dispatch_next_request(move(locker));
+}
+
+auto StorageRequestQueue::choose_direction(MonotonicTime now) -> RequestType
+{
+    if (m_pending_writes.is_empty())
+        return RequestType::Read;
+    if (m_pending_reads.is_empty())
+        return RequestType::Write;
+
+    // Reads are preferred, since someone is usually waiting for them, while writes are mostly
+    // flushed in the background. Still, don't let the writes wait forever.
+    if (m_pending_writes.first().deadline <= now || m_reads_dispatched_while_writes_pending >= writes_starved)
+        return RequestType::Write;
+    return RequestType::Read;
+}
+
+size_t StorageRequestQueue::choose_request(RequestType type, MonotonicTime now)
+{
+    auto& pending = pending_requests(type);
+    VERIFY(!pending.is_empty());
+
+    // NOTE: Pending requests are kept in submission order, so the first one is the oldest.
+    if (pending.first().deadline <= now) {
+        statistics(type).deadline_expired++;
+        return 0;
+    }
+
+    // Otherwise, keep sweeping across the disk in one direction, starting where the last transfer ended.
+    Optional<size_t> next_ahead;
+    size_t lowest = 0;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        auto block_index = pending[i].request->block_index();
+        if (block_index < pending[lowest].request->block_index())
+            lowest = i;
+        if (block_index >= m_next_block_index && (!next_ahead.has_value() || block_index < pending[next_ahead.value()].request->block_index()))
+            next_ahead = i;
+    }
+    return next_ahead.value_or(lowest);
+}
+
+bool StorageRequestQueue::can_merge(AsyncBlockDeviceRequest const& request, size_t merged_block_count) const
+{
+    // NOTE: We only merge requests into kernel buffers, so that copying from and to the merge buffer can't fault.
+    return request.buffer().is_kernel_buffer()
+        && merged_block_count + request.block_count() <= m_max_blocks_per_transfer;
+}
+
+void StorageRequestQueue::dispatch_next_request(Locker&& locker)
+{
+    VERIFY(m_lock.is_locked());
+    if (m_in_flight || m_plugged || pending_count() == 0)
+        return;
+
+    auto now = current_time();
+    auto type = choose_direction(now);
+    auto& pending = pending_requests(type);
+    auto chosen_index = choose_request(type, now);
+
+    // Collect the pending requests that border the chosen one on either side, in block order.
+    Vector<size_t, 16> batch_indices;
+    batch_indices.unchecked_append(chosen_index);
+    auto& chosen_request = *pending[chosen_index].request;
+    u64 first_block = chosen_request.block_index();
+    u64 end_block = first_block + chosen_request.block_count();
+    size_t block_count = chosen_request.block_count();
+    if (m_merge_buffer && can_merge(chosen_request, 0)) {
+        for (bool extended = true; extended;) {
+            extended = false;
+            for (size_t i = 0; i < pending.size(); ++i) {
+                auto& candidate = *pending[i].request;
+                if (!can_merge(candidate, block_count))
+                    continue;
+                if (candidate.block_index() == end_block) {
+                    if (batch_indices.try_append(i).is_error())
+                        break;
+                    end_block += candidate.block_count();
+                } else if (candidate.block_index() + candidate.block_count() == first_block) {
+                    if (batch_indices.try_insert(0, i).is_error())
+                        break;
+                    first_block = candidate.block_index();
+                } else {
+                    continue;
+                }
+                block_count += candidate.block_count();
+                extended = true;
+            }
+        }
+    }
+
+    LockRefPtr<AsyncBlockDeviceRequest> merged_request;
+    if (batch_indices.size() > 1) {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(m_merge_buffer->data());
+        merged_request = adopt_lock_ref_if_nonnull(new (nothrow) AsyncBlockDeviceRequest(m_device, type, first_block, block_count, buffer, block_count * m_device.block_size()));
+        // If we can't allocate the merged request, just go with the one we chose.
+        if (!merged_request) {
+            batch_indices.clear();
+            batch_indices.unchecked_append(chosen_index);
+        }
+    }
+
+    VERIFY(m_in_flight_batch.is_empty());
+    if (m_in_flight_batch.try_ensure_capacity(batch_indices.size()).is_error()) {
+        merged_request = nullptr;
+        batch_indices.clear();
+        batch_indices.unchecked_append(chosen_index);
+    }
+    for (auto index : batch_indices)
+        m_in_flight_batch.unchecked_append(pending[index]);
+    quick_sort(batch_indices, [](auto a, auto b) { return a > b; });
+    for (auto index : batch_indices)
+        pending.remove(index);
+
+    auto& stats = statistics(type);
+    stats.dispatched++;
+    stats.merged += m_in_flight_batch.size() - 1;
+    auto& last_request = *m_in_flight_batch.last().request;
+    m_next_block_index = last_request.block_index() + last_request.block_count();
+    if (type == RequestType::Write)
+        m_reads_dispatched_while_writes_pending = 0;
+    else if (!m_pending_writes.is_empty())
+        m_reads_dispatched_while_writes_pending++;
+
+    if (!merged_request) {
+        m_in_flight = m_in_flight_batch.first().request;
+        NonnullLockRefPtr protected_request = *m_in_flight;
+        protected_request->do_start(move(locker));
+        return;
+    }
+
+    size_t offset = 0;
+    for (auto& queued : m_in_flight_batch) {
+        auto& request = *queued.request;
+        request.mark_started_as_part_of_merged_request({});
+        auto size = request.block_count() * m_device.block_size();
+        if (type == RequestType::Write)
+            MUST(request.buffer().read(m_merge_buffer->data() + offset, size));
+        offset += size;
+    }
+
+    m_in_flight = merged_request;
+    merged_request->do_start(move(locker));
+}
+
+void StorageRequestQueue::request_finished(AsyncDeviceRequest const& completed_request)
+{
+    Locker locker(m_lock);
+    // NOTE: This also gets called for the requests that we complete on behalf of a merged request below.
+    if (m_in_flight.ptr() != &completed_request)
+        return;
+
+    auto result = completed_request.get_request_result();
+    bool was_merged = m_in_flight.ptr() != m_in_flight_batch.first().request.ptr();
+    auto batch = move(m_in_flight_batch);
+    locker.unlock();
+
+    // NOTE: Until we clear m_in_flight, nothing else will be dispatched, so the merge buffer is still ours.
+    if (was_merged) {
+        size_t offset = 0;
+        for (auto& queued : batch) {
+            auto& request = *queued.request;
+            auto size = request.block_count() * m_device.block_size();
+            auto request_result = result;
+            if (result == AsyncDeviceRequest::Success && request.request_type() == RequestType::Read) {
+                if (request.write_to_buffer(request.buffer(), m_merge_buffer->data() + offset, size).is_error())
+                    request_result = AsyncDeviceRequest::MemoryFault;
+            }
+            offset += size;
+            request.complete(request_result);
+        }
+    }
+
+    auto now = current_time();
+    locker.lock();
+    for (auto& queued : batch)
+        account_completion(queued, now);
+    m_in_flight = nullptr;
+    dispatch_next_request(move(locker));
+}
+
+void StorageRequestQueue::account_completion(QueuedRequest const& queued, MonotonicTime now)
+{
+    auto& stats = statistics(queued.request->request_type());
+    auto latency_ns = static_cast<u64>((now - queued.submitted).to_nanoseconds());
+    trace_request(TracepointID::BlockIOComplete, m_device, *queued.request, queued.request->get_request_result());
+    stats.completed++;
+    stats.total_latency_ns += latency_ns;
+    stats.max_latency_ns = max(stats.max_latency_ns, latency_ns);
+}
+
+auto StorageRequestQueue::statistics() const -> Statistics
+{
+    Locker locker(m_lock);
+    auto statistics = m_statistics;
+    statistics.pending = pending_count();
+    return statistics;
+}
+
+}
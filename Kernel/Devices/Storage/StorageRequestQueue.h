@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Time/TimerQueue.h>
+
+namespace Kernel {
+
+class StorageDevice;
+
+// The StorageRequestQueue sits between the users of a StorageDevice and its controller driver.
+// It keeps pending reads and writes apart, and whenever the device becomes idle it picks the next
+// request with a deadline policy that prefers reads, but doesn't let writes starve.
+// Requests that are contiguous on disk are merged into a single transfer, up to the size that the
+// controller driver can handle, and a burst of submissions from different threads briefly plugs
+// the queue so that there is something to merge.
+class StorageRequestQueue {
+    AK_MAKE_NONCOPYABLE(StorageRequestQueue);
+    AK_MAKE_NONMOVABLE(StorageRequestQueue);
+
+public:
+    struct DirectionStatistics {
+        u64 submitted { 0 };
+        u64 merged { 0 };
+        u64 dispatched { 0 };
+        u64 completed { 0 };
+        u64 deadline_expired { 0 };
+        u64 total_latency_ns { 0 };
+        u64 max_latency_ns { 0 };
+    };
+
+    struct Statistics {
+        DirectionStatistics reads;
+        DirectionStatistics writes;
+        u64 plugs { 0 };
+        size_t pending { 0 };
+        size_t max_pending { 0 };
+    };
+
+    explicit StorageRequestQueue(StorageDevice&);
+    ~StorageRequestQueue();
+
+    ErrorOr<void> initialize();
+
+    ErrorOr<void> queue_request(AsyncBlockDeviceRequest&);
+    void request_finished(AsyncDeviceRequest const&);
+
+    Statistics statistics() const;
+
+private:
+    using RequestType = AsyncBlockDeviceRequest::RequestType;
+    using Locker = SpinlockLocker<Spinlock<LockRank::None>>;
+
+    struct QueuedRequest {
+        NonnullLockRefPtr<AsyncBlockDeviceRequest> request;
+        MonotonicTime submitted;
+        MonotonicTime deadline;
+    };
+
+    Vector<QueuedRequest>& pending_requests(RequestType type) { return type == RequestType::Read ? m_pending_reads : m_pending_writes; }
+    DirectionStatistics& statistics(RequestType type) { return type == RequestType::Read ? m_statistics.reads : m_statistics.writes; }
+    size_t pending_count() const { return m_pending_reads.size() + m_pending_writes.size(); }
+
+    bool is_burst(MonotonicTime now);
+    bool plug();
+    void unplug();
+
+    RequestType choose_direction(MonotonicTime now);
+    size_t choose_request(RequestType, MonotonicTime now);
+    bool can_merge(AsyncBlockDeviceRequest const&, size_t merged_block_count) const;
+    void dispatch_next_request(Locker&&);
+    void account_completion(QueuedRequest const&, MonotonicTime now);
+
+    StorageDevice& m_device;
+    size_t m_max_blocks_per_transfer { 0 };
+
+    mutable Spinlock<LockRank::None> m_lock {};
+    Vector<QueuedRequest> m_pending_reads;
+    Vector<QueuedRequest> m_pending_writes;
+
+    // The request the controller is working on right now. When several requests were merged,
+    // this is a separate request for the whole transfer that uses m_merge_buffer, and the
+    // requests it covers are kept in m_in_flight_batch.
+    LockRefPtr<AsyncBlockDeviceRequest> m_in_flight;
+    Vector<QueuedRequest, 16> m_in_flight_batch;
+    OwnPtr<KBuffer> m_merge_buffer;
+
+    u64 m_next_block_index { 0 };
+    size_t m_reads_dispatched_while_writes_pending { 0 };
+
+    RefPtr<Timer> m_plug_timer;
+    bool m_plugged { false };
+    bool m_plug_timer_armed { false };
+    Optional<MonotonicTime> m_last_submission;
+    ThreadID m_last_submitter { 0 };
+
+    Statistics m_statistics;
+};
+
+}
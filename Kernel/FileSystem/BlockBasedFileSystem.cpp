@@ -5,9 +5,13 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
+#include <AK/ScopeGuard.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
@@ -16,76 +20,92 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_dirty { false };
 };
 
-class DiskCache {
+// A shard owns a fixed subset of the cache entries and caches the blocks that hash to it.
+// Clean entries are kept in LRU order (most recently used first), dirty entries are kept on
+// a separate list so flushing only ever has to look at the blocks that actually need writing.
+class DiskCacheShard {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+    DiskCacheShard() = default;
+    ~DiskCacheShard() = default;
+
+    void add_entry(CacheEntry& entry)
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        m_clean_list.append(entry);
     }
 
-    ~DiskCache() = default;
-
     bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+    size_t dirty_count() const { return m_dirty_count; }
+    bool has_clean_entries() const { return !m_clean_list.is_empty(); }
 
-    void mark_all_clean()
+    void mark_clean(CacheEntry& entry)
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        VERIFY(entry.is_dirty);
+        entry.is_dirty = false;
+        m_clean_list.prepend(entry);
+        --m_dirty_count;
     }
 
     void mark_dirty(CacheEntry& entry)
     {
+        note_write();
+        if (entry.is_dirty)
+            return;
+        entry.is_dirty = true;
         m_dirty_list.prepend(entry);
+        ++m_dirty_count;
     }
 
-    void mark_clean(CacheEntry& entry)
-    {
-        m_clean_list.prepend(entry);
-    }
+    // Bumped whenever a block in this shard is written, so that data read from the device
+    // without holding the shard lock can tell whether it might have become stale in the meantime.
+    u64 write_generation() const { return m_write_generation; }
+    void note_write() { ++m_write_generation; }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index)
     {
         auto it = m_hash.find(block_index);
         if (it == m_hash.end())
             return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
+        auto& entry = *it->value;
         VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
+        if (!entry.is_dirty && (m_clean_list.first() != &entry)) {
             // Cache hit! Promote the entry to the front of the list.
             m_clean_list.prepend(entry);
         }
         return &entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    void evict(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        auto it = m_hash.find(block_index);
+        if (it == m_hash.end())
+            return;
+        auto& entry = *it->value;
+        if (entry.is_dirty)
+            return;
+        m_hash.remove(it);
+        entry.has_data = false;
+        // Make this the first entry to be reused.
+        m_clean_list.append(entry);
+    }
+
+    // NOTE: The caller has to make sure there is at least one clean entry to evict.
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index)
     {
         if (auto* entry = get(block_index))
             return entry;
 
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
-        }
-
         VERIFY(m_clean_list.last());
         auto& new_entry = *m_clean_list.last();
+        TRY(m_hash.try_ensure_capacity(m_hash.size() + 1));
         m_clean_list.prepend(new_entry);
 
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+        // NOTE: Entries that were never used have a block index of 0, so make sure we only remove our own mapping.
+        if (auto it = m_hash.find(new_entry.block_index); it != m_hash.end() && it->value == &new_entry)
+            m_hash.remove(it);
+        m_hash.set(block_index, &new_entry);
 
         new_entry.block_index = block_index;
         new_entry.has_data = false;
@@ -93,26 +113,118 @@ public:
         return &new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
-
+    // NOTE: The callback may mark the entry clean, which moves it off the dirty list.
     template<typename Callback>
     void for_each_dirty_entry(Callback callback)
     {
-        for (auto& entry : m_dirty_list)
+        for (auto it = m_dirty_list.begin(); it != m_dirty_list.end();) {
+            auto& entry = *it;
+            ++it;
             callback(entry);
+        }
     }
 
 private:
-    mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
+    IntrusiveList<&CacheEntry::list_node> m_dirty_list;
+    IntrusiveList<&CacheEntry::list_node> m_clean_list;
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    size_t m_dirty_count { 0 };
+    u64 m_write_generation { 0 };
+};
+
+// All block-based filesystems share a budget of 1/32 of physical memory for their caches.
+static SpinlockProtected<u64, LockRank::None> s_disk_cache_bytes_in_use { 0 };
+
+class DiskCache {
+public:
+    static constexpr size_t ShardCount = 16;
+
+    // Consecutive blocks are kept in the same shard in runs of this many blocks, so that
+    // sequential access and read-ahead mostly stay within one shard.
+    static constexpr size_t BlocksPerShardRun = 16;
+
+    // NOTE: Every filesystem gets at least this many entries, even if the shared budget is used up already.
+    static constexpr size_t MinimumEntryCount = 1024;
+    static constexpr size_t MaximumEntryCount = 262144;
+
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(u64 block_size)
+    {
+        auto entry_count = reserve_entries(block_size);
+        ArmedScopeGuard release_entries = [&] { release(entry_count * block_size); };
+
+        auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, entry_count * block_size));
+        auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, entry_count * sizeof(CacheEntry)));
+        auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(entry_count, block_size, move(cached_block_data), move(entries_data))));
+        release_entries.disarm();
+        return cache;
+    }
+
+    ~DiskCache()
+    {
+        release(m_entry_count * m_block_size);
+    }
+
+    size_t entry_count() const { return m_entry_count; }
+
+    MutexProtected<DiskCacheShard>& shard_for(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        auto run = block_index.value() / BlocksPerShardRun;
+        return m_shards[u64_hash(run) % ShardCount];
+    }
+
+    template<typename Callback>
+    void for_each_shard(Callback callback)
+    {
+        for (auto& shard : m_shards)
+            callback(shard);
+    }
+
+private:
+    DiskCache(size_t entry_count, u64 block_size, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
+        : m_entry_count(entry_count)
+        , m_block_size(block_size)
+        , m_cached_block_data(move(cached_block_data))
+        , m_entries(move(entries_buffer))
+    {
+        VERIFY(m_entry_count % ShardCount == 0);
+        for (size_t i = 0; i < m_entry_count; ++i) {
+            auto& entry = entries()[i];
+            entry.data = m_cached_block_data->data() + i * block_size;
+            m_shards[i % ShardCount].with_exclusive([&](auto& shard) { shard.add_entry(entry); });
+        }
+    }
+
+    static size_t reserve_entries(u64 block_size)
+    {
+        auto memory_info = MM.get_system_memory_info();
+        u64 budget = memory_info.physical_pages * PAGE_SIZE / 32;
+        return s_disk_cache_bytes_in_use.with([&](auto& bytes_in_use) {
+            u64 available = budget - min(budget, bytes_in_use);
+            auto entry_count = clamp(available / block_size, static_cast<u64>(MinimumEntryCount), static_cast<u64>(MaximumEntryCount));
+            entry_count = align_up_to(entry_count, static_cast<u64>(ShardCount));
+            bytes_in_use += entry_count * block_size;
+            return static_cast<size_t>(entry_count);
+        });
+    }
+
+    static void release(u64 bytes)
+    {
+        s_disk_cache_bytes_in_use.with([&](auto& bytes_in_use) {
+            VERIFY(bytes_in_use >= bytes);
+            bytes_in_use -= bytes;
+        });
+    }
+
+    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+
+    size_t m_entry_count { 0 };
+    u64 m_block_size { 0 };
     NonnullOwnPtr<KBuffer> m_cached_block_data;
 
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
+    // NOTE: m_entries must be declared before m_shards because their entries are allocated from it.
+    // We need to ensure that the destructors of the shard lists are called before m_entries is destroyed.
     NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    Array<MutexProtected<DiskCacheShard>, ShardCount> m_shards;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -136,16 +248,35 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(DiskCache::try_create(block_size()));
+    auto read_ahead_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Read-ahead buffer"sv, maximum_read_ahead_blocks * block_size()));
+    auto write_behind_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Write-behind buffer"sv, maximum_coalesced_write_blocks * block_size()));
+    dbgln_if(BBFS_DEBUG, "{}: Using a disk cache with {} entries", class_name(), disk_cache->entry_count());
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
     });
+    m_read_ahead_buffer.with_exclusive([&](auto& buffer) {
+        buffer = move(read_ahead_buffer);
+    });
+    m_write_behind_buffer.with_exclusive([&](auto& buffer) {
+        buffer = move(write_behind_buffer);
+    });
     return {};
 }
 
+ErrorOr<CacheEntry*> BlockBasedFileSystem::ensure_cache_entry(DiskCacheShard& shard, BlockIndex index) const
+{
+    if (!shard.has_clean_entries()) {
+        // Not a single clean entry in this shard! Flush its writes so we have something to evict.
+        const_cast<BlockBasedFileSystem*>(this)->flush_cache_shard(shard);
+        // If none of the writes succeeded, the device is in trouble and we can't make room without losing data.
+        if (!shard.has_clean_entries())
+            return EIO;
+    }
+    return shard.ensure(index);
+}
+
 ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBuffer const& data, size_t count, u64 offset, bool allow_cache)
 {
     VERIFY(m_logical_block_size);
@@ -159,25 +290,32 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * block_size() + offset;
             auto nwritten = TRY(file_description().write(base_offset, data, count));
             VERIFY(nwritten == count);
+            // Read-ahead that is already in flight might have picked up the old contents of this block.
+            cache->shard_for(index).with_exclusive([](auto& shard) { shard.note_write(); });
             return {};
         }
 
-        auto entry = TRY(cache->ensure(index));
-        if (count < block_size()) {
-            // Fill the cache first.
-            TRY(read_block(index, nullptr, block_size()));
-        }
-        memcpy(entry->data + offset, buffered_data.data(), count);
+        return cache->shard_for(index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
+            auto* entry = TRY(ensure_cache_entry(shard, index));
+            if (count < block_size() && !entry->has_data) {
+                // Fill the cache first.
+                TRY(read_cache_entry_from_disk(*entry));
+            }
+            memcpy(entry->data + offset, buffered_data.data(), count);
+
+            shard.mark_dirty(*entry);
+            entry->has_data = true;
 
-        cache->mark_dirty(*entry);
-        entry->has_data = true;
-        return {};
+            if (shard.dirty_count() >= write_behind_threshold)
+                schedule_write_behind();
+            return {};
+        });
     });
 }
 
@@ -227,13 +365,148 @@ ErrorOr<void> BlockBasedFileSystem::write_blocks(BlockIndex index, unsigned coun
     return {};
 }
 
+ErrorOr<void> BlockBasedFileSystem::read_cache_entry_from_disk(CacheEntry& entry) const
+{
+    auto base_offset = entry.block_index.value() * block_size();
+    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+    auto nread = TRY(file_description().read(entry_data_buffer, base_offset, block_size()));
+    VERIFY(nread == block_size());
+    entry.has_data = true;
+    return {};
+}
+
+bool BlockBasedFileSystem::is_block_cached(DiskCache& cache, BlockIndex index) const
+{
+    return cache.shard_for(index).with_exclusive([&](auto& shard) {
+        auto* entry = shard.get(index);
+        return entry && entry->has_data;
+    });
+}
+
+size_t BlockBasedFileSystem::read_ahead(DiskCache& cache, BlockIndex index, size_t count) const
+{
+    // NOTE: This must not be called with any shard lock held, as we take the locks of all the shards touched.
+    count = min(count, maximum_read_ahead_blocks);
+
+    // Only read the run of blocks that is not cached yet, so we never overwrite newer data in the cache.
+    // We remember the write generations of their shards, as the device read happens without holding
+    // any shard lock: If a block is written (and possibly flushed and evicted) while we are reading,
+    // what we read is stale and must not end up in the cache.
+    Array<u64, maximum_read_ahead_blocks> write_generations;
+    size_t blocks_to_read = 0;
+    while (blocks_to_read < count) {
+        BlockIndex block_index { index.value() + blocks_to_read };
+        auto write_generation = cache.shard_for(block_index).with_exclusive([&](auto& shard) -> Optional<u64> {
+            auto* entry = shard.get(block_index);
+            if (entry && entry->has_data)
+                return {};
+            return shard.write_generation();
+        });
+        if (!write_generation.has_value())
+            break;
+        write_generations[blocks_to_read++] = write_generation.value();
+    }
+    if (blocks_to_read == 0)
+        return 0;
+
+    m_read_ahead_buffer.with_exclusive([&](auto& read_ahead_buffer) {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(read_ahead_buffer->data());
+        auto nread_or_error = file_description().read(buffer, index.value() * block_size(), blocks_to_read * block_size());
+        if (nread_or_error.is_error())
+            return;
+        // A short read can happen at the end of the device, only keep the full blocks we got.
+        auto blocks_read = nread_or_error.value() / block_size();
+        dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_ahead {}, count={}", index, blocks_read);
+
+        for (size_t i = 0; i < blocks_read; ++i) {
+            BlockIndex block_index { index.value() + i };
+            cache.shard_for(block_index).with_exclusive([&](auto& shard) {
+                if (shard.write_generation() != write_generations[i])
+                    return;
+                auto entry_or_error = ensure_cache_entry(shard, block_index);
+                if (entry_or_error.is_error())
+                    return;
+                auto* entry = entry_or_error.value();
+                // Someone might have raced us and populated the block in the meantime.
+                if (entry->has_data)
+                    return;
+                memcpy(entry->data, read_ahead_buffer->data() + i * block_size(), block_size());
+                entry->has_data = true;
+            });
+        }
+    });
+    return blocks_to_read;
+}
+
+void BlockBasedFileSystem::prefetch_blocks(BlockIndex index, size_t count) const
+{
+    m_cache.with_shared([&](auto& cache) {
+        // NOTE: The cache goes away before the last unmount, and read-ahead work might still be queued at that point.
+        if (!cache)
+            return;
+        size_t i = 0;
+        while (i < count) {
+            BlockIndex block_index { index.value() + i };
+            if (is_block_cached(*cache, block_index)) {
+                ++i;
+                continue;
+            }
+            auto blocks_read = read_ahead(*cache, block_index, count - i);
+            // If the device read failed, there is no point in trying the rest of the range.
+            if (blocks_read == 0)
+                return;
+            i += blocks_read;
+        }
+    });
+}
+
+void BlockBasedFileSystem::schedule_prefetch_blocks(BlockIndex index, size_t count) const
+{
+    // Don't pile up read-ahead work if the device can't keep up with it anyway.
+    if (m_pending_read_ahead_requests.fetch_add(1) >= maximum_pending_read_ahead_requests) {
+        --m_pending_read_ahead_requests;
+        return;
+    }
+
+    NonnullRefPtr protected_this = const_cast<BlockBasedFileSystem&>(*this);
+    auto result = g_fs_work->try_queue([protected_this, index, count] {
+        protected_this->prefetch_blocks(index, count);
+        --protected_this->m_pending_read_ahead_requests;
+    });
+    if (result.is_error())
+        --m_pending_read_ahead_requests;
+}
+
+void BlockBasedFileSystem::evict_clean_block(BlockIndex index) const
+{
+    m_cache.with_shared([&](auto& cache) {
+        if (!cache)
+            return;
+        cache->shard_for(index).with_exclusive([&](auto& shard) { shard.evict(index); });
+    });
+}
+
+void BlockBasedFileSystem::schedule_write_behind()
+{
+    if (m_write_behind_pending.exchange(true))
+        return;
+
+    NonnullRefPtr protected_this = *this;
+    auto result = g_fs_work->try_queue([protected_this] {
+        protected_this->m_write_behind_pending.store(false);
+        protected_this->flush_all_shards();
+    });
+    if (result.is_error())
+        m_write_behind_pending.store(false);
+}
+
 ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuffer* buffer, size_t count, u64 offset, bool allow_cache) const
 {
     VERIFY(m_logical_block_size);
     VERIFY(offset + count <= block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * block_size() + offset;
@@ -242,17 +515,15 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, block_size()));
-            VERIFY(nread == block_size());
-            entry->has_data = true;
-        }
-        if (buffer)
-            TRY(buffer->write(entry->data + offset, count));
-        return {};
+        // NOTE: Read-ahead is driven by the inodes, which know the access pattern of each open file description.
+        return cache->shard_for(index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
+            auto* entry = TRY(ensure_cache_entry(shard, index));
+            if (!entry->has_data)
+                TRY(read_cache_entry_from_disk(*entry));
+            if (buffer)
+                TRY(buffer->write(entry->data + offset, count));
+            return {};
+        });
     });
 }
 
@@ -263,6 +534,11 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, block_size(), 0, allow_cache);
+
+    // Populate the cache with as few device reads as possible before copying the blocks out one by one.
+    if (allow_cache)
+        prefetch_blocks(index, count);
+
     auto out = buffer;
     for (unsigned i = 0; i < count; ++i) {
         TRY(read_block(BlockIndex { index.value() + i }, &out, block_size(), 0, allow_cache));
@@ -274,35 +550,107 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
 
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        auto* entry = cache->get(index);
-        if (!entry)
-            return;
-        if (!cache->entry_is_dirty(*entry))
-            return;
-        size_t base_offset = entry->block_index.value() * block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, block_size());
+    m_cache.with_shared([&](auto& cache) {
+        cache->shard_for(index).with_exclusive([&](auto& shard) {
+            if (!shard.is_dirty())
+                return;
+            auto* entry = shard.get(index);
+            if (!entry)
+                return;
+            if (!entry->is_dirty)
+                return;
+            size_t base_offset = entry->block_index.value() * block_size();
+            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+            (void)file_description().write(base_offset, entry_data_buffer, block_size());
+        });
     });
 }
 
-void BlockBasedFileSystem::flush_writes_impl()
+size_t BlockBasedFileSystem::flush_cache_shard(DiskCacheShard& shard)
+{
+    if (!shard.is_dirty())
+        return 0;
+
+    // NOTE: Blocks that fail to write stay dirty, so the next flush retries them instead of silently dropping the data.
+    size_t flushed_count = 0;
+    size_t failed_count = 0;
+    auto write_entry = [&](CacheEntry& entry) {
+        auto base_offset = entry.block_index.value() * block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        auto result = file_description().write(base_offset, entry_data_buffer, block_size());
+        if (result.is_error() || result.value() != block_size()) {
+            ++failed_count;
+            return;
+        }
+        shard.mark_clean(entry);
+        ++flushed_count;
+    };
+
+    Vector<CacheEntry*> dirty_entries;
+    if (dirty_entries.try_ensure_capacity(shard.dirty_count()).is_error()) {
+        shard.for_each_dirty_entry(write_entry);
+    } else {
+        shard.for_each_dirty_entry([&](CacheEntry& entry) {
+            dirty_entries.unchecked_append(&entry);
+        });
+
+        // Write runs of consecutive blocks with a single request each.
+        quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+        m_write_behind_buffer.with_exclusive([&](auto& write_behind_buffer) {
+            size_t run_start = 0;
+            while (run_start < dirty_entries.size()) {
+                size_t run_length = 1;
+                while (run_start + run_length < dirty_entries.size()
+                    && run_length < maximum_coalesced_write_blocks
+                    && dirty_entries[run_start + run_length]->block_index.value() == dirty_entries[run_start]->block_index.value() + run_length)
+                    ++run_length;
+
+                if (run_length == 1) {
+                    write_entry(*dirty_entries[run_start]);
+                } else {
+                    for (size_t i = 0; i < run_length; ++i)
+                        memcpy(write_behind_buffer->data() + i * block_size(), dirty_entries[run_start + i]->data, block_size());
+                    auto base_offset = dirty_entries[run_start]->block_index.value() * block_size();
+                    auto buffer = UserOrKernelBuffer::for_kernel_buffer(write_behind_buffer->data());
+                    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::flush_cache_shard {}, count={}", dirty_entries[run_start]->block_index, run_length);
+                    auto result = file_description().write(base_offset, buffer, run_length * block_size());
+                    if (result.is_error() || result.value() != run_length * block_size()) {
+                        // Don't give up on the whole run because of a single bad block.
+                        for (size_t i = 0; i < run_length; ++i)
+                            write_entry(*dirty_entries[run_start + i]);
+                    } else {
+                        for (size_t i = 0; i < run_length; ++i)
+                            shard.mark_clean(*dirty_entries[run_start + i]);
+                        flushed_count += run_length;
+                    }
+                }
+                run_start += run_length;
+            }
+        });
+    }
+
+    if (failed_count > 0)
+        dbgln("{}: Failed to write back {} blocks, keeping them dirty", class_name(), failed_count);
+    return flushed_count;
+}
+
+size_t BlockBasedFileSystem::flush_all_shards()
 {
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    m_cache.with_shared([&](auto& cache) {
+        if (!cache)
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-            ++count;
+        cache->for_each_shard([&](auto& shard) {
+            count += shard.with_exclusive([&](auto& shard) { return flush_cache_shard(shard); });
         });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
     });
+    return count;
+}
+
+void BlockBasedFileSystem::flush_writes_impl()
+{
+    if (auto count = flush_all_shards(); count > 0)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
 void BlockBasedFileSystem::flush_writes()
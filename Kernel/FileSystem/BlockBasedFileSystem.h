@@ -11,6 +11,8 @@
 
 namespace Kernel {
 
+struct CacheEntry;
+
 class BlockBasedFileSystem : public FileBackedFileSystem {
 public:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
@@ -39,14 +41,43 @@ protected:
     ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true);
     ErrorOr<void> write_blocks(BlockIndex, unsigned count, UserOrKernelBuffer const&, bool allow_cache = true);
 
+    // Reads the given blocks into the cache using as few device requests as possible.
+    void prefetch_blocks(BlockIndex, size_t count) const;
+    // Like prefetch_blocks(), but in the background. May silently drop the request if too much read-ahead is pending.
+    void schedule_prefetch_blocks(BlockIndex, size_t count) const;
+    // Frees up the cache entry of the given block, unless it still has to be written.
+    void evict_clean_block(BlockIndex) const;
+
     u64 m_logical_block_size { 512 };
 
     void remove_disk_cache_before_last_unmount();
 
 private:
+    static constexpr size_t maximum_read_ahead_blocks = 32;
+    static constexpr size_t maximum_pending_read_ahead_requests = 8;
+
+    // Once a shard has this many dirty blocks, we start writing them back in the background.
+    static constexpr size_t write_behind_threshold = 64;
+    static constexpr size_t maximum_coalesced_write_blocks = 32;
+
     void flush_specific_block_if_needed(BlockIndex index);
+    size_t flush_cache_shard(DiskCacheShard&);
+    size_t flush_all_shards();
+    void schedule_write_behind();
+
+    ErrorOr<CacheEntry*> ensure_cache_entry(DiskCacheShard&, BlockIndex) const;
+    ErrorOr<void> read_cache_entry_from_disk(CacheEntry&) const;
+    bool is_block_cached(DiskCache&, BlockIndex) const;
+
+    size_t read_ahead(DiskCache&, BlockIndex, size_t count) const;
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+
+    mutable MutexProtected<OwnPtr<KBuffer>> m_read_ahead_buffer;
+    mutable Atomic<size_t> m_pending_read_ahead_requests { 0 };
+
+    MutexProtected<OwnPtr<KBuffer>> m_write_behind_buffer;
+    Atomic<bool> m_write_behind_pending { false };
 };
 
 }
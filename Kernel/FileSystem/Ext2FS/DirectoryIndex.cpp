@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AnyOf.h>
+#include <AK/Array.h>
+#include <AK/StdLibExtras.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
+#include <Kernel/Library/StdLib.h>
+
+namespace Kernel {
+
+// These are the hash functions used by ext3 and ext4, as described in
+// https://www.kernel.org/doc/html/latest/filesystems/ext4/directory.html#hash-tree-directories
+
+static constexpr Array<u32, 4> default_seed = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+static constexpr u32 rotate_left(u32 value, unsigned shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+static u32 char_value(u8 c, bool is_unsigned)
+{
+    return is_unsigned ? c : static_cast<u32>(static_cast<i32>(static_cast<i8>(c)));
+}
+
+// Packs the name into 32-bit words, big-endian within each word, and pads the rest with its length.
+static void pack_name(ReadonlyBytes name, Span<u32> words, bool is_unsigned)
+{
+    u32 padding = static_cast<u32>(name.size()) | (static_cast<u32>(name.size()) << 8);
+    padding |= padding << 16;
+
+    u32 value = padding;
+    size_t word_index = 0;
+    auto length = min(name.size(), words.size() * sizeof(u32));
+    for (size_t i = 0; i < length; ++i) {
+        value = char_value(name[i], is_unsigned) + (value << 8);
+        if (i % 4 == 3) {
+            words[word_index++] = value;
+            value = padding;
+        }
+    }
+    if (word_index < words.size())
+        words[word_index++] = value;
+    while (word_index < words.size())
+        words[word_index++] = padding;
+}
+
+static u32 legacy_hash(ReadonlyBytes name, bool is_unsigned)
+{
+    u32 hash0 = 0x12a3fe2d;
+    u32 hash1 = 0x37abe8f9;
+    for (auto c : name) {
+        u32 hash = hash1 + (hash0 ^ (char_value(c, is_unsigned) * 7152373));
+        if (hash & 0x80000000)
+            hash -= 0x7fffffff;
+        hash1 = hash0;
+        hash0 = hash;
+    }
+    return hash0 << 1;
+}
+
+// A cut-down MD4 with only 3 rounds of 8 steps each.
+static void half_md4_transform(Array<u32, 4>& buffer, Array<u32, 8> const& in)
+{
+    auto f = [](u32 x, u32 y, u32 z) { return z ^ (x & (y ^ z)); };
+    auto g = [](u32 x, u32 y, u32 z) { return (x & y) + ((x ^ y) & z); };
+    auto h = [](u32 x, u32 y, u32 z) { return x ^ y ^ z; };
+
+    u32 a = buffer[0];
+    u32 b = buffer[1];
+    u32 c = buffer[2];
+    u32 d = buffer[3];
+
+    auto step = [](auto function, u32& w, u32 x, u32 y, u32 z, u32 value, unsigned shift) {
+        w = rotate_left(w + function(x, y, z) + value, shift);
+    };
+
+    step(f, a, b, c, d, in[0], 3);
+    step(f, d, a, b, c, in[1], 7);
+    step(f, c, d, a, b, in[2], 11);
+    step(f, b, c, d, a, in[3], 19);
+    step(f, a, b, c, d, in[4], 3);
+    step(f, d, a, b, c, in[5], 7);
+    step(f, c, d, a, b, in[6], 11);
+    step(f, b, c, d, a, in[7], 19);
+
+    static constexpr u32 round2_constant = 0x5a827999;
+    step(g, a, b, c, d, in[1] + round2_constant, 3);
+    step(g, d, a, b, c, in[3] + round2_constant, 5);
+    step(g, c, d, a, b, in[5] + round2_constant, 9);
+    step(g, b, c, d, a, in[7] + round2_constant, 13);
+    step(g, a, b, c, d, in[0] + round2_constant, 3);
+    step(g, d, a, b, c, in[2] + round2_constant, 5);
+    step(g, c, d, a, b, in[4] + round2_constant, 9);
+    step(g, b, c, d, a, in[6] + round2_constant, 13);
+
+    static constexpr u32 round3_constant = 0x6ed9eba1;
+    step(h, a, b, c, d, in[3] + round3_constant, 3);
+    step(h, d, a, b, c, in[7] + round3_constant, 9);
+    step(h, c, d, a, b, in[2] + round3_constant, 11);
+    step(h, b, c, d, a, in[6] + round3_constant, 15);
+    step(h, a, b, c, d, in[1] + round3_constant, 3);
+    step(h, d, a, b, c, in[5] + round3_constant, 9);
+    step(h, c, d, a, b, in[0] + round3_constant, 11);
+    step(h, b, c, d, a, in[4] + round3_constant, 15);
+
+    buffer[0] += a;
+    buffer[1] += b;
+    buffer[2] += c;
+    buffer[3] += d;
+}
+
+static void tea_transform(Array<u32, 4>& buffer, Array<u32, 4> const& in)
+{
+    static constexpr u32 delta = 0x9e3779b9;
+    u32 sum = 0;
+    u32 b0 = buffer[0];
+    u32 b1 = buffer[1];
+    for (size_t i = 0; i < 16; ++i) {
+        sum += delta;
+        b0 += ((b1 << 4) + in[0]) ^ (b1 + sum) ^ ((b1 >> 5) + in[1]);
+        b1 += ((b0 << 4) + in[2]) ^ (b0 + sum) ^ ((b0 >> 5) + in[3]);
+    }
+    buffer[0] += b0;
+    buffer[1] += b1;
+}
+
+Optional<u32> ext2_directory_hash(StringView name, u8 hash_version, ReadonlySpan<u32> seed)
+{
+    VERIFY(seed.size() == 4);
+
+    Array<u32, 4> buffer = default_seed;
+    if (any_of(seed, [](u32 word) { return word != 0; }))
+        seed.copy_to(buffer.span());
+
+    auto remaining = name.bytes();
+    u32 hash = 0;
+    switch (hash_version) {
+    case EXT2_HASH_LEGACY:
+    case EXT2_HASH_LEGACY_UNSIGNED:
+        hash = legacy_hash(remaining, hash_version == EXT2_HASH_LEGACY_UNSIGNED);
+        break;
+    case EXT2_HASH_HALF_MD4:
+    case EXT2_HASH_HALF_MD4_UNSIGNED: {
+        Array<u32, 8> in;
+        while (!remaining.is_empty()) {
+            pack_name(remaining, in.span(), hash_version == EXT2_HASH_HALF_MD4_UNSIGNED);
+            half_md4_transform(buffer, in);
+            remaining = remaining.slice(min(remaining.size(), 32));
+        }
+        hash = buffer[1];
+        break;
+    }
+    case EXT2_HASH_TEA:
+    case EXT2_HASH_TEA_UNSIGNED: {
+        Array<u32, 4> in;
+        while (!remaining.is_empty()) {
+            pack_name(remaining, in.span(), hash_version == EXT2_HASH_TEA_UNSIGNED);
+            tea_transform(buffer, in);
+            remaining = remaining.slice(min(remaining.size(), 16));
+        }
+        hash = buffer[0];
+        break;
+    }
+    default:
+        return {};
+    }
+
+    // The lowest bit marks hash collisions that continue in the next leaf block, and the largest hash is reserved.
+    hash &= ~1u;
+    if (hash == 0xfffffffe)
+        hash = 0xfffffffc;
+    return hash;
+}
+
+size_t Ext2FSDirectoryIndexEntries::find(u32 hash) const
+{
+    size_t low = 1;
+    size_t high = count();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (entries()[middle].hash > hash)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low - 1;
+}
+
+void Ext2FSDirectoryIndexEntries::insert(size_t index, u32 hash, u32 block)
+{
+    VERIFY(index > 0 && index <= count());
+    VERIFY(count() < limit());
+    auto* slots = entries();
+    memmove(slots + index + 1, slots + index, (count() - index) * sizeof(ext2_dx_entry));
+    slots[index].hash = hash;
+    slots[index].block = block;
+    set_count(count() + 1);
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/Ext2FS/Definitions.h>
+#include <Kernel/FileSystem/InodeIdentifier.h>
+
+namespace Kernel {
+
+// Hashed directories ("htree") keep their entries in leaf blocks that are sorted by the hash of the entry names,
+// and an index on top of them that maps hash ranges to leaf blocks. The root of the index lives in the first block
+// of the directory behind the "." and ".." entries, and every other index block looks like one big unused entry,
+// so the directory can still be read as a flat list of entries by anyone who doesn't know about the index.
+
+Optional<u32> ext2_directory_hash(StringView name, u8 hash_version, ReadonlySpan<u32> seed);
+
+class Ext2FSDirectoryIndexEntries {
+public:
+    static constexpr size_t root_info_offset = 24;
+    static constexpr size_t node_entries_offset = 8;
+
+    static size_t root_limit(size_t block_size) { return (block_size - root_info_offset - sizeof(ext2_dx_root_info)) / sizeof(ext2_dx_entry); }
+    static size_t node_limit(size_t block_size) { return (block_size - node_entries_offset) / sizeof(ext2_dx_entry); }
+
+    static Ext2FSDirectoryIndexEntries for_root(Bytes block) { return { block.slice(root_info_offset + sizeof(ext2_dx_root_info)) }; }
+    static Ext2FSDirectoryIndexEntries for_node(Bytes block) { return { block.slice(node_entries_offset) }; }
+
+    u16 limit() const { return count_limit().limit; }
+    u16 count() const { return count_limit().count; }
+    void set_limit(u16 limit) { count_limit().limit = limit; }
+    void set_count(u16 count) { count_limit().count = count; }
+
+    // NOTE: The first entry has no hash, as it covers everything below the hash of the second one.
+    //       Its hash field is where the count and limit are stored.
+    u32 hash(size_t index) const { return index == 0 ? 0 : entries()[index].hash; }
+    u32 block(size_t index) const { return entries()[index].block; }
+    void set_block(size_t index, u32 block) { entries()[index].block = block; }
+
+    // Returns the index of the entry whose hash range contains the given hash.
+    size_t find(u32 hash) const;
+    void insert(size_t index, u32 hash, u32 block);
+
+    Bytes bytes() { return m_bytes; }
+
+private:
+    Ext2FSDirectoryIndexEntries(Bytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    ext2_dx_countlimit& count_limit() { return *reinterpret_cast<ext2_dx_countlimit*>(m_bytes.data()); }
+    ext2_dx_countlimit const& count_limit() const { return *reinterpret_cast<ext2_dx_countlimit const*>(m_bytes.data()); }
+    ext2_dx_entry* entries() { return reinterpret_cast<ext2_dx_entry*>(m_bytes.data()); }
+    ext2_dx_entry const* entries() const { return reinterpret_cast<ext2_dx_entry const*>(m_bytes.data()); }
+
+    Bytes m_bytes;
+};
+
+struct Ext2FSDirectoryIndexFrame {
+    ByteBuffer block;
+    u32 logical_block_index { 0 };
+    size_t position { 0 };
+
+    bool is_root() const { return logical_block_index == 0; }
+    Ext2FSDirectoryIndexEntries entries() { return is_root() ? Ext2FSDirectoryIndexEntries::for_root(block.bytes()) : Ext2FSDirectoryIndexEntries::for_node(block.bytes()); }
+};
+
+// The way from the root of the index down to the leaf block that holds the entries with a given hash.
+struct Ext2FSDirectoryIndexPath {
+    u32 hash { 0 };
+    u8 hash_version { 0 };
+    Vector<Ext2FSDirectoryIndexFrame, 2> frames;
+
+    ext2_dx_root_info& root_info() { return *reinterpret_cast<ext2_dx_root_info*>(frames.first().block.data() + Ext2FSDirectoryIndexEntries::root_info_offset); }
+    u32 leaf_block_index() { return frames.last().entries().block(frames.last().position); }
+};
+
+struct Ext2FSDirectoryIndexMatch {
+    ByteBuffer leaf_block;
+    u32 leaf_block_index { 0 };
+    size_t offset { 0 };
+    Optional<size_t> previous_offset;
+    InodeIndex inode_index { 0 };
+
+    ext2_dir_entry_2& entry() { return *reinterpret_cast<ext2_dir_entry_2*>(leaf_block.data() + offset); }
+};
+
+}
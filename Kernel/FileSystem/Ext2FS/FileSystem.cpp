@@ -6,6 +6,7 @@
  */
 
 #include <Kernel/Debug.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Ext2FS/Inode.h>
 #include <Kernel/Tasks/Process.h>
@@ -194,6 +195,19 @@ Ext2FS::FeaturesReadOnly Ext2FS::get_features_readonly() const
     return Ext2FS::FeaturesReadOnly::None;
 }
 
+bool Ext2FS::has_directory_index_feature() const
+{
+    return m_super_block.s_rev_level > 0 && (m_super_block.s_feature_compat & EXT2_FEATURE_COMPAT_DIR_INDEX);
+}
+
+Optional<u32> Ext2FS::directory_hash(StringView name, u8 hash_version) const
+{
+    // The hash version stored in a directory index doesn't say whether chars are signed, the superblock does.
+    if (hash_version <= EXT2_HASH_TEA && (m_super_block.s_flags & EXT2_FLAGS_UNSIGNED_HASH))
+        hash_version += EXT2_HASH_LEGACY_UNSIGNED;
+    return ext2_directory_hash(name, hash_version, { m_super_block.s_hash_seed, array_size(m_super_block.s_hash_seed) });
+}
+
 u64 Ext2FS::inodes_per_block() const
 {
     return EXT2_INODES_PER_BLOCK(&super_block());
@@ -536,9 +550,11 @@ ErrorOr<void> Ext2FS::prepare_to_clear_last_mount()
 {
     MutexLocker locker(m_lock);
     for (auto& it : m_inode_cache) {
-        if (it.value->ref_count() > 1)
+        if (it.value->ref_count() > 1 + it.value->page_cache_reference_count())
             return EBUSY;
     }
+    for (auto& it : m_inode_cache)
+        it.value->drop_page_cache();
 
     BlockBasedFileSystem::remove_disk_cache_before_last_unmount();
     m_inode_cache.clear();
@@ -633,7 +649,14 @@ void Ext2FS::flush_writes()
             if (cached_inode == nullptr)
                 return true;
 
-            return cached_inode->ref_count() == 1 && !cached_inode->has_watchers();
+            // NOTE: The page cache of an inode keeps a reference to it, which we have to break before letting go.
+            //       Inodes with cached contents are kept around for a while, in case the file is opened again soon.
+            if (cached_inode->ref_count() != 1 + cached_inode->page_cache_reference_count() || cached_inode->has_watchers())
+                return false;
+            if (cached_inode->has_cached_pages() && !cached_inode->age_page_cache())
+                return false;
+            cached_inode->drop_page_cache();
+            return true;
         });
     }
 
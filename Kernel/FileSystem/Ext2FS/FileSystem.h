@@ -60,6 +60,9 @@ private:
     u64 blocks_per_group() const;
     u64 inode_size() const;
 
+    bool has_directory_index_feature() const;
+    Optional<u32> directory_hash(StringView name, u8 hash_version) const;
+
     ErrorOr<NonnullRefPtr<Ext2FSInode>> build_root_inode() const;
 
     ErrorOr<void> write_ext2_inode(InodeIndex, ext2_inode const&);
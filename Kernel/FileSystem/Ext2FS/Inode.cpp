@@ -6,6 +6,7 @@
  */
 
 #include <AK/MemoryStream.h>
+#include <AK/QuickSort.h>
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Ext2FS/Inode.h>
@@ -35,6 +36,70 @@ static u8 to_ext2_file_type(mode_t mode)
     return EXT2_FT_UNKNOWN;
 }
 
+static ErrorOr<ext2_dir_entry_2*> directory_entry_at(Bytes block, size_t offset)
+{
+    if (offset + EXT2_DIR_REC_LEN(0) > block.size())
+        return EIO;
+    auto* entry = reinterpret_cast<ext2_dir_entry_2*>(block.data() + offset);
+    if (entry->rec_len < EXT2_DIR_REC_LEN(entry->name_len) || entry->rec_len % EXT2_DIR_PAD != 0 || offset + entry->rec_len > block.size())
+        return EIO;
+    return entry;
+}
+
+static void write_directory_entry(Bytes block, size_t offset, u16 record_length, StringView name, u32 inode_index, u8 file_type)
+{
+    auto* entry = reinterpret_cast<ext2_dir_entry_2*>(block.data() + offset);
+    entry->inode = inode_index;
+    entry->rec_len = record_length;
+    entry->name_len = name.length();
+    entry->file_type = file_type;
+    memcpy(entry->name, name.characters_without_null_termination(), name.length());
+}
+
+// Tries to fit a new entry into an unused entry or the space left over at the end of another one.
+static ErrorOr<bool> try_add_to_leaf_block(Bytes block, StringView name, InodeIndex inode_index, u8 file_type)
+{
+    auto needed_length = EXT2_DIR_REC_LEN(name.length());
+    for (size_t offset = 0; offset < block.size();) {
+        auto* entry = TRY(directory_entry_at(block, offset));
+        auto used_length = entry->inode != 0 ? EXT2_DIR_REC_LEN(entry->name_len) : 0;
+        if (static_cast<size_t>(entry->rec_len - used_length) >= needed_length) {
+            if (used_length == 0) {
+                write_directory_entry(block, offset, entry->rec_len, name, inode_index.value(), file_type);
+            } else {
+                write_directory_entry(block, offset + used_length, entry->rec_len - used_length, name, inode_index.value(), file_type);
+                entry->rec_len = used_length;
+            }
+            return true;
+        }
+        offset += entry->rec_len;
+    }
+    return false;
+}
+
+struct LeafEntry {
+    u32 hash { 0 };
+    StringView name;
+    InodeIndex inode_index { 0 };
+    u8 file_type { 0 };
+};
+
+static void write_leaf_block(Bytes block, ReadonlySpan<LeafEntry> entries)
+{
+    memset(block.data(), 0, block.size());
+    if (entries.is_empty()) {
+        write_directory_entry(block, 0, block.size(), {}, 0, 0);
+        return;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto const& entry = entries[i];
+        auto record_length = i + 1 < entries.size() ? EXT2_DIR_REC_LEN(entry.name.length()) : block.size() - offset;
+        write_directory_entry(block, offset, record_length, entry.name, entry.inode_index.value(), entry.file_type);
+        offset += record_length;
+    }
+}
+
 ErrorOr<void> Ext2FSInode::write_indirect_block(BlockBasedFileSystem::BlockIndex block, Span<BlockBasedFileSystem::BlockIndex> blocks_indices)
 {
     auto const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
@@ -567,6 +632,14 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
 
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
+    if (allow_cache) {
+        // Get the blocks for this read with as few device requests as possible, then start reading ahead of the reader.
+        if (last_block_logical_index > first_block_logical_index)
+            prefetch_logical_blocks(first_block_logical_index.value(), last_block_logical_index.value() + 1, ShouldPrefetchInBackground::No);
+        if (description)
+            read_ahead(*description, offset, remaining_count);
+    }
+
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
         auto block_index = m_block_list[bi.value()];
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
@@ -588,6 +661,82 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     return nread;
 }
 
+void Ext2FSInode::prefetch_logical_blocks(size_t first_logical_block, size_t end_logical_block, ShouldPrefetchInBackground should_prefetch_in_background) const
+{
+    end_logical_block = min(end_logical_block, m_block_list.size());
+
+    // Split the range into runs of physically contiguous blocks, each of which can be read with a single request.
+    size_t logical_block = first_logical_block;
+    while (logical_block < end_logical_block) {
+        auto first_block = m_block_list[logical_block];
+        if (first_block.value() == 0) {
+            // This is a hole, there's nothing to read.
+            ++logical_block;
+            continue;
+        }
+        size_t run_length = 1;
+        while (logical_block + run_length < end_logical_block && m_block_list[logical_block + run_length].value() == first_block.value() + run_length)
+            ++run_length;
+
+        if (should_prefetch_in_background == ShouldPrefetchInBackground::Yes)
+            fs().schedule_prefetch_blocks(first_block, run_length);
+        else
+            fs().prefetch_blocks(first_block, run_length);
+        logical_block += run_length;
+    }
+}
+
+void Ext2FSInode::did_read_into_page_cache(u64 offset, size_t count) const
+{
+    // The page cache now has its own copy of these blocks, so don't keep a second one in the disk cache.
+    MutexLocker inode_locker(m_inode_lock, Mutex::Mode::Shared);
+    MutexLocker block_list_locker(const_cast<Ext2FSInode&>(*this).m_block_list_lock);
+
+    // NOTE: Blocks that are only partially covered by the range are still needed by whoever reads the rest of them.
+    auto block_size = fs().block_size();
+    auto first_logical_block = ceil_div(offset, static_cast<u64>(block_size));
+    auto end_logical_block = min((offset + count) / block_size, static_cast<u64>(m_block_list.size()));
+    for (auto logical_block = first_logical_block; logical_block < end_logical_block; ++logical_block) {
+        if (auto block_index = m_block_list[logical_block]; block_index.value() != 0)
+            fs().evict_clean_block(block_index);
+    }
+}
+
+void Ext2FSInode::read_ahead(OpenFileDescription& description, u64 offset, u64 count) const
+{
+    static constexpr u64 minimum_read_ahead_size = 16 * KiB;
+    static constexpr u64 maximum_read_ahead_size = 512 * KiB;
+
+    auto end = offset + count;
+    u64 read_ahead_start = 0;
+    u64 read_ahead_end = 0;
+    description.with_read_ahead_state([&](auto& state) {
+        bool is_sequential = offset == state.next_offset;
+        state.next_offset = end;
+        if (!is_sequential) {
+            state.window_size = 0;
+            state.read_ahead_end = 0;
+            return;
+        }
+        // Only issue more read-ahead once the reader has consumed half of the previous window,
+        // doubling the window every time so that long sequential reads keep the device busy.
+        if (state.read_ahead_end > end && state.read_ahead_end - end >= state.window_size / 2)
+            return;
+        state.window_size = clamp(state.window_size * 2, minimum_read_ahead_size, maximum_read_ahead_size);
+        read_ahead_start = max(state.read_ahead_end, end);
+        read_ahead_end = read_ahead_start + state.window_size;
+        state.read_ahead_end = read_ahead_end;
+    });
+
+    read_ahead_end = min(read_ahead_end, size());
+    if (read_ahead_start >= read_ahead_end)
+        return;
+
+    u64 const block_size = fs().block_size();
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_ahead(): Reading ahead bytes {}-{}", identifier(), read_ahead_start, read_ahead_end);
+    prefetch_logical_blocks(read_ahead_start / block_size, ceil_div(read_ahead_end, block_size), ShouldPrefetchInBackground::Yes);
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     auto old_size = size();
@@ -785,6 +934,10 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
         directory_size += entry.record_length;
     }
 
+    // Directories that don't fit into a single block get an index, if the file system allows it.
+    if (directory_size > block_size && fs().has_directory_index_feature() && TRY(write_indexed_directory(entries)))
+        return {};
+
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_directory(): New directory contents to write (size {}):", identifier(), directory_size);
 
     auto directory_data = TRY(ByteBuffer::create_uninitialized(directory_size));
@@ -810,12 +963,376 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
 
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
     auto nwritten = TRY(write_bytes(0, serialized_bytes_count, buffer, nullptr));
+    m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
     set_metadata_dirty(true);
     if (nwritten != directory_data.size())
         return EIO;
     return {};
 }
 
+ErrorOr<bool> Ext2FSInode::write_indexed_directory(Vector<Ext2FSDirectoryEntry>& entries)
+{
+    MutexLocker locker(m_inode_lock);
+    auto block_size = fs().block_size();
+
+    auto current_directory = entries.find_if([](auto& entry) { return entry.name->view() == "."sv; });
+    auto parent_directory = entries.find_if([](auto& entry) { return entry.name->view() == ".."sv; });
+    if (current_directory.is_end() || parent_directory.is_end())
+        return false;
+
+    u8 hash_version = fs().super_block().s_def_hash_version;
+    if (!fs().directory_hash(""sv, hash_version).has_value())
+        hash_version = EXT2_HASH_HALF_MD4;
+
+    Vector<LeafEntry> leaf_entries;
+    TRY(leaf_entries.try_ensure_capacity(entries.size()));
+    for (auto& entry : entries) {
+        if (entry.name->view() == "."sv || entry.name->view() == ".."sv)
+            continue;
+        auto hash = fs().directory_hash(entry.name->view(), hash_version).release_value();
+        leaf_entries.unchecked_append({ hash, entry.name->view(), entry.inode_index, entry.file_type });
+    }
+    quick_sort(leaf_entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    // Leave some room in every leaf, so the next few entries don't have to split them right away.
+    struct Leaf {
+        size_t first_entry { 0 };
+        size_t entry_count { 0 };
+        u32 hash { 0 };
+    };
+    Vector<Leaf> leaves;
+    size_t leaf_length = 0;
+    for (size_t i = 0; i < leaf_entries.size(); ++i) {
+        auto length = EXT2_DIR_REC_LEN(leaf_entries[i].name.length());
+        if (leaves.is_empty() || leaf_length + length > block_size * 3 / 4) {
+            auto hash = leaf_entries[i].hash;
+            if (leaves.is_empty())
+                hash = 0;
+            else if (hash == leaf_entries[i - 1].hash)
+                hash |= 1;
+            TRY(leaves.try_append({ i, 0, hash }));
+            leaf_length = 0;
+        }
+        ++leaves.last().entry_count;
+        leaf_length += length;
+    }
+    if (leaves.is_empty())
+        TRY(leaves.try_append({}));
+
+    auto root_limit = Ext2FSDirectoryIndexEntries::root_limit(block_size);
+    auto node_limit = Ext2FSDirectoryIndexEntries::node_limit(block_size);
+    size_t node_count = 0;
+    if (leaves.size() > root_limit) {
+        node_count = ceil_div(leaves.size(), node_limit);
+        if (node_count > root_limit)
+            return false;
+    }
+
+    // The root goes first, followed by the nodes (if any) and then all leaves.
+    auto block_count = 1 + node_count + leaves.size();
+    auto directory_data = TRY(ByteBuffer::create_zeroed(block_count * block_size));
+    auto block_at = [&](size_t logical_block_index) { return directory_data.bytes().slice(logical_block_index * block_size, block_size); };
+
+    auto root = block_at(0);
+    write_directory_entry(root, 0, EXT2_DIR_REC_LEN(1), "."sv, current_directory->inode_index.value(), EXT2_FT_DIR);
+    write_directory_entry(root, EXT2_DIR_REC_LEN(1), block_size - EXT2_DIR_REC_LEN(1), ".."sv, parent_directory->inode_index.value(), EXT2_FT_DIR);
+    auto& root_info = *reinterpret_cast<ext2_dx_root_info*>(root.data() + Ext2FSDirectoryIndexEntries::root_info_offset);
+    root_info.hash_version = hash_version;
+    root_info.info_length = sizeof(ext2_dx_root_info);
+    root_info.indirect_levels = node_count > 0 ? 1 : 0;
+    auto root_entries = Ext2FSDirectoryIndexEntries::for_root(root);
+    root_entries.set_limit(root_limit);
+
+    auto first_leaf_block_index = 1 + node_count;
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        auto& leaf = leaves[i];
+        write_leaf_block(block_at(first_leaf_block_index + i), leaf_entries.span().slice(leaf.first_entry, leaf.entry_count));
+    }
+
+    auto add_index_entry = [](Ext2FSDirectoryIndexEntries& index_entries, u32 hash, u32 block) {
+        if (index_entries.count() == 0) {
+            index_entries.set_block(0, block);
+            index_entries.set_count(1);
+        } else {
+            index_entries.insert(index_entries.count(), hash, block);
+        }
+    };
+
+    if (node_count == 0) {
+        for (size_t i = 0; i < leaves.size(); ++i)
+            add_index_entry(root_entries, leaves[i].hash, first_leaf_block_index + i);
+    } else {
+        for (size_t node_index = 0; node_index < node_count; ++node_index) {
+            auto node = block_at(1 + node_index);
+            write_directory_entry(node, 0, block_size, {}, 0, 0);
+            auto node_entries = Ext2FSDirectoryIndexEntries::for_node(node);
+            node_entries.set_limit(node_limit);
+            auto first_leaf = node_index * node_limit;
+            auto last_leaf = min(first_leaf + node_limit, leaves.size());
+            for (size_t i = first_leaf; i < last_leaf; ++i)
+                add_index_entry(node_entries, leaves[i].hash, first_leaf_block_index + i);
+            add_index_entry(root_entries, leaves[first_leaf].hash, 1 + node_index);
+        }
+    }
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_indexed_directory(): Writing {} entries in {} leaves and {} index nodes", identifier(), leaf_entries.size(), leaves.size(), node_count);
+
+    TRY(resize(directory_data.size()));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
+    auto nwritten = TRY(write_bytes(0, directory_data.size(), buffer, nullptr));
+    m_raw_inode.i_flags |= EXT2_INDEX_FL;
+    set_metadata_dirty(true);
+    if (nwritten != directory_data.size())
+        return EIO;
+
+    // Lookups in indexed directories go through the index instead.
+    m_lookup_cache.clear();
+    return true;
+}
+
+bool Ext2FSInode::has_directory_index() const
+{
+    return is_directory() && (m_raw_inode.i_flags & EXT2_INDEX_FL) && fs().has_directory_index_feature();
+}
+
+ErrorOr<ByteBuffer> Ext2FSInode::read_directory_block(u32 logical_block_index) const
+{
+    auto block_size = fs().block_size();
+    auto block = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(block.data());
+    auto nread = TRY(read_bytes(static_cast<u64>(logical_block_index) * block_size, block_size, buffer, nullptr));
+    if (nread != block_size)
+        return EIO;
+    return block;
+}
+
+ErrorOr<void> Ext2FSInode::write_directory_block(u32 logical_block_index, ReadonlyBytes block)
+{
+    VERIFY(block.size() == fs().block_size());
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(block.data()));
+    auto nwritten = TRY(write_bytes(static_cast<u64>(logical_block_index) * block.size(), block.size(), buffer, nullptr));
+    if (nwritten != block.size())
+        return EIO;
+    return {};
+}
+
+ErrorOr<u32> Ext2FSInode::append_directory_block(ReadonlyBytes block)
+{
+    u32 logical_block_index = size() / fs().block_size();
+    TRY(write_directory_block(logical_block_index, block));
+    return logical_block_index;
+}
+
+// Walks down the index to the leaf block that should contain the given name.
+// If the index is anything we don't understand, we treat the directory as a flat list of entries instead.
+ErrorOr<Optional<Ext2FSDirectoryIndexPath>> Ext2FSInode::probe_directory_index(StringView name) const
+{
+    VERIFY(has_directory_index());
+    auto block_size = fs().block_size();
+    auto block_count = size() / block_size;
+
+    Ext2FSDirectoryIndexPath path;
+    TRY(path.frames.try_append({ TRY(read_directory_block(0)), 0, 0 }));
+
+    auto root_info = path.root_info();
+    // NOTE: More than one level of nodes below the root needs the "largedir" feature, which we don't support.
+    if (root_info.reserved_zero != 0 || root_info.info_length != sizeof(ext2_dx_root_info) || root_info.indirect_levels > 1 || (root_info.unused_flags & EXT2_HASH_FLAG_INCOMPAT)) {
+        dbgln("Ext2FSInode[{}]::probe_directory_index(): Unsupported directory index (hash version {}, {} levels)", identifier(), root_info.hash_version, root_info.indirect_levels);
+        return OptionalNone {};
+    }
+
+    auto hash = fs().directory_hash(name, root_info.hash_version);
+    if (!hash.has_value()) {
+        dbgln("Ext2FSInode[{}]::probe_directory_index(): Unsupported hash version {}", identifier(), root_info.hash_version);
+        return OptionalNone {};
+    }
+    path.hash = hash.value();
+    path.hash_version = root_info.hash_version;
+
+    for (size_t level = 0;; ++level) {
+        auto& frame = path.frames.last();
+        auto entries = frame.entries();
+        auto expected_limit = frame.is_root() ? Ext2FSDirectoryIndexEntries::root_limit(block_size) : Ext2FSDirectoryIndexEntries::node_limit(block_size);
+        if (entries.limit() != expected_limit || entries.count() == 0 || entries.count() > entries.limit()) {
+            dbgln("Ext2FSInode[{}]::probe_directory_index(): Bad index block {} (count {}, limit {})", identifier(), frame.logical_block_index, entries.count(), entries.limit());
+            return OptionalNone {};
+        }
+
+        frame.position = entries.find(path.hash);
+        auto next_block_index = entries.block(frame.position);
+        if (next_block_index == 0 || next_block_index >= block_count) {
+            dbgln("Ext2FSInode[{}]::probe_directory_index(): Index points to block {}, which is out of bounds", identifier(), next_block_index);
+            return OptionalNone {};
+        }
+        if (level == root_info.indirect_levels)
+            break;
+        TRY(path.frames.try_append({ TRY(read_directory_block(next_block_index)), next_block_index, 0 }));
+    }
+
+    return path;
+}
+
+// If the entries with our hash continue in the next leaf block, moves the path over to it.
+ErrorOr<bool> Ext2FSInode::advance_directory_index(Ext2FSDirectoryIndexPath& path) const
+{
+    size_t level = path.frames.size() - 1;
+    while (path.frames[level].position + 1 >= path.frames[level].entries().count()) {
+        if (level == 0)
+            return false;
+        --level;
+    }
+
+    auto& frame = path.frames[level];
+    auto next_hash = frame.entries().hash(frame.position + 1);
+    if (!(next_hash & 1) || (next_hash & ~1u) != path.hash)
+        return false;
+    ++frame.position;
+
+    for (++level; level < path.frames.size(); ++level) {
+        auto& parent = path.frames[level - 1];
+        auto block_index = parent.entries().block(parent.position);
+        path.frames[level].block = TRY(read_directory_block(block_index));
+        path.frames[level].logical_block_index = block_index;
+        path.frames[level].position = 0;
+    }
+    return true;
+}
+
+ErrorOr<Optional<Ext2FSDirectoryIndexMatch>> Ext2FSInode::find_in_directory_index(Ext2FSDirectoryIndexPath& path, StringView name) const
+{
+    do {
+        auto leaf_block_index = path.leaf_block_index();
+        auto leaf_block = TRY(read_directory_block(leaf_block_index));
+        Optional<size_t> previous_offset;
+        for (size_t offset = 0; offset < leaf_block.size();) {
+            auto* entry = TRY(directory_entry_at(leaf_block.bytes(), offset));
+            if (entry->inode != 0 && name == StringView { entry->name, entry->name_len }) {
+                InodeIndex inode_index = entry->inode;
+                return Ext2FSDirectoryIndexMatch { move(leaf_block), leaf_block_index, offset, previous_offset, inode_index };
+            }
+            previous_offset = offset;
+            offset += entry->rec_len;
+        }
+    } while (TRY(advance_directory_index(path)));
+
+    return OptionalNone {};
+}
+
+// Makes sure the deepest index block on the path has room for one more entry, by growing the index by one level
+// or splitting the node in two. Afterwards, the path leads to the same leaf block as before.
+ErrorOr<void> Ext2FSInode::make_room_in_directory_index(Ext2FSDirectoryIndexPath& path)
+{
+    auto block_size = fs().block_size();
+    auto node_limit = Ext2FSDirectoryIndexEntries::node_limit(block_size);
+    auto& deepest = path.frames.last();
+    auto entries = deepest.entries();
+    if (entries.count() < entries.limit())
+        return {};
+
+    auto create_node = [&](ReadonlyBytes entries_to_move) -> ErrorOr<ByteBuffer> {
+        auto node = TRY(ByteBuffer::create_zeroed(block_size));
+        write_directory_entry(node.bytes(), 0, block_size, {}, 0, 0);
+        auto node_entries = Ext2FSDirectoryIndexEntries::for_node(node.bytes());
+        // NOTE: This also overwrites the count and limit with the hash of the first entry, which has no use for it.
+        memcpy(node_entries.bytes().data(), entries_to_move.data(), entries_to_move.size());
+        node_entries.set_limit(node_limit);
+        node_entries.set_count(entries_to_move.size() / sizeof(ext2_dx_entry));
+        return node;
+    };
+
+    if (deepest.is_root()) {
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::make_room_in_directory_index(): Adding a level to the index", identifier());
+        auto node = TRY(create_node(entries.bytes().trim(entries.count() * sizeof(ext2_dx_entry))));
+        auto node_block_index = TRY(append_directory_block(node));
+        entries.set_count(1);
+        entries.set_block(0, node_block_index);
+        path.root_info().indirect_levels = 1;
+        TRY(write_directory_block(0, deepest.block));
+
+        auto position = deepest.position;
+        deepest.position = 0;
+        TRY(path.frames.try_append({ move(node), node_block_index, position }));
+        return {};
+    }
+
+    auto& root = path.frames.first();
+    auto root_entries = root.entries();
+    if (root_entries.count() >= root_entries.limit()) {
+        dbgln("Ext2FSInode[{}]::make_room_in_directory_index(): Directory index is full", identifier());
+        return ENOSPC;
+    }
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::make_room_in_directory_index(): Splitting index node {}", identifier(), deepest.logical_block_index);
+    size_t half = entries.count() / 2;
+    auto split_hash = entries.hash(half);
+    auto new_node = TRY(create_node(entries.bytes().slice(half * sizeof(ext2_dx_entry), (entries.count() - half) * sizeof(ext2_dx_entry))));
+    auto new_node_block_index = TRY(append_directory_block(new_node));
+    entries.set_count(half);
+    TRY(write_directory_block(deepest.logical_block_index, deepest.block));
+    root_entries.insert(root.position + 1, split_hash, new_node_block_index);
+    TRY(write_directory_block(0, root.block));
+
+    if (deepest.position >= half) {
+        deepest.block = move(new_node);
+        deepest.logical_block_index = new_node_block_index;
+        deepest.position -= half;
+        ++root.position;
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2FSInode::add_to_directory_index(Ext2FSDirectoryIndexPath& path, StringView name, InodeIndex inode_index, u8 file_type)
+{
+    auto block_size = fs().block_size();
+    auto leaf_block_index = path.leaf_block_index();
+    auto leaf_block = TRY(read_directory_block(leaf_block_index));
+    if (TRY(try_add_to_leaf_block(leaf_block.bytes(), name, inode_index, file_type)))
+        return write_directory_block(leaf_block_index, leaf_block);
+
+    // The leaf block is full, so we move the upper half of its entries (by hash) into a new one.
+    TRY(make_room_in_directory_index(path));
+
+    Vector<LeafEntry> entries;
+    size_t total_length = 0;
+    for (size_t offset = 0; offset < block_size;) {
+        auto* entry = TRY(directory_entry_at(leaf_block.bytes(), offset));
+        if (entry->inode != 0) {
+            StringView entry_name { entry->name, entry->name_len };
+            auto hash = fs().directory_hash(entry_name, path.hash_version).release_value();
+            TRY(entries.try_append({ hash, entry_name, entry->inode, entry->file_type }));
+            total_length += EXT2_DIR_REC_LEN(entry->name_len);
+        }
+        offset += entry->rec_len;
+    }
+    TRY(entries.try_append({ path.hash, name, inode_index, file_type }));
+    total_length += EXT2_DIR_REC_LEN(name.length());
+    quick_sort(entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    size_t split = 0;
+    size_t lower_length = 0;
+    while (split + 1 < entries.size() && lower_length < total_length / 2)
+        lower_length += EXT2_DIR_REC_LEN(entries[split++].name.length());
+
+    // If entries with the same hash end up on both sides, the new leaf is marked as a continuation of this one.
+    auto split_hash = entries[split].hash;
+    if (split_hash == entries[split - 1].hash)
+        split_hash |= 1;
+
+    auto lower_block = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto upper_block = TRY(ByteBuffer::create_uninitialized(block_size));
+    write_leaf_block(lower_block.bytes(), entries.span().trim(split));
+    write_leaf_block(upper_block.bytes(), entries.span().slice(split));
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_to_directory_index(): Splitting leaf block {} at hash {:#08x}", identifier(), leaf_block_index, split_hash);
+
+    auto upper_block_index = TRY(append_directory_block(upper_block));
+    TRY(write_directory_block(leaf_block_index, lower_block));
+
+    auto& frame = path.frames.last();
+    frame.entries().insert(frame.position + 1, split_hash, upper_block_index);
+    return write_directory_block(frame.logical_block_index, frame.block);
+}
+
 ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, UserID uid, GroupID gid)
 {
     if (Kernel::is_directory(mode))
@@ -833,6 +1350,21 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
 
+    if (has_directory_index()) {
+        if (auto path = TRY(probe_directory_index(name)); path.has_value()) {
+            if (TRY(find_in_directory_index(*path, name)).has_value())
+                return EEXIST;
+            // NOTE: Looking for an existing entry may have moved the path on to another leaf block.
+            path = TRY(probe_directory_index(name));
+            VERIFY(path.has_value());
+
+            TRY(child.increment_link_count());
+            TRY(add_to_directory_index(*path, name, child.index(), to_ext2_file_type(mode)));
+            did_add_child(child.identifier(), name);
+            return {};
+        }
+    }
+
     Vector<Ext2FSDirectoryEntry> entries;
     TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
         if (name == entry.name)
@@ -848,10 +1380,12 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
     TRY(entries.try_empend(move(entry_name), child.index(), to_ext2_file_type(mode)));
 
     TRY(write_directory(entries));
-    TRY(populate_lookup_cache());
 
-    auto cache_entry_name = TRY(KString::try_create(name));
-    TRY(m_lookup_cache.try_set(move(cache_entry_name), child.index()));
+    if (!has_directory_index()) {
+        TRY(populate_lookup_cache());
+        auto cache_entry_name = TRY(KString::try_create(name));
+        TRY(m_lookup_cache.try_set(move(cache_entry_name), child.index()));
+    }
     did_add_child(child.identifier(), name);
     return {};
 }
@@ -862,6 +1396,29 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::remove_child(): Removing '{}'", identifier(), name);
     VERIFY(is_directory());
 
+    if (has_directory_index()) {
+        if (auto path = TRY(probe_directory_index(name)); path.has_value()) {
+            auto match = TRY(find_in_directory_index(*path, name));
+            if (!match.has_value())
+                return ENOENT;
+
+            // Like everyone else, we never shrink the index, the space is reused by later entries instead.
+            auto& entry = match->entry();
+            if (match->previous_offset.has_value())
+                reinterpret_cast<ext2_dir_entry_2*>(match->leaf_block.data() + match->previous_offset.value())->rec_len += entry.rec_len;
+            else
+                entry.inode = 0;
+            TRY(write_directory_block(match->leaf_block_index, match->leaf_block));
+
+            InodeIdentifier child_id { fsid(), match->inode_index };
+            auto child_inode = TRY(fs().get_inode(child_id));
+            TRY(child_inode->decrement_link_count());
+
+            did_remove_child(child_id, name);
+            return {};
+        }
+    }
+
     TRY(populate_lookup_cache());
 
     auto it = m_lookup_cache.find(name);
@@ -882,7 +1439,9 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
 
     TRY(write_directory(entries));
 
-    m_lookup_cache.remove(it);
+    // NOTE: If the directory got an index, the lookup cache is gone already.
+    if (!has_directory_index())
+        m_lookup_cache.remove(it);
 
     auto child_inode = TRY(fs().get_inode(child_id));
     TRY(child_inode->decrement_link_count());
@@ -897,11 +1456,30 @@ ErrorOr<void> Ext2FSInode::replace_child(StringView name, Inode& child)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::replace_child(): Replacing '{}' with inode {}", identifier(), name, child.index());
     VERIFY(is_directory());
 
-    TRY(populate_lookup_cache());
-
     if (name.length() > EXT2_NAME_LEN)
         return ENAMETOOLONG;
 
+    if (has_directory_index()) {
+        if (auto path = TRY(probe_directory_index(name)); path.has_value()) {
+            auto match = TRY(find_in_directory_index(*path, name));
+            if (!match.has_value())
+                return ENOENT;
+
+            auto old_child = TRY(fs().get_inode({ fsid(), match->inode_index }));
+            TRY(child.increment_link_count());
+            if (auto result = old_child->decrement_link_count(); result.is_error()) {
+                MUST(child.decrement_link_count());
+                return result;
+            }
+
+            match->entry().inode = child.index().value();
+            match->entry().file_type = to_ext2_file_type(child.mode());
+            return write_directory_block(match->leaf_block_index, match->leaf_block);
+        }
+    }
+
+    TRY(populate_lookup_cache());
+
     Vector<Ext2FSDirectoryEntry> entries;
 
     Optional<InodeIndex> old_child_index;
@@ -974,13 +1552,26 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
     InodeIndex inode_index;
     {
         MutexLocker locker(m_inode_lock);
-        TRY(populate_lookup_cache());
-        auto it = m_lookup_cache.find(name);
-        if (it == m_lookup_cache.end()) {
-            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
-            return ENOENT;
+        Optional<Ext2FSDirectoryIndexPath> path;
+        if (has_directory_index())
+            path = TRY(probe_directory_index(name));
+
+        if (path.has_value()) {
+            auto match = TRY(find_in_directory_index(*path, name));
+            if (!match.has_value()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = match->inode_index;
+        } else {
+            TRY(populate_lookup_cache());
+            auto it = m_lookup_cache.find(name);
+            if (it == m_lookup_cache.end()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = it->value;
         }
-        inode_index = it->value;
     }
 
     return fs().get_inode({ fsid(), inode_index });
@@ -1032,8 +1623,10 @@ ErrorOr<void> Ext2FSInode::decrement_link_count()
     if (m_raw_inode.i_links_count == 0)
         did_delete_self();
 
-    if (ref_count() == 1 && m_raw_inode.i_links_count == 0)
+    if (ref_count() == 1 + page_cache_reference_count() && m_raw_inode.i_links_count == 0) {
+        drop_page_cache();
         fs().uncache_inode(index());
+    }
 
     return {};
 }
@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/UnixTypes.h>
@@ -44,9 +45,22 @@ private:
     virtual ErrorOr<void> chown(UserID, GroupID) override;
     virtual ErrorOr<void> truncate(u64) override;
     virtual ErrorOr<int> get_block_address(int) override;
+    virtual bool is_page_cacheable() const override { return Kernel::is_regular_file(m_raw_inode.i_mode); }
+    virtual void did_read_into_page_cache(u64 offset, size_t count) const override;
 
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
+    ErrorOr<bool> write_indexed_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> populate_lookup_cache();
+
+    bool has_directory_index() const;
+    ErrorOr<ByteBuffer> read_directory_block(u32 logical_block_index) const;
+    ErrorOr<void> write_directory_block(u32 logical_block_index, ReadonlyBytes);
+    ErrorOr<u32> append_directory_block(ReadonlyBytes);
+    ErrorOr<Optional<Ext2FSDirectoryIndexPath>> probe_directory_index(StringView name) const;
+    ErrorOr<bool> advance_directory_index(Ext2FSDirectoryIndexPath&) const;
+    ErrorOr<Optional<Ext2FSDirectoryIndexMatch>> find_in_directory_index(Ext2FSDirectoryIndexPath&, StringView name) const;
+    ErrorOr<void> make_room_in_directory_index(Ext2FSDirectoryIndexPath&);
+    ErrorOr<void> add_to_directory_index(Ext2FSDirectoryIndexPath&, StringView name, InodeIndex, u8 file_type);
     ErrorOr<void> resize(u64);
     ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
     ErrorOr<void> grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
@@ -55,6 +69,13 @@ private:
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> flush_block_list();
 
+    enum class ShouldPrefetchInBackground {
+        No,
+        Yes,
+    };
+    void prefetch_logical_blocks(size_t first_logical_block, size_t end_logical_block, ShouldPrefetchInBackground) const;
+    void read_ahead(OpenFileDescription&, u64 offset, u64 count) const;
+
     ErrorOr<void> compute_block_list_with_exclusive_locking();
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
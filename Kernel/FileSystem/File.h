@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,6 +22,26 @@ namespace Kernel {
 
 class File;
 
+// A FileReadinessWatcher is told whenever the block conditions of a file are re-evaluated,
+// without having a thread blocked on the file. This is what ReadinessQueue builds on.
+class FileReadinessWatcher {
+public:
+    virtual ~FileReadinessWatcher() = default;
+
+    virtual OpenFileDescription const* watched_description() const = 0;
+
+    // Both of these are called with the FileBlockerSet lock held.
+    virtual void file_readiness_may_have_changed() = 0;
+    virtual void watched_description_will_be_destroyed() = 0;
+
+private:
+    friend class FileBlockerSet;
+    IntrusiveListNode<FileReadinessWatcher> m_watcher_list_node;
+
+public:
+    using List = IntrusiveList<&FileReadinessWatcher::m_watcher_list_node>;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
@@ -40,7 +61,46 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& watcher : m_readiness_watchers)
+            watcher.file_readiness_may_have_changed();
+    }
+
+    void add_readiness_watcher(FileReadinessWatcher& watcher)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_watchers.append(watcher);
+    }
+
+    void remove_readiness_watcher(FileReadinessWatcher& watcher)
+    {
+        SpinlockLocker lock(m_lock);
+        if (watcher.m_watcher_list_node.is_in_list())
+            m_readiness_watchers.remove(watcher);
+    }
+
+    void description_will_be_destroyed(OpenFileDescription const& description)
+    {
+        SpinlockLocker lock(m_lock);
+        for (auto it = m_readiness_watchers.begin(); it != m_readiness_watchers.end();) {
+            auto& watcher = *it;
+            ++it;
+            if (watcher.watched_description() != &description)
+                continue;
+            m_readiness_watchers.remove(watcher);
+            watcher.watched_description_will_be_destroyed();
+        }
     }
+
+    // Lets a watcher look at its description without it being destroyed underneath it.
+    template<typename Callback>
+    decltype(auto) with_readiness_watchers_locked(Callback callback)
+    {
+        SpinlockLocker lock(m_lock);
+        return callback();
+    }
+
+private:
+    FileReadinessWatcher::List m_readiness_watchers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +174,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_io_ring() const { return false; }
+    virtual bool is_readiness_queue() const { return false; }
     virtual bool is_mount_file() const { return false; }
 
     virtual bool is_regular_file() const { return false; }
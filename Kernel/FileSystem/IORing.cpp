@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::try_create(u32 entries)
+{
+    VERIFY(entries > 0 && entries <= IO_RING_MAX_ENTRIES && is_power_of_two(entries));
+
+    auto size = TRY(Memory::page_round_up(io_ring_mapping_size(entries)));
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing"sv, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) IORing(move(vmobject), move(region), entries));
+}
+
+IORing::IORing(NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region, u32 entries)
+    : m_vmobject(move(vmobject))
+    , m_region(move(region))
+    , m_submission_entries(entries)
+    , m_completion_entries(io_ring_completion_entries(entries))
+{
+    auto& ring_header = header();
+    ring_header.submission_mask = m_submission_entries - 1;
+    ring_header.submission_entries = m_submission_entries;
+    ring_header.submissions_offset = io_ring_submissions_offset();
+    ring_header.completion_mask = m_completion_entries - 1;
+    ring_header.completion_entries = m_completion_entries;
+    ring_header.completions_offset = io_ring_completions_offset(m_submission_entries);
+}
+
+IORing::~IORing() = default;
+
+ErrorOr<Optional<IORingSubmission>> IORing::pop_submission()
+{
+    VERIFY(m_enter_lock.is_exclusively_locked_by_current_thread());
+
+    auto tail = AK::atomic_load(&header().submission_tail, AK::memory_order_acquire);
+    auto pending = tail - m_submission_head;
+    if (pending == 0)
+        return Optional<IORingSubmission> {};
+    if (pending > m_submission_entries)
+        return EINVAL;
+
+    IORingSubmission submission;
+    __builtin_memcpy(&submission, &submissions()[m_submission_head & (m_submission_entries - 1)], sizeof(submission));
+    ++m_submission_head;
+    AK::atomic_store(&header().submission_head, m_submission_head, AK::memory_order_release);
+    return submission;
+}
+
+bool IORing::completion_ring_is_full() const
+{
+    auto head = AK::atomic_load(&header().completion_head, AK::memory_order_acquire);
+    // NOTE: A bogus head written by userspace makes the ring look full, which only stops processing.
+    return m_completion_tail - head >= m_completion_entries;
+}
+
+void IORing::post_completion(u64 user_data, i64 result)
+{
+    VERIFY(m_enter_lock.is_exclusively_locked_by_current_thread());
+    VERIFY(!completion_ring_is_full());
+
+    auto& completion = completions()[m_completion_tail & (m_completion_entries - 1)];
+    completion.user_data = user_data;
+    completion.result = result;
+    ++m_completion_tail;
+    AK::atomic_store(&header().completion_tail, m_completion_tail, AK::memory_order_release);
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    if (!shared)
+        return EINVAL;
+    if (offset != 0 || range.size() > m_vmobject->size())
+        return EINVAL;
+
+    return m_vmobject;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create(":io-ring:"sv);
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+// The kernel side of an I/O ring. The ring memory is mapped into the kernel once, and handed out
+// to userspace via mmap() on the file descriptor returned by sys$io_ring_create.
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<IORing>> try_create(u32 entries);
+
+    virtual ~IORing() override;
+
+    Mutex& enter_lock() { return m_enter_lock; }
+
+    // Returns the next pending submission, or an empty Optional if userspace has not queued any more.
+    // The submission is copied out of shared memory, so it can be validated without userspace racing us.
+    ErrorOr<Optional<IORingSubmission>> pop_submission();
+
+    bool completion_ring_is_full() const;
+    void post_completion(u64 user_data, i64 result);
+
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+private:
+    virtual bool is_io_ring() const override { return true; }
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual bool can_read(OpenFileDescription const&, u64) const override { return false; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return ENOTSUP; }
+
+    IORing(NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>, u32 entries);
+
+    IORingHeader& header() const { return *reinterpret_cast<IORingHeader*>(m_region->vaddr().as_ptr()); }
+    IORingSubmission const* submissions() const { return reinterpret_cast<IORingSubmission const*>(m_region->vaddr().offset(io_ring_submissions_offset()).as_ptr()); }
+    IORingCompletion* completions() const { return reinterpret_cast<IORingCompletion*>(m_region->vaddr().offset(io_ring_completions_offset(m_submission_entries)).as_ptr()); }
+
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+
+    Mutex m_enter_lock { "IORing"sv };
+
+    // The ring geometry and the kernel-owned indices are kept here as well, since userspace
+    // can scribble over everything in the shared header.
+    u32 const m_submission_entries { 0 };
+    u32 const m_completion_entries { 0 };
+    u32 m_submission_head { 0 };
+    u32 m_completion_tail { 0 };
+};
+
+}
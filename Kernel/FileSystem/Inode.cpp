@@ -268,6 +268,73 @@ LockRefPtr<Memory::SharedInodeVMObject> Inode::shared_vmobject() const
     return m_shared_vmobject.strong_ref();
 }
 
+ErrorOr<LockRefPtr<Memory::SharedInodeVMObject>> Inode::page_cache()
+{
+    if (!is_page_cacheable())
+        return nullptr;
+    auto inode_size = size();
+    if (inode_size == 0)
+        return nullptr;
+
+    m_page_cache_idle_syncs.store(0, AK::MemoryOrder::memory_order_relaxed);
+
+    MutexLocker locker(m_page_cache_lock);
+    if (!m_page_cache) {
+        m_page_cache = TRY(Memory::SharedInodeVMObject::try_create_with_inode(*this));
+    } else if (m_page_cache->size() < inode_size && m_page_cache->ref_count() == 1) {
+        // The inode has grown since we created the cache. Nobody else is looking at the cache right now,
+        // so we can replace it with a bigger one that takes over all the pages we already have.
+        m_page_cache = TRY(m_page_cache->try_create_grown_copy(inode_size));
+    }
+    return m_page_cache;
+}
+
+void Inode::update_page_cache_after_write(u64 offset, size_t count)
+{
+    // NOTE: Holding the lock keeps concurrent writers from installing their view of the inode out of order.
+    MutexLocker locker(m_page_cache_lock);
+    if (auto vmobject = shared_vmobject())
+        vmobject->did_write_bytes(offset, count);
+}
+
+void Inode::update_page_cache_after_truncate(u64 new_size)
+{
+    MutexLocker locker(m_page_cache_lock);
+    if (auto vmobject = shared_vmobject())
+        vmobject->did_truncate(new_size);
+}
+
+void Inode::drop_page_cache()
+{
+    LockRefPtr<Memory::SharedInodeVMObject> page_cache;
+    {
+        MutexLocker locker(m_page_cache_lock);
+        page_cache = move(m_page_cache);
+    }
+    // NOTE: This may drop the last reference to ourselves, so the VMObject has to be destroyed after unlocking.
+}
+
+size_t Inode::page_cache_reference_count() const
+{
+    MutexLocker locker(m_page_cache_lock);
+    // If anyone else is holding on to the VMObject, its reference to us isn't ours to give up.
+    if (m_page_cache && m_page_cache->ref_count() == 1)
+        return 1;
+    return 0;
+}
+
+bool Inode::has_cached_pages() const
+{
+    MutexLocker locker(m_page_cache_lock);
+    return m_page_cache && (m_page_cache->amount_clean() + m_page_cache->amount_dirty()) > 0;
+}
+
+bool Inode::age_page_cache()
+{
+    static constexpr u32 maximum_idle_syncs = 30;
+    return m_page_cache_idle_syncs.fetch_add(1, AK::MemoryOrder::memory_order_relaxed) + 1 >= maximum_idle_syncs;
+}
+
 template<typename T>
 static inline bool range_overlap(T start1, T len1, T start2, T len2)
 {
@@ -93,6 +93,24 @@ public:
     ErrorOr<void> set_shared_vmobject(Memory::SharedInodeVMObject&);
     LockRefPtr<Memory::SharedInodeVMObject> shared_vmobject() const;
 
+    // Inodes that opt into page caching keep their shared VMObject alive while they are alive,
+    // and InodeFile reads through it, so read(), write() and shared mappings all see the same pages.
+    // Since the VMObject keeps the inode alive in turn, the filesystem has to drop_page_cache()
+    // before it lets go of the inode.
+    virtual bool is_page_cacheable() const { return false; }
+    ErrorOr<LockRefPtr<Memory::SharedInodeVMObject>> page_cache();
+    void update_page_cache_after_write(u64 offset, size_t count);
+    void update_page_cache_after_truncate(u64 new_size);
+    void drop_page_cache();
+    // How many references to this inode would go away by calling drop_page_cache().
+    size_t page_cache_reference_count() const;
+    bool has_cached_pages() const;
+    // Called once per sync by filesystems that keep unreferenced inodes around for their page cache.
+    // Returns true once the page cache has gone unused for long enough that it isn't worth keeping.
+    bool age_page_cache();
+    // Called after the given range was read into the page cache, so other caches can let go of it.
+    virtual void did_read_into_page_cache(u64, size_t) const { }
+
     static void sync_all();
     void sync();
 
@@ -130,6 +148,9 @@ private:
     FileSystem& m_file_system;
     InodeIndex m_index { 0 };
     LockWeakPtr<Memory::SharedInodeVMObject> m_shared_vmobject;
+    mutable Mutex m_page_cache_lock { "InodePageCache"sv };
+    LockRefPtr<Memory::SharedInodeVMObject> m_page_cache;
+    Atomic<u32> m_page_cache_idle_syncs { 0 };
     LockWeakPtr<LocalSocket> m_bound_socket;
     SpinlockProtected<HashTable<InodeWatcher*>, LockRank::None> m_watchers {};
     bool m_metadata_dirty { false };
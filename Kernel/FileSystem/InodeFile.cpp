@@ -29,7 +29,11 @@ ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, Us
     if (Checked<off_t>::addition_would_overflow(offset, count))
         return EOVERFLOW;
 
-    auto nread = TRY(m_inode->read_bytes(offset, count, buffer, &description));
+    size_t nread = 0;
+    if (auto page_cache = TRY(m_inode->page_cache()))
+        nread = TRY(page_cache->read_bytes(offset, count, buffer, &description));
+    else
+        nread = TRY(m_inode->read_bytes(offset, count, buffer, &description));
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
         evaluate_block_conditions();
@@ -44,6 +48,7 @@ ErrorOr<size_t> InodeFile::write(OpenFileDescription& description, u64 offset, U
 
     size_t nwritten = TRY(m_inode->write_bytes(offset, count, data, &description));
     if (nwritten > 0) {
+        m_inode->update_page_cache_after_write(offset, nwritten);
         auto mtime_result = m_inode->update_timestamps({}, {}, kgettimeofday());
         Thread::current()->did_file_write(nwritten);
         evaluate_block_conditions();
@@ -96,6 +101,7 @@ ErrorOr<NonnullOwnPtr<KString>> InodeFile::pseudo_path(OpenFileDescription const
 ErrorOr<void> InodeFile::truncate(u64 size)
 {
     TRY(m_inode->truncate(size));
+    m_inode->update_page_cache_after_truncate(size);
     TRY(m_inode->update_timestamps({}, {}, kgettimeofday()));
     return {};
 }
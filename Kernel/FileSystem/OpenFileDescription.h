@@ -124,6 +124,19 @@ public:
 
     off_t offset() const;
 
+    // Per-description bookkeeping that lets file systems detect sequential reads and issue read-ahead.
+    struct ReadAheadState {
+        u64 next_offset { 0 };
+        u64 read_ahead_end { 0 };
+        u64 window_size { 0 };
+    };
+
+    template<typename Callback>
+    decltype(auto) with_read_ahead_state(Callback callback)
+    {
+        return m_state.with([&](auto& state) { return callback(state.read_ahead); });
+    }
+
     ErrorOr<void> chown(Credentials const& credentials, UserID, GroupID);
 
     FileBlockerSet& blocker_set();
@@ -157,6 +170,7 @@ private:
         bool should_append : 1 { false };
         bool direct : 1 { false };
         FIFO::Direction fifo_direction : 2 { FIFO::Direction::Neither };
+        ReadAheadState read_ahead;
     };
 
     SpinlockProtected<State, LockRank::None> m_state {};
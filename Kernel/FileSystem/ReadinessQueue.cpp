@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FileSystem/ReadinessQueue.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    auto block_flags = BlockFlags::None;
+    if (events & POLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & POLLOUT)
+        block_flags |= BlockFlags::Write;
+    return block_flags;
+}
+
+static u32 events_for_block_flags(BlockFlags block_flags)
+{
+    u32 events = 0;
+    if (has_flag(block_flags, BlockFlags::Read))
+        events |= POLLIN;
+    if (has_flag(block_flags, BlockFlags::Write))
+        events |= POLLOUT;
+    return events;
+}
+
+ErrorOr<NonnullRefPtr<ReadinessQueue>> ReadinessQueue::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) ReadinessQueue);
+}
+
+ReadinessQueue::~ReadinessQueue()
+{
+    for (auto& it : m_entries) {
+        auto& entry = *it.value;
+        entry.blocker_set().remove_readiness_watcher(entry);
+        SpinlockLocker lock(m_ready_lock);
+        if (entry.m_ready_list_node.is_in_list())
+            m_ready_list.remove(entry);
+    }
+}
+
+ReadinessQueue::Entry::Entry(ReadinessQueue& queue, OpenFileDescription& description, u32 events, u64 user_data)
+    : m_queue(queue)
+    , m_file(description.file())
+    , m_description(&description)
+    , m_events(events)
+    , m_user_data(user_data)
+{
+}
+
+void ReadinessQueue::Entry::file_readiness_may_have_changed()
+{
+    m_queue.mark_ready(*this);
+}
+
+void ReadinessQueue::Entry::watched_description_will_be_destroyed()
+{
+    m_description = nullptr;
+    SpinlockLocker lock(m_queue.m_ready_lock);
+    if (m_ready_list_node.is_in_list())
+        m_queue.m_ready_list.remove(*this);
+}
+
+void ReadinessQueue::mark_ready(Entry& entry)
+{
+    {
+        SpinlockLocker lock(m_ready_lock);
+        if (entry.m_ready_list_node.is_in_list())
+            return;
+        m_ready_list.append(entry);
+    }
+    evaluate_block_conditions();
+}
+
+void ReadinessQueue::remove_entry(Entry& entry)
+{
+    VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+    entry.blocker_set().remove_readiness_watcher(entry);
+    {
+        SpinlockLocker lock(m_ready_lock);
+        if (entry.m_ready_list_node.is_in_list())
+            m_ready_list.remove(entry);
+    }
+}
+
+ErrorOr<void> ReadinessQueue::add(int fd, OpenFileDescription& description, u32 events, u64 user_data)
+{
+    // NOTE: Queues can't watch each other, since that would have us re-enter a FileBlockerSet we are notified from.
+    if (description.file().is_readiness_queue())
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (auto it = m_entries.find(fd); it != m_entries.end()) {
+        auto& existing_entry = *it->value;
+        bool is_same_description = existing_entry.blocker_set().with_readiness_watchers_locked([&] {
+            return existing_entry.m_description == &description;
+        });
+        if (is_same_description)
+            return EEXIST;
+        // The descriptor this entry was created for has been closed (and the fd possibly reused).
+        remove_entry(existing_entry);
+        m_entries.remove(it);
+    }
+
+    auto entry = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Entry(*this, description, events, user_data)));
+    auto& entry_ref = *entry;
+    TRY(m_entries.try_set(fd, move(entry)));
+    entry_ref.blocker_set().add_readiness_watcher(entry_ref);
+
+    // The descriptor may already be ready, so have the next collection look at it.
+    mark_ready(entry_ref);
+    return {};
+}
+
+ErrorOr<void> ReadinessQueue::modify(int fd, OpenFileDescription& description, u32 events, u64 user_data)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+    auto& entry = *it->value;
+    bool is_same_description = entry.blocker_set().with_readiness_watchers_locked([&] {
+        return entry.m_description == &description;
+    });
+    if (!is_same_description)
+        return ENOENT;
+
+    entry.m_events = events;
+    entry.m_user_data = user_data;
+    mark_ready(entry);
+    return {};
+}
+
+ErrorOr<void> ReadinessQueue::remove(int fd)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+    remove_entry(*it->value);
+    m_entries.remove(it);
+    return {};
+}
+
+ErrorOr<size_t> ReadinessQueue::collect_ready_events(Span<ReadinessEvent> events)
+{
+    MutexLocker locker(m_lock);
+
+    Entry::ReadyList reported;
+    size_t count = 0;
+    // Entries can be put back on the ready list by notifications while we are looking at them,
+    // so make sure we don't keep spinning on an entry that keeps getting notified but never becomes ready.
+    size_t remaining_attempts = m_entries.size() + events.size();
+    while (count < events.size() && remaining_attempts-- > 0) {
+        Entry* entry = nullptr;
+        {
+            SpinlockLocker lock(m_ready_lock);
+            entry = m_ready_list.take_first();
+        }
+        if (!entry)
+            break;
+
+        auto block_flags = block_flags_for_events(entry->m_events);
+        auto unblocked_flags = entry->blocker_set().with_readiness_watchers_locked([&] {
+            if (!entry->m_description || block_flags == BlockFlags::None)
+                return BlockFlags::None;
+            return entry->m_description->should_unblock(block_flags);
+        });
+        if (unblocked_flags == BlockFlags::None)
+            continue;
+
+        events[count++] = { .user_data = entry->m_user_data, .events = events_for_block_flags(unblocked_flags), .reserved = 0 };
+
+        SpinlockLocker lock(m_ready_lock);
+        if (!entry->m_ready_list_node.is_in_list())
+            reported.append(*entry);
+    }
+
+    // Since readiness is level-triggered, everything we reported has to be looked at again next time.
+    SpinlockLocker lock(m_ready_lock);
+    while (auto* entry = reported.take_first())
+        m_ready_list.append(*entry);
+
+    return count;
+}
+
+bool ReadinessQueue::can_read(OpenFileDescription const&, u64) const
+{
+    SpinlockLocker lock(m_ready_lock);
+    return !m_ready_list.is_empty();
+}
+
+ErrorOr<NonnullOwnPtr<KString>> ReadinessQueue::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create(":readiness-queue:"sv);
+}
+
+}
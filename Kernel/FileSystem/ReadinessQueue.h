@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/ReadinessQueue.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+// The kernel side of sys$readiness_queue_*. Every registered descriptor gets an Entry that watches
+// the block conditions of its file. Entries whose file may have become ready are put on a ready list,
+// so collecting events only has to look at those instead of every registered descriptor.
+// Readiness is level-triggered: a descriptor is reported again until it is no longer ready.
+class ReadinessQueue final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<ReadinessQueue>> try_create();
+
+    virtual ~ReadinessQueue() override;
+
+    ErrorOr<void> add(int fd, OpenFileDescription&, u32 events, u64 user_data);
+    ErrorOr<void> modify(int fd, OpenFileDescription&, u32 events, u64 user_data);
+    ErrorOr<void> remove(int fd);
+
+    // Fills `events` with descriptors that are ready right now and returns how many were filled in.
+    ErrorOr<size_t> collect_ready_events(Span<ReadinessEvent> events);
+
+private:
+    class Entry final : public FileReadinessWatcher {
+    public:
+        Entry(ReadinessQueue&, OpenFileDescription&, u32 events, u64 user_data);
+
+        virtual OpenFileDescription const* watched_description() const override { return m_description; }
+        virtual void file_readiness_may_have_changed() override;
+        virtual void watched_description_will_be_destroyed() override;
+
+        FileBlockerSet& blocker_set() { return m_file->blocker_set(); }
+
+        ReadinessQueue& m_queue;
+        // Keeps the FileBlockerSet we are registered with alive, but not the description itself,
+        // so closing the last descriptor still closes the file.
+        NonnullRefPtr<File> m_file;
+        // Guarded by the lock of blocker_set(). Cleared when the description goes away.
+        OpenFileDescription* m_description { nullptr };
+        u32 m_events { 0 };
+        u64 m_user_data { 0 };
+
+        IntrusiveListNode<Entry> m_ready_list_node;
+        using ReadyList = IntrusiveList<&Entry::m_ready_list_node>;
+    };
+
+    ReadinessQueue() = default;
+
+    virtual StringView class_name() const override { return "ReadinessQueue"sv; }
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return ENOTSUP; }
+    virtual bool is_readiness_queue() const override { return true; }
+
+    void mark_ready(Entry&);
+    void remove_entry(Entry&);
+
+    Mutex m_lock { "ReadinessQueue"sv };
+    HashMap<int, NonnullOwnPtr<Entry>> m_entries;
+
+    mutable Spinlock<LockRank::None> m_ready_lock {};
+    Entry::ReadyList m_ready_list;
+};
+
+}
@@ -4,9 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/JsonObjectSerializer.h>
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Devices/Storage/DeviceAttribute.h>
+#include <Kernel/Library/KBufferBuilder.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -20,6 +22,8 @@ StringView StorageDeviceAttributeSysFSComponent::name() const
         return "sector_size"sv;
     case Type::CommandSet:
         return "command_set"sv;
+    case Type::RequestQueue:
+        return "request_queue"sv;
     default:
         VERIFY_NOT_REACHED();
     }
@@ -49,6 +53,39 @@ ErrorOr<size_t> StorageDeviceAttributeSysFSComponent::read_bytes(off_t offset, s
     return nread;
 }
 
+static ErrorOr<void> add_direction_statistics(JsonObjectSerializer<KBufferBuilder>& json, StringView name, StorageRequestQueue::DirectionStatistics const& statistics)
+{
+    auto object = TRY(json.add_object(name));
+    TRY(object.add("submitted"sv, statistics.submitted));
+    TRY(object.add("merged"sv, statistics.merged));
+    TRY(object.add("dispatched"sv, statistics.dispatched));
+    TRY(object.add("completed"sv, statistics.completed));
+    TRY(object.add("deadline_expired"sv, statistics.deadline_expired));
+    TRY(object.add("total_latency_ns"sv, statistics.total_latency_ns));
+    TRY(object.add("max_latency_ns"sv, statistics.max_latency_ns));
+    TRY(object.finish());
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_generate_request_queue_buffer() const
+{
+    auto statistics = m_device->request_queue_statistics();
+
+    auto builder = TRY(KBufferBuilder::try_create());
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(add_direction_statistics(json, "reads"sv, statistics.reads));
+    TRY(add_direction_statistics(json, "writes"sv, statistics.writes));
+    TRY(json.add("plugs"sv, statistics.plugs));
+    TRY(json.add("pending"sv, statistics.pending));
+    TRY(json.add("max_pending"sv, statistics.max_pending));
+    TRY(json.finish());
+
+    auto buffer = builder.build();
+    if (!buffer)
+        return ENOMEM;
+    return buffer.release_nonnull();
+}
+
 ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_generate_buffer() const
 {
     OwnPtr<KString> value;
@@ -62,6 +99,8 @@ ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_gen
     case Type::CommandSet:
         value = TRY(KString::formatted("{}", m_device->command_set_to_string_view()));
         break;
+    case Type::RequestQueue:
+        return try_to_generate_request_queue_buffer();
     default:
         VERIFY_NOT_REACHED();
     }
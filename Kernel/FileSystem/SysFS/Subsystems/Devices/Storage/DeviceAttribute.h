@@ -18,6 +18,7 @@ public:
         EndLBA,
         SectorSize,
         CommandSet,
+        RequestQueue,
     };
 
 public:
@@ -30,6 +31,7 @@ public:
 
 protected:
     ErrorOr<NonnullOwnPtr<KBuffer>> try_to_generate_buffer() const;
+    ErrorOr<NonnullOwnPtr<KBuffer>> try_to_generate_request_queue_buffer() const;
     StorageDeviceAttributeSysFSComponent(StorageDeviceSysFSDirectory const& device, Type);
     NonnullRefPtr<StorageDevice> m_device;
     Type const m_type { Type::EndLBA };
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Kmalloc.h>
+#include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSKmallocStatistics::SysFSKmallocStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSKmallocStatistics> SysFSKmallocStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSKmallocStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSKmallocStatistics::try_generate(KBufferBuilder& builder)
+{
+    kmalloc_stats stats;
+    get_kmalloc_stats(stats);
+
+    kmalloc_slabheap_stats slabheap_stats[KMALLOC_SLABHEAP_COUNT];
+    get_kmalloc_slabheap_stats(slabheap_stats);
+
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("bytes_allocated"sv, stats.bytes_allocated));
+    TRY(json.add("bytes_free"sv, stats.bytes_free));
+    TRY(json.add("bytes_in_processor_caches"sv, stats.bytes_in_processor_caches));
+    TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
+    TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+
+    auto slabheaps = TRY(json.add_array("slabheaps"sv));
+    for (auto const& slabheap : slabheap_stats) {
+        auto slabheap_object = TRY(slabheaps.add_object());
+        TRY(slabheap_object.add("slab_size"sv, slabheap.slab_size));
+        TRY(slabheap_object.add("bytes_allocated"sv, slabheap.bytes_allocated));
+        TRY(slabheap_object.add("bytes_free"sv, slabheap.bytes_free));
+        TRY(slabheap_object.add("bytes_in_processor_caches"sv, slabheap.bytes_in_processor_caches));
+        TRY(slabheap_object.add("processor_cache_allocations"sv, slabheap.processor_cache_allocations));
+        TRY(slabheap_object.add("processor_cache_frees"sv, slabheap.processor_cache_frees));
+        TRY(slabheap_object.add("processor_cache_refills"sv, slabheap.processor_cache_refills));
+        TRY(slabheap_object.add("processor_cache_flushes"sv, slabheap.processor_cache_flushes));
+        TRY(slabheap_object.finish());
+    }
+    TRY(slabheaps.finish());
+
+    TRY(json.finish());
+    return {};
+}
+
+}
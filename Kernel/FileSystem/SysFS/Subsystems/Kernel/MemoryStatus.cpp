@@ -8,6 +8,8 @@
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MemoryStatus.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Tasks/MemoryPressureTask.h>
+#include <Kernel/Tasks/PageMergeTask.h>
 
 namespace Kernel {
 
@@ -27,6 +29,7 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     get_kmalloc_stats(stats);
 
     auto system_memory = MM.get_system_memory_info();
+    auto page_merging = PageMergeTask::statistics();
 
     auto json = TRY(JsonObjectSerializer<>::try_create(builder));
     TRY(json.add("kmalloc_allocated"sv, stats.bytes_allocated));
@@ -35,6 +38,14 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_available"sv, system_memory.physical_pages - system_memory.physical_pages_used));
     TRY(json.add("physical_committed"sv, system_memory.physical_pages_committed));
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
+    TRY(json.add("large_pages_mapped"sv, system_memory.large_pages_mapped));
+    TRY(json.add("large_page_allocations"sv, system_memory.large_page_allocations));
+    TRY(json.add("large_page_splits"sv, system_memory.large_page_splits));
+    TRY(json.add("same_page_merging_full_scans"sv, page_merging.full_scans));
+    TRY(json.add("same_page_merging_pages_merged"sv, page_merging.pages_merged));
+    TRY(json.add("same_page_merging_pages_sharing"sv, page_merging.pages_sharing));
+    TRY(json.add("memory_pressure_level"sv, to_underlying(MemoryPressureTask::level())));
+    TRY(json.add("memory_pressure_pages_purged"sv, MemoryPressureTask::pages_purged()));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
     TRY(json.finish());
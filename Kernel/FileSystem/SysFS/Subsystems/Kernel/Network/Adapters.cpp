@@ -44,6 +44,12 @@ ErrorOr<void> SysFSNetworkAdaptersStats::try_generate(KBufferBuilder& builder)
         TRY(obj.add("link_speed"sv, adapter.link_speed()));
         TRY(obj.add("link_full_duplex"sv, adapter.link_full_duplex()));
         TRY(obj.add("mtu"sv, adapter.mtu()));
+        auto const& poll_statistics = adapter.receive_poll_statistics();
+        TRY(obj.add("receive_interrupts"sv, poll_statistics.interrupts));
+        TRY(obj.add("receive_polls"sv, poll_statistics.polls));
+        TRY(obj.add("receive_polled_packets"sv, poll_statistics.polled_packets));
+        TRY(obj.add("receive_max_batch_size"sv, poll_statistics.max_batch_size));
+        TRY(obj.add("receive_poll_budget_exhausted"sv, poll_statistics.budget_exhausted));
         TRY(obj.finish());
         return {};
     }));
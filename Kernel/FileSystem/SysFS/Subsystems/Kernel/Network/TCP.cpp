@@ -41,6 +41,17 @@ ErrorOr<void> SysFSNetworkTCPStats::try_generate(KBufferBuilder& builder)
         TRY(obj.add("bytes_in"sv, socket.bytes_in()));
         TRY(obj.add("packets_out"sv, socket.packets_out()));
         TRY(obj.add("bytes_out"sv, socket.bytes_out()));
+        TRY(obj.add("retransmits"sv, socket.retransmits()));
+        TRY(obj.add("fast_retransmits"sv, socket.fast_retransmits()));
+        auto congestion_control = socket.congestion_control_state();
+        TRY(obj.add("congestion_control"sv, congestion_control.name));
+        TRY(obj.add("congestion_window"sv, congestion_control.congestion_window));
+        TRY(obj.add("slow_start_threshold"sv, congestion_control.slow_start_threshold));
+        TRY(obj.add("maximum_segment_size"sv, congestion_control.maximum_segment_size));
+        auto& round_trip_time_estimator = socket.round_trip_time_estimator();
+        TRY(obj.add("smoothed_rtt_us"sv, round_trip_time_estimator.smoothed_round_trip_time().to_microseconds()));
+        TRY(obj.add("rtt_variance_us"sv, round_trip_time_estimator.round_trip_time_variance().to_microseconds()));
+        TRY(obj.add("retransmission_timeout_ms"sv, round_trip_time_estimator.retransmission_timeout().to_milliseconds()));
         auto current_process_credentials = Process::current().credentials();
         if (current_process_credentials->is_superuser() || current_process_credentials->uid() == socket.origin_uid()) {
             TRY(obj.add("origin_pid"sv, socket.origin_pid().value()));
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Variables/SamePageMerging.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PageMergeTask.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSSamePageMerging::SysFSSamePageMerging(SysFSDirectory const& parent_directory)
+    : SysFSSystemBooleanVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSSamePageMerging> SysFSSamePageMerging::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSSamePageMerging(parent_directory)).release_nonnull();
+}
+
+bool SysFSSamePageMerging::value() const
+{
+    return PageMergeTask::is_enabled();
+}
+
+void SysFSSamePageMerging::set_value(bool new_value)
+{
+    PageMergeTask::set_enabled(new_value);
+}
+
+}
@@ -530,6 +530,7 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> VirtualFileSystem::open(Process cons
 
     if (should_truncate_file) {
         TRY(inode.truncate(0));
+        inode.update_page_cache_after_truncate(0);
         TRY(inode.update_timestamps({}, {}, kgettimeofday()));
     }
     auto description = TRY(OpenFileDescription::try_create(custody));
@@ -20,6 +20,7 @@ class Credentials;
 class Custody;
 class Device;
 class DiskCache;
+class DiskCacheShard;
 class DoubleBuffer;
 class File;
 class FATInode;
@@ -40,6 +41,7 @@ class Mutex;
 class MasterPTY;
 class Mount;
 class PerformanceEventBuffer;
+class PipeBuffer;
 class ProcFS;
 class ProcFSInode;
 class Process;
@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -149,7 +150,12 @@ public:
     void deallocate(void* ptr)
     {
         memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
+        deallocate_scrubbed(ptr);
+    }
 
+    // For slabs that have already been scrubbed, i.e. the ones coming back from a processor cache.
+    void deallocate_scrubbed(void* ptr)
+    {
         auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
@@ -205,6 +211,8 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+static void flush_current_processor_cache();
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -239,6 +247,9 @@ struct KmallocGlobalData {
         if (size <= KmallocSlabBlock::block_size * 2 + sizeof(ptrdiff_t) + sizeof(size_t)) {
             // FIXME: We should propagate a freed pointer, to find the specific subheap it belonged to
             //        This would save us iterating over them in the next step and remove a recursion
+            // Slabs sitting in our processor cache keep their blocks alive, so give them back first.
+            // FIXME: We can't get at the caches of other processors from here.
+            flush_current_processor_cache();
             bool did_purge = false;
             for (auto& slabheap : slabheaps) {
                 if (slabheap.try_purge()) {
@@ -394,11 +405,45 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
 
+// Every processor keeps a magazine of free slabs for each slabheap in front of the global heap, so that
+// most small allocations and frees only have to disable interrupts instead of taking the kmalloc lock.
+// A slab can be freed into the magazine of any processor, no matter which one allocated it; magazines
+// that run empty or full exchange half of their capacity with the slabheap.
+struct KmallocProcessorCache {
+    static ProcessorSpecificDataID processor_specific_data_id() { return ProcessorSpecificDataID::KmallocProcessorCache; }
+
+    struct Magazine {
+        static constexpr size_t capacity = 32;
+        static constexpr size_t batch_size = capacity / 2;
+
+        size_t count { 0 };
+        void* slabs[capacity];
+
+        // Statistics, only ever updated by the owning processor.
+        size_t allocations { 0 };
+        size_t frees { 0 };
+        size_t refills { 0 };
+        size_t flushes { 0 };
+    };
+
+    Magazine magazines[KMALLOC_SLABHEAP_COUNT];
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+};
+
+static KmallocProcessorCache* current_processor_cache()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    if (!Processor::is_initialized())
+        return nullptr;
+    return Processor::current().get_specific<KmallocProcessorCache>();
+}
+
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
@@ -421,26 +466,111 @@ UNMAP_AFTER_INIT void kmalloc_init()
     s_lock.initialize();
 }
 
-static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+UNMAP_AFTER_INIT void kmalloc_enable_processor_cache()
 {
-    // Catch bad callers allocating under spinlock.
-    if constexpr (KMALLOC_VERIFY_NO_SPINLOCK_HELD) {
-        Processor::verify_no_spinlocks_held();
+    ProcessorSpecific<KmallocProcessorCache>::initialize();
+}
+
+static Optional<size_t> slabheap_index_for_allocation(size_t size, size_t alignment)
+{
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        auto slab_size = g_kmalloc_global->slabheaps[i].slab_size();
+        if (size <= slab_size && alignment <= slab_size)
+            return i;
     }
+    return {};
+}
 
-    // Alignment must be a power of two.
-    VERIFY(is_power_of_two(alignment));
+static Optional<size_t> slabheap_index_for_deallocation(size_t size)
+{
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        if (size <= g_kmalloc_global->slabheaps[i].slab_size())
+            return i;
+    }
+    return {};
+}
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+static void* try_allocate_from_processor_cache(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    auto slabheap_index = slabheap_index_for_allocation(size, alignment);
+    if (!slabheap_index.has_value())
+        return nullptr;
 
-    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
-        dbgln("kmalloc({})", size);
-        Kernel::dump_backtrace();
+    InterruptDisabler disabler;
+    auto* cache = current_processor_cache();
+    if (!cache)
+        return nullptr;
+
+    auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+    auto& magazine = cache->magazines[*slabheap_index];
+    if (magazine.count == 0) {
+        SpinlockLocker lock(s_lock);
+        while (magazine.count < KmallocProcessorCache::Magazine::batch_size) {
+            auto* slab = slabheap.allocate(CallerWillInitializeMemory::Yes);
+            if (!slab)
+                break;
+            magazine.slabs[magazine.count++] = slab;
+        }
+        ++magazine.refills;
+        // If we couldn't get anything, leave it to the global heap to try harder.
+        if (magazine.count == 0)
+            return nullptr;
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    auto* ptr = magazine.slabs[--magazine.count];
+    ++magazine.allocations;
+    ++cache->kmalloc_call_count;
+
+    if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+    return ptr;
+}
+
+static bool try_deallocate_to_processor_cache(void* ptr, size_t size)
+{
+    auto slabheap_index = slabheap_index_for_deallocation(size);
+    if (!slabheap_index.has_value())
+        return false;
+
+    InterruptDisabler disabler;
+    auto* cache = current_processor_cache();
+    if (!cache)
+        return false;
+
+    auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+    auto& magazine = cache->magazines[*slabheap_index];
+    memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+
+    if (magazine.count == KmallocProcessorCache::Magazine::capacity) {
+        SpinlockLocker lock(s_lock);
+        for (size_t i = 0; i < KmallocProcessorCache::Magazine::batch_size; ++i)
+            slabheap.deallocate_scrubbed(magazine.slabs[--magazine.count]);
+        ++magazine.flushes;
+    }
+
+    magazine.slabs[magazine.count++] = ptr;
+    ++magazine.frees;
+    ++cache->kfree_call_count;
+    return true;
+}
+
+static void flush_current_processor_cache()
+{
+    VERIFY(s_lock.is_locked_by_current_processor());
+    auto* cache = current_processor_cache();
+    if (!cache)
+        return;
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        auto& magazine = cache->magazines[i];
+        if (magazine.count > 0)
+            ++magazine.flushes;
+        while (magazine.count > 0)
+            g_kmalloc_global->slabheaps[i].deallocate_scrubbed(magazine.slabs[--magazine.count]);
+    }
+}
 
+static void add_kmalloc_perf_event(size_t size, void* ptr)
+{
     Thread* current_thread = Thread::current();
     if (!current_thread)
         current_thread = Processor::idle_thread();
@@ -450,7 +580,34 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
         VERIFY(current_thread->is_allocation_enabled());
         PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
     }
+}
+
+static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    // Catch bad callers allocating under spinlock.
+    if constexpr (KMALLOC_VERIFY_NO_SPINLOCK_HELD) {
+        Processor::verify_no_spinlocks_held();
+    }
+
+    // Alignment must be a power of two.
+    VERIFY(is_power_of_two(alignment));
+
+    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+        SpinlockLocker lock(s_lock);
+        dbgln("kmalloc({})", size);
+        Kernel::dump_backtrace();
+    }
+
+    if (auto* ptr = try_allocate_from_processor_cache(size, alignment, caller_will_initialize_memory)) {
+        add_kmalloc_perf_event(size, ptr);
+        return ptr;
+    }
 
+    SpinlockLocker lock(s_lock);
+    ++g_kmalloc_call_count;
+
+    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    add_kmalloc_perf_event(size, ptr);
     return ptr;
 }
 
@@ -482,6 +639,18 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    // NOTE: Freeing to the processor cache never recurses into kfree, so there is no nesting to keep track of.
+    if (try_deallocate_to_processor_cache(ptr, size)) {
+        Thread* current_thread = Thread::current();
+        if (!current_thread)
+            current_thread = Processor::idle_thread();
+        if (current_thread) {
+            VERIFY(current_thread->is_allocation_enabled());
+            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+        }
+        return;
+    }
+
     SpinlockLocker lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
@@ -579,11 +748,61 @@ void operator delete[](void* ptr, size_t size) noexcept
     return kfree_sized(ptr, size);
 }
 
+template<typename Callback>
+static void for_each_processor_cache(Callback callback)
+{
+    // NOTE: The caches of other processors keep changing under us, so the results are only a snapshot.
+    Processor::for_each([&](Processor& processor) {
+        if (auto* cache = processor.get_specific<KmallocProcessorCache>())
+            callback(*cache);
+    });
+}
+
 void get_kmalloc_stats(kmalloc_stats& stats)
 {
     SpinlockLocker lock(s_lock);
-    stats.bytes_allocated = g_kmalloc_global->allocated_bytes();
-    stats.bytes_free = g_kmalloc_global->free_bytes();
+    stats.bytes_in_processor_caches = 0;
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    for_each_processor_cache([&](KmallocProcessorCache const& cache) {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i)
+            stats.bytes_in_processor_caches += cache.magazines[i].count * g_kmalloc_global->slabheaps[i].slab_size();
+        stats.kmalloc_call_count += cache.kmalloc_call_count;
+        stats.kfree_call_count += cache.kfree_call_count;
+    });
+    // Slabs in processor caches are allocated as far as the slabheaps are concerned, but they are free to use.
+    stats.bytes_allocated = g_kmalloc_global->allocated_bytes() - stats.bytes_in_processor_caches;
+    stats.bytes_free = g_kmalloc_global->free_bytes() + stats.bytes_in_processor_caches;
+}
+
+void get_kmalloc_slabheap_stats(kmalloc_slabheap_stats (&stats)[KMALLOC_SLABHEAP_COUNT])
+{
+    SpinlockLocker lock(s_lock);
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        auto const& slabheap = g_kmalloc_global->slabheaps[i];
+        stats[i] = {
+            .slab_size = slabheap.slab_size(),
+            .bytes_allocated = slabheap.allocated_bytes(),
+            .bytes_free = slabheap.free_bytes(),
+            .bytes_in_processor_caches = 0,
+            .processor_cache_allocations = 0,
+            .processor_cache_frees = 0,
+            .processor_cache_refills = 0,
+            .processor_cache_flushes = 0,
+        };
+    }
+    for_each_processor_cache([&](KmallocProcessorCache const& cache) {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            auto const& magazine = cache.magazines[i];
+            stats[i].bytes_in_processor_caches += magazine.count * stats[i].slab_size;
+            stats[i].processor_cache_allocations += magazine.allocations;
+            stats[i].processor_cache_frees += magazine.frees;
+            stats[i].processor_cache_refills += magazine.refills;
+            stats[i].processor_cache_flushes += magazine.flushes;
+        }
+    });
+    for (auto& slabheap_stats : stats) {
+        slabheap_stats.bytes_allocated -= slabheap_stats.bytes_in_processor_caches;
+        slabheap_stats.bytes_free += slabheap_stats.bytes_in_processor_caches;
+    }
 }
@@ -50,11 +50,26 @@ void kfree_sized(void*, size_t);
 struct kmalloc_stats {
     size_t bytes_allocated;
     size_t bytes_free;
+    size_t bytes_in_processor_caches;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
+constexpr size_t KMALLOC_SLABHEAP_COUNT = 6;
+
+struct kmalloc_slabheap_stats {
+    size_t slab_size;
+    size_t bytes_allocated;
+    size_t bytes_free;
+    size_t bytes_in_processor_caches;
+    size_t processor_cache_allocations;
+    size_t processor_cache_frees;
+    size_t processor_cache_refills;
+    size_t processor_cache_flushes;
+};
+void get_kmalloc_slabheap_stats(kmalloc_slabheap_stats (&)[KMALLOC_SLABHEAP_COUNT]);
+
 extern bool g_dump_kmalloc_stacks;
 
 inline void* operator new(size_t, void* p) { return p; }
@@ -84,3 +99,4 @@ void operator delete[](void* ptr, size_t) noexcept;
 size_t kmalloc_good_size(size_t);
 
 void kmalloc_enable_expand();
+void kmalloc_enable_processor_cache();
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Library/PipeBuffer.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+static constexpr size_t copy_segment_size = 64 * KiB;
+
+// Sharing pages isn't free: it takes a TLB flush per page now, and a page fault later when the writer
+// touches the page again. That only pays off for writes that are large enough.
+static constexpr size_t loan_threshold = 64 * KiB;
+static constexpr size_t max_loan_size = 256 * KiB;
+
+// Every buffer may use its initial capacity, but growing beyond that draws from a budget shared by all of them.
+static SpinlockProtected<size_t, LockRank::None> s_grown_capacity_in_use { 0 };
+
+static size_t grown_capacity_budget()
+{
+    return max(16 * MiB, MM.get_system_memory_info().physical_pages * PAGE_SIZE / 64);
+}
+
+ErrorOr<NonnullOwnPtr<PipeBuffer>> PipeBuffer::try_create(StringView name)
+{
+    return adopt_nonnull_own_or_enomem(new (nothrow) PipeBuffer(name));
+}
+
+PipeBuffer::PipeBuffer(StringView name)
+    : m_name(name)
+{
+}
+
+PipeBuffer::~PipeBuffer()
+{
+    release_grown_capacity();
+}
+
+void PipeBuffer::compute_lockfree_metadata()
+{
+    InterruptDisabler disabler;
+    m_empty = m_size == 0;
+    m_space_for_writing = m_capacity - m_size;
+}
+
+void PipeBuffer::grow_for_write(size_t size)
+{
+    // NOTE: The capacity is only a limit. The memory is allocated as the data comes in, and freed once it's been read.
+    auto new_capacity = m_capacity;
+    while (new_capacity < max_capacity && size > new_capacity - m_size)
+        new_capacity *= 2;
+    new_capacity = min(new_capacity, max_capacity);
+    if (new_capacity == m_capacity)
+        return;
+
+    auto budget = grown_capacity_budget();
+    s_grown_capacity_in_use.with([&](auto& in_use) {
+        // Grow as far as the budget allows.
+        while (new_capacity > m_capacity && in_use + (new_capacity - m_capacity) > budget)
+            new_capacity /= 2;
+        if (new_capacity <= m_capacity)
+            return;
+        in_use += new_capacity - m_capacity;
+        m_capacity = new_capacity;
+    });
+}
+
+void PipeBuffer::release_grown_capacity()
+{
+    if (m_capacity == initial_capacity)
+        return;
+    s_grown_capacity_in_use.with([&](auto& in_use) {
+        in_use -= m_capacity - initial_capacity;
+    });
+    m_capacity = initial_capacity;
+}
+
+ErrorOr<size_t> PipeBuffer::write(UserOrKernelBuffer const& data, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_lock);
+    grow_for_write(size);
+    size_t bytes_to_write = min(size, m_capacity - m_size);
+
+    bool may_loan = !data.is_kernel_buffer() && bytes_to_write >= loan_threshold;
+    size_t nwritten = 0;
+    while (nwritten < bytes_to_write) {
+        auto chunk = data.offset(nwritten);
+        auto chunk_vaddr = VirtualAddress(chunk.user_or_kernel_ptr());
+        size_t remaining = bytes_to_write - nwritten;
+
+        if (may_loan && chunk_vaddr.is_page_aligned() && remaining >= PAGE_SIZE) {
+            auto loan_size = Memory::page_round_down(min(remaining, max_loan_size));
+            if (!try_loan_pages(chunk_vaddr, loan_size).is_error()) {
+                nwritten += loan_size;
+                m_size += loan_size;
+                continue;
+            }
+            may_loan = false;
+        }
+
+        size_t copy_size = remaining;
+        if (may_loan && !chunk_vaddr.is_page_aligned()) {
+            // Copy up to the next page boundary, so that we can loan the rest.
+            copy_size = min(remaining, PAGE_SIZE - (chunk_vaddr.get() % PAGE_SIZE));
+        }
+        auto ncopied_or_error = copy_in(chunk, copy_size);
+        if (ncopied_or_error.is_error()) {
+            if (nwritten == 0)
+                return ncopied_or_error.release_error();
+            break;
+        }
+        nwritten += ncopied_or_error.value();
+        m_size += ncopied_or_error.value();
+    }
+
+    compute_lockfree_metadata();
+    if (m_unblock_callback && !m_empty)
+        m_unblock_callback();
+    return nwritten;
+}
+
+ErrorOr<size_t> PipeBuffer::copy_in(UserOrKernelBuffer const& data, size_t size)
+{
+    if (m_segments.is_empty() || m_segments.last().is_loaned || m_segments.last().end == m_segments.last().region->size()) {
+        auto region = move(m_spare_region);
+        if (!region)
+            region = TRY(MM.allocate_kernel_region(copy_segment_size, m_name, Memory::Region::Access::ReadWrite));
+        TRY(m_segments.try_append({ region.release_nonnull() }));
+    }
+
+    auto& tail = m_segments.last();
+    size_t ncopied = min(size, tail.region->size() - tail.end);
+    TRY(data.read(tail.region->vaddr().offset(tail.end).as_ptr(), ncopied));
+    tail.end += ncopied;
+    return ncopied;
+}
+
+ErrorOr<void> PipeBuffer::try_loan_pages(VirtualAddress vaddr, size_t size)
+{
+    VERIFY(vaddr.is_page_aligned());
+    VERIFY(size > 0 && size % PAGE_SIZE == 0);
+
+    Vector<NonnullRefPtr<Memory::PhysicalPage>, max_loan_size / PAGE_SIZE> pages;
+    TRY(Process::current().address_space().with([&](auto& space) -> ErrorOr<void> {
+        auto* region = space->find_region_containing({ vaddr, size });
+        if (!region || !region->is_user() || !region->is_readable() || region->is_shared() || !region->vmobject().is_anonymous())
+            return ENOTSUP;
+        auto& vmobject = static_cast<Memory::AnonymousVMObject&>(region->vmobject());
+        for (size_t offset = 0; offset < size; offset += PAGE_SIZE) {
+            auto page_index = region->translate_to_vmobject_page(region->page_index_from_address(vaddr.offset(offset)));
+            TRY(pages.try_append(TRY(vmobject.share_page_copy_on_write(page_index, Memory::AnonymousVMObject::ShouldCommitCopy::Yes))));
+        }
+        return {};
+    }));
+
+    // NOTE: If we fail from here on, the pages we marked copy-on-write simply get remapped writable on the next write fault,
+    //       and the pages committed for copying them are given back.
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_physical_pages(pages.span()));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, m_name, Memory::Region::Access::Read));
+    TRY(m_segments.try_append({ move(region), 0, size, true }));
+    return {};
+}
+
+ErrorOr<size_t> PipeBuffer::read_impl(UserOrKernelBuffer& data, size_t size, bool advance)
+{
+    if (size == 0)
+        return 0;
+
+    size_t nread = 0;
+    size_t index = 0;
+    while (nread < size && index < m_segments.size()) {
+        auto& segment = m_segments[index];
+        size_t count = min(size - nread, segment.end - segment.start);
+        if (count > 0) {
+            if (auto result = data.write(segment.region->vaddr().offset(segment.start).as_ptr(), nread, count); result.is_error()) {
+                if (nread == 0)
+                    return result.release_error();
+                break;
+            }
+            nread += count;
+        }
+
+        if (!advance) {
+            ++index;
+            continue;
+        }
+
+        segment.start += count;
+        if (segment.start < segment.end)
+            break;
+        if (!segment.is_loaned && index == m_segments.size() - 1) {
+            // Keep the last segment around for the next write.
+            segment.start = segment.end = 0;
+            break;
+        }
+        auto finished_segment = m_segments.take(index);
+        if (!finished_segment.is_loaned && !m_spare_region)
+            m_spare_region = move(finished_segment.region);
+    }
+
+    if (advance) {
+        m_size -= nread;
+        // Once the reader has caught up, there's no need to hold on to a bigger share of the budget.
+        if (m_size == 0)
+            release_grown_capacity();
+        compute_lockfree_metadata();
+        if (m_unblock_callback && m_space_for_writing > 0)
+            m_unblock_callback();
+    }
+    return nread;
+}
+
+ErrorOr<size_t> PipeBuffer::read(UserOrKernelBuffer& data, size_t size)
+{
+    MutexLocker locker(m_lock);
+    return read_impl(data, size, true);
+}
+
+ErrorOr<size_t> PipeBuffer::peek(UserOrKernelBuffer& data, size_t size)
+{
+    MutexLocker locker(m_lock);
+    return read_impl(data, size, false);
+}
+
+}
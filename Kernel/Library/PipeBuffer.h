@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+// PipeBuffer is the buffer behind pipes and local sockets. It has the same interface as DoubleBuffer,
+// but instead of a fixed-size storage, it keeps a queue of segments that are allocated as data comes in.
+// A writer that keeps filling it up makes it grow (up to max_capacity, and as far as a budget shared by all
+// buffers allows), so that large payloads need fewer round trips through the scheduler.
+// Large page-aligned writes from userspace don't copy the data at all: the pages are shared with the
+// buffer copy-on-write, so the only copy is made when the reader takes the data out. If we can't commit
+// the memory that the writer needs to write to those pages again, we copy instead.
+class PipeBuffer {
+public:
+    static constexpr size_t initial_capacity = 64 * KiB;
+    static constexpr size_t max_capacity = 1 * MiB;
+
+    static ErrorOr<NonnullOwnPtr<PipeBuffer>> try_create(StringView name);
+    ~PipeBuffer();
+
+    ErrorOr<size_t> write(UserOrKernelBuffer const&, size_t);
+    ErrorOr<size_t> write(u8 const* data, size_t size)
+    {
+        return write(UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data)), size);
+    }
+    ErrorOr<size_t> read(UserOrKernelBuffer&, size_t);
+    ErrorOr<size_t> read(u8* data, size_t size)
+    {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        return read(buffer, size);
+    }
+    ErrorOr<size_t> peek(UserOrKernelBuffer&, size_t);
+
+    bool is_empty() const { return m_empty; }
+
+    size_t space_for_writing() const { return m_space_for_writing; }
+    size_t immediately_readable() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    void set_unblock_callback(Function<void()> callback)
+    {
+        VERIFY(!m_unblock_callback);
+        m_unblock_callback = move(callback);
+    }
+
+private:
+    explicit PipeBuffer(StringView name);
+
+    struct Segment {
+        NonnullOwnPtr<Memory::Region> region;
+        size_t start { 0 };
+        size_t end { 0 };
+        // Loaned segments map pages of the writer, so nothing else may be written into them.
+        bool is_loaned { false };
+    };
+
+    void compute_lockfree_metadata();
+    void grow_for_write(size_t size);
+    void release_grown_capacity();
+
+    ErrorOr<size_t> copy_in(UserOrKernelBuffer const&, size_t);
+    ErrorOr<void> try_loan_pages(VirtualAddress, size_t);
+    ErrorOr<size_t> read_impl(UserOrKernelBuffer&, size_t, bool advance);
+
+    StringView m_name;
+    Vector<Segment> m_segments;
+    // An empty copy segment we hold on to, so that a steady stream of small writes doesn't allocate all the time.
+    OwnPtr<Memory::Region> m_spare_region;
+
+    Function<void()> m_unblock_callback;
+    size_t m_capacity { initial_capacity };
+    size_t m_size { 0 };
+    size_t m_space_for_writing { initial_capacity };
+    bool m_empty { true };
+    mutable Mutex m_lock { "PipeBuffer"sv };
+};
+
+}
@@ -205,11 +205,15 @@ ErrorOr<Region*> AddressSpace::allocate_region_with_vmobject(RandomizeVirtualAdd
     if (!name.is_null())
         region_name = TRY(KString::try_create(name));
 
+    // Large anonymous mappings are placed on a large page boundary (if possible) so that they can be backed by large pages.
+    bool prefer_large_page_alignment = vmobject->is_anonymous() && alignment == PAGE_SIZE && size >= LARGE_PAGE_SIZE && !(offset_in_vmobject % LARGE_PAGE_SIZE);
+
     auto region = TRY(Region::create_unplaced(move(vmobject), offset_in_vmobject, move(region_name), prot_to_region_access_flags(prot), Region::Cacheable::Yes, shared));
 
-    if (requested_address.is_null())
-        TRY(m_region_tree.place_anywhere(*region, randomize_virtual_address, size, alignment));
-    else
+    if (requested_address.is_null()) {
+        if (!prefer_large_page_alignment || m_region_tree.place_anywhere(*region, randomize_virtual_address, size, LARGE_PAGE_SIZE).is_error())
+            TRY(m_region_tree.place_anywhere(*region, randomize_virtual_address, size, alignment));
+    } else
         TRY(m_region_tree.place_specifically(*region, VirtualRange { VirtualAddress { requested_address }, size }));
 
     ArmedScopeGuard remove_region_from_tree_on_failure = [&] {
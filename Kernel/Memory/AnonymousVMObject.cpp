@@ -145,8 +145,20 @@ AnonymousVMObject::AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&& new_phys
 {
     if (strategy == AllocationStrategy::AllocateNow) {
         // Allocate all pages right now. We know we can get all because we committed the amount needed
-        for (size_t i = 0; i < page_count(); ++i)
-            physical_pages()[i] = m_unused_committed_pages->take_one();
+        // Where possible, back each large page sized chunk with a physically contiguous block so that it can be
+        // mapped with a single page directory entry. Once that fails, it's unlikely to work for the rest either.
+        bool try_large_pages = true;
+        size_t i = 0;
+        while (i < page_count()) {
+            if (try_large_pages && !(i % PAGES_PER_LARGE_PAGE) && i + PAGES_PER_LARGE_PAGE <= page_count()) {
+                if (m_unused_committed_pages->try_take_large_page(physical_pages().slice(i, PAGES_PER_LARGE_PAGE))) {
+                    i += PAGES_PER_LARGE_PAGE;
+                    continue;
+                }
+                try_large_pages = false;
+            }
+            physical_pages()[i++] = m_unused_committed_pages->take_one();
+        }
     } else {
         auto& initial_page = (strategy == AllocationStrategy::Reserve) ? MM.lazy_committed_page() : MM.shared_zero_page();
         for (size_t i = 0; i < page_count(); ++i)
@@ -275,6 +287,20 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_allocate_committed_large_page(Badge<Region>, size_t first_page_index)
+{
+    SpinlockLocker lock(m_lock);
+    if (!m_unused_committed_pages.has_value())
+        return false;
+
+    auto pages = physical_pages().slice(first_page_index, PAGES_PER_LARGE_PAGE);
+    for (auto const& page : pages) {
+        if (!page || !page->is_lazy_committed_page())
+            return false;
+    }
+    return m_unused_committed_pages->try_take_large_page(pages);
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
@@ -308,6 +334,93 @@ ErrorOr<void> AnonymousVMObject::set_should_cow(size_t page_index, bool cow)
     return {};
 }
 
+ErrorOr<NonnullRefPtr<PhysicalPage>> AnonymousVMObject::share_page_copy_on_write(size_t page_index, ShouldCommitCopy should_commit_copy)
+{
+    // NOTE: Once the page is shared, the next write to it needs a page to copy it to, which we may commit right away.
+    //       If the page already has one, this is simply given back when we return.
+    Optional<CommittedPhysicalPageSet> committed_page;
+    if (should_commit_copy == ShouldCommitCopy::Yes)
+        committed_page = TRY(MM.commit_physical_pages(1));
+
+    RefPtr<PhysicalPage> page;
+    {
+        SpinlockLocker lock(m_lock);
+        if (is_purgeable())
+            return ENOTSUP;
+        // NOTE: Writes through a shared mapping don't cause COW faults, so they would change the page under the caller.
+        bool is_mapped_shared = false;
+        for_each_region([&](Region& region) {
+            if (region.is_shared())
+                is_mapped_shared = true;
+        });
+        if (is_mapped_shared)
+            return ENOTSUP;
+
+        auto const& page_slot = physical_pages()[page_index];
+        if (!page_slot || page_slot->is_shared_zero_page() || page_slot->is_lazy_committed_page())
+            return EFAULT;
+        if (committed_page.has_value() && m_committed_cow_map.is_null())
+            m_committed_cow_map = TRY(Bitmap::create(page_count(), false));
+        TRY(set_should_cow(page_index, true));
+        if (committed_page.has_value() && !m_committed_cow_map.get(page_index)) {
+            m_committed_cow_map.set(page_index, true);
+            if (m_committed_cow_pages.has_value())
+                m_committed_cow_pages->absorb(committed_page.release_value());
+            else
+                m_committed_cow_pages = committed_page.release_value();
+        }
+        page = page_slot;
+    }
+
+    for_each_region([&](Region& region) {
+        // If we can't remap the page, it isn't mapped in the first place.
+        (void)region.remap_vmobject_page(page_index, *page);
+    });
+    return page.release_nonnull();
+}
+
+bool AnonymousVMObject::is_mergeable()
+{
+    SpinlockLocker lock(m_lock);
+    // NOTE: Pages shared with a forked child already have committed memory set aside for copying them,
+    //       and we don't want to mess with that bookkeeping.
+    if (is_purgeable() || m_shared_committed_cow_pages)
+        return false;
+    bool has_regions = false;
+    bool is_private_user_memory = true;
+    for_each_region([&](Region& region) {
+        has_regions = true;
+        if (region.is_shared() || !region.is_user())
+            is_private_user_memory = false;
+    });
+    return has_regions && is_private_user_memory;
+}
+
+RefPtr<PhysicalPage> AnonymousVMObject::mergeable_page(size_t page_index) const
+{
+    SpinlockLocker lock(m_lock);
+    auto const& page = physical_pages()[page_index];
+    if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page() || !page->may_return_to_freelist())
+        return nullptr;
+    return page;
+}
+
+bool AnonymousVMObject::replace_with_identical_page(size_t page_index, PhysicalPage const& expected_page, NonnullRefPtr<PhysicalPage> replacement)
+{
+    SpinlockLocker lock(m_lock);
+    auto& page_slot = physical_pages()[page_index];
+    // The caller holds a reference to the expected page, so any write since it was shared got a copy of its own.
+    if (page_slot.ptr() != &expected_page)
+        return false;
+    VERIFY(!m_cow_map.is_null() && m_cow_map.get(page_index));
+    page_slot = replacement;
+    // NOTE: We remap while still holding the lock, so that a concurrent COW fault can't leave a region mapping the old page.
+    for_each_region([&](Region& region) {
+        (void)region.remap_vmobject_page(page_index, replacement);
+    });
+    return true;
+}
+
 size_t AnonymousVMObject::cow_pages() const
 {
     if (m_cow_map.is_null())
@@ -332,11 +445,18 @@ PageFaultResponse AnonymousVMObject::handle_cow_fault(size_t page_index, Virtual
     if (m_shared_committed_cow_pages && m_shared_committed_cow_pages->is_empty())
         m_shared_committed_cow_pages = nullptr;
 
+    // Pages we shared outside of fork() brought their own committed page, so they don't eat into the ones fork() set aside.
+    bool has_committed_cow_page = !m_committed_cow_map.is_null() && m_committed_cow_map.get(page_index);
+    if (has_committed_cow_page)
+        m_committed_cow_map.set(page_index, false);
+
     if (page_slot->ref_count() == 1) {
         dbgln_if(PAGE_FAULT_DEBUG, "    >> It's a COW page but nobody is sharing it anymore. Remap r/w");
         MUST(set_should_cow(page_index, false)); // If we received a COW fault, we already have a cow map allocated, so this is infallible
 
-        if (m_shared_committed_cow_pages) {
+        if (has_committed_cow_page) {
+            m_committed_cow_pages->uncommit_one();
+        } else if (m_shared_committed_cow_pages) {
             m_shared_committed_cow_pages->uncommit_one();
             if (m_shared_committed_cow_pages->is_empty())
                 m_shared_committed_cow_pages = nullptr;
@@ -345,7 +465,10 @@ PageFaultResponse AnonymousVMObject::handle_cow_fault(size_t page_index, Virtual
     }
 
     RefPtr<PhysicalPage> page;
-    if (m_shared_committed_cow_pages) {
+    if (has_committed_cow_page) {
+        dbgln_if(PAGE_FAULT_DEBUG, "    >> It's a committed COW page and it's time to COW!");
+        page = m_committed_cow_pages->take_one();
+    } else if (m_shared_committed_cow_pages) {
         dbgln_if(PAGE_FAULT_DEBUG, "    >> It's a committed COW page and it's time to COW!");
         page = m_shared_committed_cow_pages->take_one();
     } else {
@@ -26,10 +26,26 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> allocate_committed_page(Badge<Region>);
+    [[nodiscard]] bool try_allocate_committed_large_page(Badge<Region>, size_t first_page_index);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
     ErrorOr<void> set_should_cow(size_t page_index, bool);
+    // Marks the page copy-on-write in all regions that map it, so that the caller can keep a reference to its
+    // current contents without copying them. Fails if the page isn't backed by memory of its own yet,
+    // or if we were asked to commit the page that a write to it will need and can't.
+    enum class ShouldCommitCopy {
+        No,
+        Yes,
+    };
+    ErrorOr<NonnullRefPtr<PhysicalPage>> share_page_copy_on_write(size_t page_index, ShouldCommitCopy);
+
+    // Used by the same-page merging task. Only private memory that is mapped into userspace takes part in it.
+    bool is_mergeable();
+    RefPtr<PhysicalPage> mergeable_page(size_t page_index) const;
+    // Replaces a page previously shared with share_page_copy_on_write() by another page with the same contents.
+    // Fails if the page was written to in the meantime.
+    bool replace_with_identical_page(size_t page_index, PhysicalPage const& expected_page, NonnullRefPtr<PhysicalPage> replacement);
 
     bool is_purgeable() const { return m_purgeable; }
     bool is_volatile() const { return m_volatile; }
@@ -85,6 +101,11 @@ private:
     LockWeakPtr<AnonymousVMObject> m_cow_parent;
     LockRefPtr<SharedCommittedCowPages> m_shared_committed_cow_pages;
 
+    // Pages that were shared copy-on-write outside of fork() with ShouldCommitCopy::Yes (see share_page_copy_on_write())
+    // each have a page committed in here, so that writing to them can't fail.
+    Bitmap m_committed_cow_map;
+    Optional<CommittedPhysicalPageSet> m_committed_cow_pages;
+
     bool m_purgeable { false };
     bool m_volatile { false };
     bool m_was_purged { false };
@@ -5,7 +5,9 @@
  */
 
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Memory/InodeVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
 
 namespace Kernel::Memory {
 
@@ -96,4 +98,54 @@ u32 InodeVMObject::writable_mappings() const
     return count;
 }
 
+ErrorOr<RefPtr<PhysicalPage>> InodeVMObject::try_get_or_read_page(size_t page_index, OpenFileDescription* description)
+{
+    VERIFY(page_index < page_count());
+
+    for (;;) {
+        u64 content_generation = 0;
+        {
+            SpinlockLocker locker(m_lock);
+            if (auto page = m_physical_pages[page_index])
+                return page;
+            content_generation = m_content_generation;
+        }
+
+        u8 page_buffer[PAGE_SIZE];
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+        auto nread = TRY(m_inode->read_bytes(page_index * PAGE_SIZE, PAGE_SIZE, buffer, description));
+        if (nread == 0)
+            return RefPtr<PhysicalPage> {};
+
+        if (nread < PAGE_SIZE) {
+            // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+            memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+        }
+
+        auto new_physical_page = TRY(MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No));
+        {
+            InterruptDisabler disabler;
+            u8* dest_ptr = MM.quickmap_page(*new_physical_page);
+            memcpy(dest_ptr, page_buffer, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+
+        {
+            SpinlockLocker locker(m_lock);
+            auto& page_slot = m_physical_pages[page_index];
+            if (page_slot) {
+                // Someone else read in this page while we were reading from the inode, use theirs.
+                return page_slot;
+            }
+            // If the inode was modified while we were reading from it, what we read may already be stale, so try again.
+            if (content_generation != m_content_generation)
+                continue;
+            page_slot = new_physical_page;
+        }
+        if (is_shared_inode())
+            m_inode->did_read_into_page_cache(page_index * PAGE_SIZE, nread);
+        return new_physical_page;
+    }
+}
+
 }
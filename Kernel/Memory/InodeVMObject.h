@@ -27,6 +27,10 @@ public:
 
     u32 writable_mappings() const;
 
+    // Returns the page at `page_index`, reading it in from the inode first if it isn't resident.
+    // A null page is returned if the page lies entirely beyond the end of the inode.
+    ErrorOr<RefPtr<PhysicalPage>> try_get_or_read_page(size_t page_index, OpenFileDescription* = nullptr);
+
 protected:
     explicit InodeVMObject(Inode&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
     explicit InodeVMObject(InodeVMObject const&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
@@ -39,6 +43,10 @@ protected:
 
     NonnullRefPtr<Inode> const m_inode;
     Bitmap m_dirty_pages;
+
+    // Bumped (under m_lock) whenever the inode contents change behind our back, so a page that was
+    // read from the inode concurrently with such a change is not installed with stale contents.
+    u64 m_content_generation { 0 };
 };
 
 }
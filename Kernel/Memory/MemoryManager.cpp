@@ -591,6 +591,11 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+#if ARCH(X86_64)
+    // NOTE: Large pages don't have a page table we could hand out.
+    if (pde.is_huge())
+        return nullptr;
+#endif
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -605,7 +610,11 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
-    if (pde.is_present())
+    bool is_large_page = false;
+#if ARCH(X86_64)
+    is_large_page = pde.is_present() && pde.is_huge();
+#endif
+    if (pde.is_present() && !is_large_page)
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
     bool did_purge = false;
@@ -622,7 +631,12 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
         pd = quickmap_pd(page_directory, page_directory_table_index);
         VERIFY(&pde == &pd[page_directory_index]); // Sanity check
 
-        VERIFY(!pde.is_present()); // Should have not changed
+        VERIFY(pde.is_present() == is_large_page); // Should have not changed
+    }
+    if (is_large_page) {
+        split_large_page(page_directory, pde, *page_table, VirtualAddress(vaddr.get() & ~(LARGE_PAGE_SIZE - 1)));
+        (void)page_table.leak_ref();
+        return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
     }
     pde.set_page_table_base(page_table->paddr().get());
     pde.set_user_allowed(true);
@@ -646,6 +660,10 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+#if ARCH(X86_64)
+    // NOTE: Large pages are only ever created for ranges that are torn down as a whole, see release_large_page().
+    VERIFY(!pde.is_present() || !pde.is_huge());
+#endif
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -669,6 +687,123 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+void MemoryManager::split_large_page(PageDirectory& page_directory, PageDirectoryEntry& pde, PhysicalPage& page_table, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY(pde.is_huge());
+    auto base = pde.page_table_base();
+
+    // Fill the new page table so that it maps exactly what the large page mapped.
+    auto* ptes = quickmap_pt(page_table.paddr());
+    for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i) {
+        auto& pte = ptes[i];
+        pte.clear();
+        pte.set_physical_page_base(base + i * PAGE_SIZE);
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_writable(pde.is_writable());
+        pte.set_cache_disabled(pde.is_cache_disabled());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+        pte.set_global(pde.is_global());
+        pte.set_present(true);
+    }
+
+    // Swap the entry in one go so that no other processor can observe a non-present entry in between.
+    auto new_pde = pde;
+    new_pde.set_huge(false);
+    new_pde.set_execute_disabled(false);
+    new_pde.set_cache_disabled(false);
+    new_pde.set_page_table_base(page_table.paddr().get());
+    new_pde.set_user_allowed(true);
+    new_pde.set_writable(true);
+    pde = new_pde;
+
+    // The processor must not hold a 2 MiB and a 4 KiB translation for the same address at the same time.
+    flush_tlb(&page_directory, vaddr, PAGES_PER_LARGE_PAGE);
+
+    --m_large_pages_mapped;
+    ++m_large_page_splits;
+#else
+    (void)page_directory;
+    (void)pde;
+    (void)page_table;
+    (void)vaddr;
+    VERIFY_NOT_REACHED();
+#endif
+}
+
+bool MemoryManager::map_large_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, Region::Access access)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(!(vaddr.get() % LARGE_PAGE_SIZE));
+    VERIFY(!(paddr.get() % LARGE_PAGE_SIZE));
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+
+    // NOTE: The caller guarantees that the whole large page belongs to a single region,
+    //       so any page table that is already here only holds mappings we're about to replace.
+    bool was_large_page = pde.is_present() && pde.is_huge();
+    Optional<PhysicalAddress> old_page_table;
+    if (pde.is_present() && !was_large_page)
+        old_page_table = PhysicalAddress { pde.page_table_base() };
+
+    auto new_pde = pde;
+    new_pde.clear();
+    new_pde.set_page_table_base(paddr.get());
+    new_pde.set_huge(true);
+    new_pde.set_user_allowed(true);
+    new_pde.set_writable(has_flag(access, Region::Access::Write));
+    if (Processor::current().has_nx())
+        new_pde.set_execute_disabled(!has_flag(access, Region::Access::Execute));
+    new_pde.set_present(true);
+    pde = new_pde;
+
+    if (old_page_table.has_value()) {
+        // Make sure no processor is still walking the old page table before we give it back.
+        flush_tlb(&page_directory, vaddr, PAGES_PER_LARGE_PAGE);
+        get_physical_page_entry(*old_page_table).allocated.physical_page.unref();
+    }
+
+    if (!was_large_page)
+        ++m_large_pages_mapped;
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    (void)paddr;
+    (void)access;
+    return false;
+#endif
+}
+
+bool MemoryManager::release_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(!(vaddr.get() % LARGE_PAGE_SIZE));
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!pde.is_present() || !pde.is_huge())
+        return false;
+
+    pde.clear();
+    --m_large_pages_mapped;
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     dmesgln("Initialize MMU");
@@ -678,6 +813,7 @@ UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
         new MemoryManager;
         kmalloc_enable_expand();
     }
+    kmalloc_enable_processor_cache();
 }
 
 Region* MemoryManager::find_user_region_from_vaddr(AddressSpace& space, VirtualAddress vaddr)
@@ -949,6 +1085,59 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
     });
 }
 
+size_t MemoryManager::purge_volatile_memory(size_t page_count)
+{
+    size_t total_pages_purged = 0;
+    for_each_vmobject([&](auto& vmobject) {
+        if (!vmobject.is_anonymous())
+            return IterationDecision::Continue;
+        auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+        if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
+            return IterationDecision::Continue;
+        total_pages_purged += anonymous_vmobject.purge();
+        return total_pages_purged >= page_count ? IterationDecision::Break : IterationDecision::Continue;
+    });
+    return total_pages_purged;
+}
+
+size_t MemoryManager::release_clean_inode_pages(size_t page_count)
+{
+    size_t total_pages_released = 0;
+    auto release_pages = [&](bool include_mapped) {
+        for_each_vmobject([&](auto& vmobject) {
+            if (!vmobject.is_inode())
+                return IterationDecision::Continue;
+            if (!include_mapped && vmobject.is_mapped())
+                return IterationDecision::Continue;
+            auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
+            total_pages_released += inode_vmobject.try_release_clean_pages(static_cast<int>(page_count - total_pages_released));
+            return total_pages_released >= page_count ? IterationDecision::Break : IterationDecision::Continue;
+        });
+    };
+
+    // Pages of files that nobody has mapped are only kept around as a cache, so they go first.
+    release_pages(false);
+    if (total_pages_released < page_count)
+        release_pages(true);
+    return total_pages_released;
+}
+
+size_t MemoryManager::enforce_clean_inode_page_limit()
+{
+    static constexpr size_t maximum_clean_inode_memory_percent = 25;
+
+    size_t clean_page_count = 0;
+    for_each_vmobject([&](auto& vmobject) {
+        if (vmobject.is_inode())
+            clean_page_count += static_cast<InodeVMObject&>(vmobject).amount_clean() / PAGE_SIZE;
+    });
+
+    auto limit = get_system_memory_info().physical_pages * maximum_clean_inode_memory_percent / 100;
+    if (clean_page_count <= limit)
+        return 0;
+    return release_clean_inode_pages(clean_page_count - limit);
+}
+
 RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
 {
     RefPtr<PhysicalPage> page;
@@ -991,6 +1180,39 @@ NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_physical_page(Badg
     return page.release_nonnull();
 }
 
+bool MemoryManager::allocate_committed_large_page(Badge<CommittedPhysicalPageSet>, Span<RefPtr<PhysicalPage>> pages)
+{
+    VERIFY(pages.size() == PAGES_PER_LARGE_PAGE);
+
+    auto physical_pages = m_global_data.with([&](auto& global_data) -> Vector<NonnullRefPtr<PhysicalPage>> {
+        VERIFY(global_data.system_memory_info.physical_pages_committed >= PAGES_PER_LARGE_PAGE);
+        for (auto& physical_region : global_data.physical_regions) {
+            // NOTE: We must never drop a block we took in here, as freeing its pages would take the global lock again.
+            auto physical_pages = physical_region->take_contiguous_free_pages(PAGES_PER_LARGE_PAGE, LARGE_PAGE_SIZE);
+            if (physical_pages.is_empty())
+                continue;
+            global_data.system_memory_info.physical_pages_used += PAGES_PER_LARGE_PAGE;
+            global_data.system_memory_info.physical_pages_committed -= PAGES_PER_LARGE_PAGE;
+            return physical_pages;
+        }
+        return {};
+    });
+
+    if (physical_pages.is_empty())
+        return false;
+
+    for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(*physical_pages[i]);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+        pages[i] = move(physical_pages[i]);
+    }
+
+    ++m_large_page_allocations;
+    return true;
+}
+
 ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
     return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalPage>> {
@@ -1017,19 +1239,14 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
             });
         }
         if (!page) {
-            // Second, we look for a file-backed VMObject with clean pages.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_inode())
-                    return IterationDecision::Continue;
-                auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
-                if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
-                    dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
-                    page = find_free_physical_page(false);
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
-                return IterationDecision::Continue;
-            });
+            // Second, we release clean file-backed pages. We release a batch of them at once,
+            // so the next allocations don't have to come back here right away.
+            static constexpr size_t clean_inode_pages_to_release = 64;
+            if (auto released_page_count = release_clean_inode_pages(clean_inode_pages_to_release)) {
+                dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObjects", released_page_count);
+                page = find_free_physical_page(false);
+                VERIFY(page);
+            }
         }
         if (!page) {
             dmesgln("MM: no physical pages available");
@@ -1233,6 +1450,16 @@ NonnullRefPtr<PhysicalPage> CommittedPhysicalPageSet::take_one()
     return MM.allocate_committed_physical_page({}, MemoryManager::ShouldZeroFill::Yes);
 }
 
+bool CommittedPhysicalPageSet::try_take_large_page(Span<RefPtr<PhysicalPage>> pages)
+{
+    if (m_page_count < PAGES_PER_LARGE_PAGE)
+        return false;
+    if (!MM.allocate_committed_large_page({}, pages))
+        return false;
+    m_page_count -= PAGES_PER_LARGE_PAGE;
+    return true;
+}
+
 void CommittedPhysicalPageSet::uncommit_one()
 {
     VERIFY(m_page_count > 0);
@@ -1269,7 +1496,11 @@ MemoryManager::SystemMemoryInfo MemoryManager::get_system_memory_info()
     return m_global_data.with([&](auto& global_data) {
         auto physical_pages_unused = global_data.system_memory_info.physical_pages_committed + global_data.system_memory_info.physical_pages_uncommitted;
         VERIFY(global_data.system_memory_info.physical_pages == (global_data.system_memory_info.physical_pages_used + physical_pages_unused));
-        return global_data.system_memory_info;
+        auto system_memory_info = global_data.system_memory_info;
+        system_memory_info.large_pages_mapped = m_large_pages_mapped.load();
+        system_memory_info.large_page_allocations = m_large_page_allocations.load();
+        system_memory_info.large_page_splits = m_large_page_splits.load();
+        return system_memory_info;
     });
 }
 }
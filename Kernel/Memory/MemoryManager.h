@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
@@ -21,6 +22,10 @@
 
 struct KmallocGlobalData;
 
+namespace Kernel {
+class PageMerger;
+}
+
 namespace Kernel::Memory {
 
 class PageDirectoryEntry;
@@ -33,6 +38,10 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// A large page is mapped by a single page directory entry instead of a full page table.
+constexpr size_t LARGE_PAGE_SIZE = 2 * MiB;
+constexpr size_t PAGES_PER_LARGE_PAGE = LARGE_PAGE_SIZE / PAGE_SIZE;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -115,6 +124,12 @@ public:
     [[nodiscard]] NonnullRefPtr<PhysicalPage> take_one();
     void uncommit_one();
 
+    void absorb(CommittedPhysicalPageSet&& other) { m_page_count += exchange(other.m_page_count, 0); }
+
+    // Tries to fill `pages` (which must hold PAGES_PER_LARGE_PAGE entries) with physically contiguous pages
+    // starting at a large page boundary. Returns false (and leaves `pages` untouched) if no such block is available.
+    [[nodiscard]] bool try_take_large_page(Span<RefPtr<PhysicalPage>> pages);
+
     void operator=(CommittedPhysicalPageSet&&) = delete;
 
 private:
@@ -124,10 +139,13 @@ private:
 class MemoryManager {
     friend class PageDirectory;
     friend class AnonymousVMObject;
+    friend class InodeVMObject;
     friend class Region;
     friend class RegionTree;
+    friend class SharedInodeVMObject;
     friend class VMObject;
     friend struct ::KmallocGlobalData;
+    friend class Kernel::PageMerger;
 
 public:
     static MemoryManager& the();
@@ -163,10 +181,18 @@ public:
     void uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, size_t page_count);
 
     NonnullRefPtr<PhysicalPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
+    bool allocate_committed_large_page(Badge<CommittedPhysicalPageSet>, Span<RefPtr<PhysicalPage>>);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<Vector<NonnullRefPtr<PhysicalPage>>> allocate_contiguous_physical_pages(size_t size);
     void deallocate_physical_page(PhysicalAddress);
 
+    // Purges volatile purgeable memory until at least page_count pages were freed, or there is nothing left to purge.
+    size_t purge_volatile_memory(size_t page_count);
+    // Releases clean file-backed pages until at least page_count pages were freed, or there is nothing left to release.
+    size_t release_clean_inode_pages(size_t page_count);
+    // Releases clean file-backed pages until they take up no more than their share of physical memory.
+    size_t enforce_clean_inode_page_limit();
+
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
     ErrorOr<NonnullOwnPtr<Memory::Region>> allocate_dma_buffer_page(StringView name, Memory::Region::Access access, RefPtr<Memory::PhysicalPage>& dma_buffer_page);
     ErrorOr<NonnullOwnPtr<Memory::Region>> allocate_dma_buffer_page(StringView name, Memory::Region::Access access);
@@ -183,6 +209,9 @@ public:
         PhysicalSize physical_pages_used { 0 };
         PhysicalSize physical_pages_committed { 0 };
         PhysicalSize physical_pages_uncommitted { 0 };
+        u64 large_pages_mapped { 0 };
+        u64 large_page_allocations { 0 };
+        u64 large_page_splits { 0 };
     };
 
     SystemMemoryInfo get_system_memory_info();
@@ -269,6 +298,10 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    bool map_large_page(PageDirectory&, VirtualAddress, PhysicalAddress, Region::Access);
+    bool release_large_page(PageDirectory&, VirtualAddress);
+    void split_large_page(PageDirectory&, PageDirectoryEntry&, PhysicalPage& page_table, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -281,6 +314,10 @@ private:
     PhysicalPageEntry* m_physical_page_entries { nullptr };
     size_t m_physical_page_entries_count { 0 };
 
+    Atomic<u64> m_large_pages_mapped { 0 };
+    Atomic<u64> m_large_page_allocations { 0 };
+    Atomic<u64> m_large_page_splits { 0 };
+
     struct GlobalData {
         GlobalData();
 
@@ -5,6 +5,7 @@
  */
 
 #include <AK/BuiltinWrappers.h>
+#include <AK/NumericLimits.h>
 #include <Kernel/Library/Assertions.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/PhysicalRegion.h>
@@ -39,11 +40,11 @@ void PhysicalRegion::initialize_zones()
     size_t remaining_pages = m_pages;
     auto base_address = m_lower;
 
-    auto make_zones = [&](size_t zone_size) -> size_t {
+    auto make_zones = [&](size_t zone_size, size_t max_zone_count) -> size_t {
         size_t pages_per_zone = zone_size / PAGE_SIZE;
         size_t zone_count = 0;
         auto first_address = base_address;
-        while (remaining_pages >= pages_per_zone) {
+        while (remaining_pages >= pages_per_zone && zone_count < max_zone_count) {
             m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, pages_per_zone)).release_value_but_fixme_should_propagate_errors());
             base_address = base_address.offset(pages_per_zone * PAGE_SIZE);
             m_usable_zones.append(*m_zones.last());
@@ -55,11 +56,21 @@ void PhysicalRegion::initialize_zones()
         return zone_count;
     };
 
+    // Blocks handed out by a zone are only aligned relative to the zone base, so we want the large zones to start
+    // on a large page boundary. If the region doesn't, use 1 MiB zones to cover the gap up to the next boundary.
+    auto misalignment = m_lower.get() % LARGE_PAGE_SIZE;
+    if (misalignment != 0 && (misalignment % small_zone_size) == 0) {
+        auto leading_size = LARGE_PAGE_SIZE - misalignment;
+        if (remaining_pages * PAGE_SIZE >= leading_size + large_zone_size)
+            m_leading_small_zones = make_zones(small_zone_size, leading_size / small_zone_size);
+    }
+
     // First make 16 MiB zones (with 4096 pages each)
-    m_large_zones = make_zones(large_zone_size);
+    m_large_zones_base = base_address;
+    m_large_zones = make_zones(large_zone_size, NumericLimits<size_t>::max());
 
     // Then divide any remaining space into 1 MiB zones (with 256 pages each)
-    make_zones(small_zone_size);
+    make_zones(small_zone_size, NumericLimits<size_t>::max());
 }
 
 OwnPtr<PhysicalRegion> PhysicalRegion::try_take_pages_from_beginning(size_t page_count)
@@ -74,13 +85,18 @@ OwnPtr<PhysicalRegion> PhysicalRegion::try_take_pages_from_beginning(size_t page
     return try_create(taken_lower, taken_upper);
 }
 
-Vector<NonnullRefPtr<PhysicalPage>> PhysicalRegion::take_contiguous_free_pages(size_t count)
+Vector<NonnullRefPtr<PhysicalPage>> PhysicalRegion::take_contiguous_free_pages(size_t count, size_t alignment)
 {
     auto rounded_page_count = next_power_of_two(count);
     auto order = count_trailing_zeroes(rounded_page_count);
+    VERIFY(alignment <= rounded_page_count * PAGE_SIZE);
 
     Optional<PhysicalAddress> page_base;
     for (auto& zone : m_usable_zones) {
+        // Blocks are aligned to their size relative to the zone base, so they are only aligned in absolute terms
+        // if the zone base is, too.
+        if (zone.base().get() % alignment != 0)
+            continue;
         page_base = zone.allocate_block(order);
         if (page_base.has_value()) {
             if (zone.is_empty()) {
@@ -93,6 +109,7 @@ Vector<NonnullRefPtr<PhysicalPage>> PhysicalRegion::take_contiguous_free_pages(s
 
     if (!page_base.has_value())
         return {};
+    VERIFY(page_base->get() % alignment == 0);
 
     Vector<NonnullRefPtr<PhysicalPage>> physical_pages;
     physical_pages.ensure_capacity(count);
@@ -121,14 +138,16 @@ RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
 
 void PhysicalRegion::return_page(PhysicalAddress paddr)
 {
-    auto large_zone_base = lower().get();
-    auto small_zone_base = lower().get() + (m_large_zones * large_zone_size);
+    auto large_zone_base = m_large_zones_base.get();
+    auto small_zone_base = large_zone_base + (m_large_zones * large_zone_size);
 
     size_t zone_index;
-    if (paddr.get() < small_zone_base)
-        zone_index = (paddr.get() - large_zone_base) / large_zone_size;
+    if (paddr.get() < large_zone_base)
+        zone_index = (paddr.get() - lower().get()) / small_zone_size;
+    else if (paddr.get() < small_zone_base)
+        zone_index = m_leading_small_zones + (paddr.get() - large_zone_base) / large_zone_size;
     else
-        zone_index = m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
+        zone_index = m_leading_small_zones + m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
 
     auto& zone = m_zones[zone_index];
     VERIFY(zone->contains(paddr));
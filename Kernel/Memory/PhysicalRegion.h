@@ -35,7 +35,8 @@ public:
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(size_t);
 
     RefPtr<PhysicalPage> take_free_page();
-    Vector<NonnullRefPtr<PhysicalPage>> take_contiguous_free_pages(size_t count);
+    // NOTE: The alignment must not be larger than the size of the block we take.
+    Vector<NonnullRefPtr<PhysicalPage>> take_contiguous_free_pages(size_t count, size_t alignment = PAGE_SIZE);
     void return_page(PhysicalAddress);
 
 private:
@@ -46,7 +47,9 @@ private:
 
     Vector<NonnullOwnPtr<PhysicalZone>> m_zones;
 
+    size_t m_leading_small_zones { 0 };
     size_t m_large_zones { 0 };
+    PhysicalAddress m_large_zones_base;
 
     PhysicalZone::List m_usable_zones;
     PhysicalZone::List m_full_zones;
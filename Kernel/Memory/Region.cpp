@@ -9,7 +9,6 @@
 #include <Kernel/Arch/PageFault.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Inode.h>
-#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -257,6 +256,45 @@ bool Region::map_individual_page_impl(size_t page_index)
     return map_individual_page_impl(page_index, page);
 }
 
+bool Region::can_use_large_page_at(size_t page_index) const
+{
+    if (vaddr_from_page_index(page_index).get() % LARGE_PAGE_SIZE)
+        return false;
+    if (page_index + PAGES_PER_LARGE_PAGE > page_count())
+        return false;
+    if (!vmobject().is_anonymous() || !m_cacheable || m_write_combine || !is_readable())
+        return false;
+    // NOTE: Large pages are only used for userspace mappings, the kernel keeps its page tables around for kmalloc.
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    return page_vaddr.get() >= USER_RANGE_BASE && is_user_address(page_vaddr.offset(LARGE_PAGE_SIZE - 1));
+}
+
+bool Region::map_large_page_impl(size_t page_index)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    if (!can_use_large_page_at(page_index))
+        return false;
+
+    PhysicalAddress base;
+    {
+        SpinlockLocker vmobject_locker(vmobject().m_lock);
+        auto pages = vmobject().physical_pages().slice(translate_to_vmobject_page(page_index), PAGES_PER_LARGE_PAGE);
+        if (!pages[0] || pages[0]->paddr().get() % LARGE_PAGE_SIZE)
+            return false;
+        base = pages[0]->paddr();
+        for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i) {
+            auto const& page = pages[i];
+            if (!page || page->paddr() != base.offset(i * PAGE_SIZE))
+                return false;
+            if (should_cow(page_index + i))
+                return false;
+        }
+    }
+
+    return MM.map_large_page(*m_page_directory, vaddr_from_page_index(page_index), base, access());
+}
+
 bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalPage> physical_page)
 {
     SpinlockLocker page_lock(m_page_directory->get_lock());
@@ -283,9 +321,14 @@ void Region::unmap_with_locks_held(ShouldFlushTLB should_flush_tlb, SpinlockLock
     if (!m_page_directory)
         return;
     size_t count = page_count();
-    for (size_t i = 0; i < count; ++i) {
+    for (size_t i = 0; i < count;) {
         auto vaddr = vaddr_from_page_index(i);
+        if (!(vaddr.get() % LARGE_PAGE_SIZE) && i + PAGES_PER_LARGE_PAGE <= count && MM.release_large_page(*m_page_directory, vaddr)) {
+            i += PAGES_PER_LARGE_PAGE;
+            continue;
+        }
         MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
+        ++i;
     }
     if (should_flush_tlb == ShouldFlushTLB::Yes)
         MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
@@ -310,6 +353,10 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (map_large_page_impl(page_index)) {
+            page_index += PAGES_PER_LARGE_PAGE;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -416,6 +463,11 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
+        if (auto response = handle_zero_fault_with_large_page(page_index_in_region); response.has_value())
+            return response.value();
+    }
+
     RefPtr<PhysicalPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -454,6 +506,34 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+Optional<PageFaultResponse> Region::handle_zero_fault_with_large_page(size_t page_index_in_region)
+{
+    auto large_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(LARGE_PAGE_SIZE - 1) };
+    if (large_page_vaddr < vaddr())
+        return {};
+    auto first_page_index = page_index_from_address(large_page_vaddr);
+    if (!can_use_large_page_at(first_page_index))
+        return {};
+
+    // If all of the surrounding large page is still untouched, fault it in as a whole instead of page by page.
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    if (!anonymous_vmobject.try_allocate_committed_large_page({}, translate_to_vmobject_page(first_page_index)))
+        return {};
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    if (!map_large_page_impl(first_page_index)) {
+        // We couldn't use a large mapping after all, but the pages are in the VMObject now, so map them individually.
+        for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i) {
+            if (!map_individual_page_impl(first_page_index + i)) {
+                dmesgln("MM: handle_zero_fault was unable to allocate a page table to map {}", vaddr_from_page_index(first_page_index + i));
+                return PageFaultResponse::OutOfMemory;
+            }
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, large_page_vaddr, PAGES_PER_LARGE_PAGE);
+    return PageFaultResponse::Continue;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -497,59 +577,23 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
-    auto& inode = inode_vmobject.inode();
-
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
-
-    if (result.is_error()) {
-        dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
+    auto page_or_error = inode_vmobject.try_get_or_read_page(page_index_in_vmobject);
+    if (page_or_error.is_error()) {
+        if (page_or_error.error().code() == ENOMEM) {
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
+            return PageFaultResponse::OutOfMemory;
+        }
+        dmesgln("handle_inode_fault: Error ({}) while reading from inode", page_or_error.error());
         return PageFaultResponse::ShouldCrash;
     }
 
-    auto nread = result.value();
-    // Note: If we received 0, it means we are at the end of file or after it,
+    // Note: If we didn't get a page, we are at the end of file or after it,
     // which means we should return bus error.
-    if (nread == 0)
+    auto physical_page = page_or_error.release_value();
+    if (!physical_page)
         return PageFaultResponse::BusError;
 
-    if (nread < PAGE_SIZE) {
-        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
-    }
-
-    // Allocate a new physical page, and copy the read inode contents into it.
-    auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (new_physical_page_or_error.is_error()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
-    }
-    auto new_physical_page = new_physical_page_or_error.release_value();
-    {
-        InterruptDisabler disabler;
-        u8* dest_ptr = MM.quickmap_page(*new_physical_page);
-        memcpy(dest_ptr, page_buffer, PAGE_SIZE);
-        MM.unquickmap_page();
-    }
-
-    {
-        // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
-        SpinlockLocker locker(inode_vmobject.m_lock);
-
-        if (!vmobject_physical_page_slot.is_null()) {
-            // Someone else faulted in this page while we were reading from the inode.
-            // No harm done (other than some duplicate work), remap the page here and return.
-            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
-            if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
-                return PageFaultResponse::OutOfMemory;
-            return PageFaultResponse::Continue;
-        }
-
-        vmobject_physical_page_slot = new_physical_page;
-    }
-
-    if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
+    if (!remap_vmobject_page(page_index_in_vmobject, *physical_page))
         return PageFaultResponse::OutOfMemory;
 
     return PageFaultResponse::Continue;
@@ -33,6 +33,7 @@ enum class ShouldFlushTLB {
 class Region final
     : public LockWeakable<Region> {
     friend class AddressSpace;
+    friend class AnonymousVMObject;
     friend class MemoryManager;
     friend class RegionTree;
 
@@ -232,6 +233,10 @@ private:
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
 
+    [[nodiscard]] bool can_use_large_page_at(size_t page_index) const;
+    [[nodiscard]] bool map_large_page_impl(size_t page_index);
+    [[nodiscard]] Optional<PageFaultResponse> handle_zero_fault_with_large_page(size_t page_index);
+
     LockRefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
     size_t m_offset_in_vmobject { 0 };
@@ -6,6 +6,7 @@
 
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 
 namespace Kernel::Memory {
@@ -69,4 +70,143 @@ ErrorOr<void> SharedInodeVMObject::sync(off_t offset_in_pages, size_t pages)
     return {};
 }
 
+ErrorOr<size_t> SharedInodeVMObject::read_bytes(u64 offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description)
+{
+    auto inode_size = m_inode->size();
+    if (offset >= inode_size)
+        return 0;
+    count = min(count, inode_size - offset);
+
+    size_t nread = 0;
+    while (nread < count) {
+        auto position = offset + nread;
+        auto page_index = position / PAGE_SIZE;
+        if (page_index >= page_count()) {
+            // The inode has grown past what we cover, so read the rest directly.
+            auto remaining_buffer = buffer.offset(nread);
+            return nread + TRY(m_inode->read_bytes(position, count - nread, remaining_buffer, description));
+        }
+
+        auto physical_page = TRY(try_get_or_read_page(page_index, description));
+        if (!physical_page) {
+            // The inode was truncated while we were reading it.
+            break;
+        }
+
+        auto offset_in_page = position % PAGE_SIZE;
+        auto nread_here = min(static_cast<size_t>(PAGE_SIZE - offset_in_page), count - nread);
+
+        u8 page_buffer[PAGE_SIZE];
+        {
+            SpinlockLocker locker(m_lock);
+            MM.copy_physical_page(*physical_page, page_buffer);
+        }
+        TRY(buffer.write(page_buffer + offset_in_page, nread, nread_here));
+        nread += nread_here;
+    }
+    return nread;
+}
+
+void SharedInodeVMObject::did_write_bytes(u64 offset, size_t count)
+{
+    // NOTE: Writes go to the inode first, and we then refresh the pages we already have from the inode.
+    //       Reading back what actually ended up in the inode keeps these pages (and thereby any shared mappings)
+    //       in sync with it, even if the writer's buffer changed in the meantime.
+    bool released_any_pages = false;
+    size_t nwritten = 0;
+    while (nwritten < count) {
+        auto position = offset + nwritten;
+        auto page_index = position / PAGE_SIZE;
+        if (page_index >= page_count())
+            break;
+
+        auto offset_in_page = position % PAGE_SIZE;
+        auto nwritten_here = min(static_cast<size_t>(PAGE_SIZE - offset_in_page), count - nwritten);
+        nwritten += nwritten_here;
+
+        bool is_resident = false;
+        {
+            SpinlockLocker locker(m_lock);
+            ++m_content_generation;
+            is_resident = !m_physical_pages[page_index].is_null();
+        }
+        if (!is_resident)
+            continue;
+
+        u8 page_buffer[PAGE_SIZE];
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+        auto result = m_inode->read_bytes(position, nwritten_here, buffer, nullptr);
+
+        SpinlockLocker locker(m_lock);
+        auto& physical_page = m_physical_pages[page_index];
+        if (!physical_page)
+            continue;
+        if (result.is_error() || result.value() != nwritten_here) {
+            // We can't tell what the page should contain, so drop it and let the next access read it in again.
+            physical_page = nullptr;
+            m_dirty_pages.set(page_index, false);
+            released_any_pages = true;
+            continue;
+        }
+        u8* page = MM.quickmap_page(*physical_page);
+        memcpy(page + offset_in_page, page_buffer, nwritten_here);
+        MM.unquickmap_page();
+    }
+
+    if (released_any_pages) {
+        for_each_region([](auto& region) {
+            region.remap();
+        });
+    }
+}
+
+void SharedInodeVMObject::did_truncate(u64 new_size)
+{
+    SpinlockLocker locker(m_lock);
+    ++m_content_generation;
+
+    bool released_any_pages = false;
+    for (size_t page_index = ceil_div(new_size, static_cast<u64>(PAGE_SIZE)); page_index < page_count(); ++page_index) {
+        if (!m_physical_pages[page_index])
+            continue;
+        m_physical_pages[page_index] = nullptr;
+        m_dirty_pages.set(page_index, false);
+        released_any_pages = true;
+    }
+
+    // Whatever used to be past the new end of the last page has to read back as zeroes if the inode grows again.
+    auto last_page_index = new_size / PAGE_SIZE;
+    auto offset_in_last_page = new_size % PAGE_SIZE;
+    if (offset_in_last_page != 0 && last_page_index < page_count()) {
+        if (auto& physical_page = m_physical_pages[last_page_index]) {
+            u8* page = MM.quickmap_page(*physical_page);
+            memset(page + offset_in_last_page, 0, PAGE_SIZE - offset_in_last_page);
+            MM.unquickmap_page();
+        }
+    }
+
+    if (released_any_pages) {
+        for_each_region([](auto& region) {
+            region.remap();
+        });
+    }
+}
+
+ErrorOr<NonnullLockRefPtr<SharedInodeVMObject>> SharedInodeVMObject::try_create_grown_copy(size_t new_size)
+{
+    VERIFY(new_size >= size());
+    auto new_physical_pages = TRY(VMObject::try_create_physical_pages(new_size));
+    auto dirty_pages = TRY(Bitmap::create(new_physical_pages.size(), false));
+    {
+        SpinlockLocker locker(m_lock);
+        for (size_t i = 0; i < page_count(); ++i) {
+            new_physical_pages[i] = m_physical_pages[i];
+            dirty_pages.set(i, m_dirty_pages.get(i));
+        }
+    }
+    auto vmobject = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) SharedInodeVMObject(*m_inode, move(new_physical_pages), move(dirty_pages))));
+    TRY(vmobject->inode().set_shared_vmobject(*vmobject));
+    return vmobject;
+}
+
 }
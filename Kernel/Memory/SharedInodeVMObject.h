@@ -21,6 +21,12 @@ public:
 
     ErrorOr<void> sync(off_t offset_in_pages = 0, size_t pages = -1);
 
+    // A shared inode VMObject doubles as the page cache of its inode, see Inode::page_cache().
+    ErrorOr<size_t> read_bytes(u64 offset, size_t count, UserOrKernelBuffer&, OpenFileDescription*);
+    void did_write_bytes(u64 offset, size_t count);
+    void did_truncate(u64 new_size);
+    ErrorOr<NonnullLockRefPtr<SharedInodeVMObject>> try_create_grown_copy(size_t new_size);
+
 private:
     virtual bool is_shared_inode() const override { return true; }
 
@@ -54,6 +54,12 @@ public:
         m_regions.remove(region);
     }
 
+    bool is_mapped() const
+    {
+        SpinlockLocker locker(m_lock);
+        return !m_regions.is_empty();
+    }
+
 protected:
     static ErrorOr<FixedArray<RefPtr<PhysicalPage>>> try_create_physical_pages(size_t);
     ErrorOr<FixedArray<RefPtr<PhysicalPage>>> try_clone_physical_pages() const;
@@ -116,6 +116,8 @@ inline NetworkOrdered<u16> internet_checksum(void const* ptr, size_t count)
             checksum = (checksum & 0xffff) | (checksum >> 16);
         count -= 2;
     }
+    if (count == 1)
+        checksum += *(u8 const*)w << 8;
     while (checksum >> 16)
         checksum = (checksum & 0xffff) + (checksum >> 16);
     return ~checksum & 0xffff;
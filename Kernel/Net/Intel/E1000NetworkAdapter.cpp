@@ -121,6 +121,8 @@ namespace Kernel {
 #define INTERRUPT_TXD_LOW (1 << 15)
 #define INTERRUPT_SRPD (1 << 16)
 
+static constexpr u32 receive_interrupts = INTERRUPT_RXT0 | INTERRUPT_RXO;
+
 // https://www.intel.com/content/dam/doc/manual/pci-pci-x-family-gbe-controllers-software-dev-manual.pdf Section 5.2
 UNMAP_AFTER_INIT static bool is_valid_device_id(u16 device_id)
 {
@@ -220,7 +222,7 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_link()
 UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_interrupts()
 {
     out32(REG_INTERRUPT_RATE, 6000); // Interrupt rate of 1.536 milliseconds
-    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0 | INTERRUPT_RXO);
+    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | receive_interrupts);
     in32(REG_INTERRUPT_CAUSE_READ);
     enable_irq();
 }
@@ -263,8 +265,10 @@ bool E1000NetworkAdapter::handle_irq(RegisterState const&)
     if (status & INTERRUPT_RXO) {
         dbgln_if(E1000_DEBUG, "E1000: RX buffer overrun");
     }
-    if (status & INTERRUPT_RXT0) {
-        receive();
+    if (status & receive_interrupts) {
+        // The NetworkTask takes it from here, and unmasks the interrupts once it has emptied the receive ring.
+        out32(REG_INTERRUPT_MASK_CLEAR, receive_interrupts);
+        schedule_receive_poll();
     }
 
     m_wait_queue.wake_all();
@@ -428,11 +432,29 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
 }
 
-void E1000NetworkAdapter::receive()
+bool E1000NetworkAdapter::has_received_frames()
+{
+    auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
+    auto rx_current = (in32(REG_RXDESCTAIL) + 1) % number_of_rx_descriptors;
+    return rx_descriptors[rx_current].status & 1;
+}
+
+bool E1000NetworkAdapter::enable_receive_interrupts()
+{
+    out32(REG_INTERRUPT_MASK_SET, receive_interrupts);
+    // NOTE: Another interrupt may have acknowledged the cause of a frame that arrived while we were polling.
+    if (!has_received_frames())
+        return true;
+    out32(REG_INTERRUPT_MASK_CLEAR, receive_interrupts);
+    return false;
+}
+
+size_t E1000NetworkAdapter::receive_frames(size_t budget)
 {
     auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
     u32 rx_current;
-    for (;;) {
+    size_t received = 0;
+    for (; received < budget; ++received) {
         rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
         rx_current = (rx_current + 1) % number_of_rx_descriptors;
         if (!(rx_descriptors[rx_current].status & 1))
@@ -445,6 +467,7 @@ void E1000NetworkAdapter::receive()
         rx_descriptors[rx_current].status = 0;
         out32(REG_RXDESCTAIL, rx_current);
     }
+    return received;
 }
 
 i32 E1000NetworkAdapter::link_speed()
@@ -83,7 +83,9 @@ protected:
     u16 in16(u16 address);
     u32 in32(u16 address);
 
-    void receive();
+    virtual size_t receive_frames(size_t budget) override;
+    virtual bool enable_receive_interrupts() override;
+    bool has_received_frames();
 
     static constexpr size_t number_of_rx_descriptors = 256;
     static constexpr size_t number_of_tx_descriptors = 256;
@@ -7,7 +7,7 @@
 #pragma once
 
 #include <AK/IntrusiveList.h>
-#include <Kernel/Library/DoubleBuffer.h>
+#include <Kernel/Library/PipeBuffer.h>
 #include <Kernel/Net/Socket.h>
 
 namespace Kernel {
@@ -54,12 +54,12 @@ public:
     virtual ErrorOr<void> chmod(Credentials const&, OpenFileDescription&, mode_t) override;
 
 private:
-    explicit LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer);
+    explicit LocalSocket(int type, NonnullOwnPtr<PipeBuffer> client_buffer, NonnullOwnPtr<PipeBuffer> server_buffer);
     virtual StringView class_name() const override { return "LocalSocket"sv; }
     virtual bool is_local() const override { return true; }
     bool has_attached_peer(OpenFileDescription const&) const;
-    DoubleBuffer* receive_buffer_for(OpenFileDescription&);
-    DoubleBuffer* send_buffer_for(OpenFileDescription&);
+    PipeBuffer* receive_buffer_for(OpenFileDescription&);
+    PipeBuffer* send_buffer_for(OpenFileDescription&);
     Vector<NonnullRefPtr<OpenFileDescription>>& sendfd_queue_for(OpenFileDescription const&);
     Vector<NonnullRefPtr<OpenFileDescription>>& recvfd_queue_for(OpenFileDescription const&);
 
@@ -98,8 +98,8 @@ private:
     bool m_accept_side_fd_open { false };
     OwnPtr<KString> m_path;
 
-    NonnullOwnPtr<DoubleBuffer> m_for_client;
-    NonnullOwnPtr<DoubleBuffer> m_for_server;
+    NonnullOwnPtr<PipeBuffer> m_for_client;
+    NonnullOwnPtr<PipeBuffer> m_for_server;
 
     Vector<NonnullRefPtr<OpenFileDescription>> m_fds_for_client;
     Vector<NonnullRefPtr<OpenFileDescription>> m_fds_for_server;
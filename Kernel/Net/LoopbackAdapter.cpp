@@ -6,10 +6,23 @@
 
 #include <AK/Singleton.h>
 #include <Kernel/Net/LoopbackAdapter.h>
+#include <Kernel/Security/Random.h>
 
 namespace Kernel {
 
 static bool s_loopback_initialized = false;
+static Atomic<u32> s_packet_loss_percentage { 0 };
+
+u32 LoopbackAdapter::packet_loss_percentage()
+{
+    return s_packet_loss_percentage.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+void LoopbackAdapter::set_packet_loss_percentage(u32 percentage)
+{
+    VERIFY(percentage <= 100);
+    s_packet_loss_percentage.store(percentage, AK::MemoryOrder::memory_order_relaxed);
+}
 
 ErrorOr<NonnullRefPtr<LoopbackAdapter>> LoopbackAdapter::try_create()
 {
@@ -24,14 +37,25 @@ LoopbackAdapter::LoopbackAdapter(NonnullOwnPtr<KString> interface_name)
     s_loopback_initialized = true;
     set_mtu(65536);
     set_mac_address({ 19, 85, 2, 9, 0x55, 0xaa });
+    set_offload_capabilities(OffloadCapabilities::TransmitChecksum);
 }
 
 LoopbackAdapter::~LoopbackAdapter() = default;
 
 void LoopbackAdapter::send_raw(ReadonlyBytes payload)
 {
+    if (auto loss_percentage = packet_loss_percentage(); loss_percentage > 0 && get_fast_random<u32>() % 100 < loss_percentage) {
+        dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Dropping {} byte(s) to simulate packet loss.", payload.size());
+        return;
+    }
     dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
     did_receive(payload);
 }
 
+void LoopbackAdapter::send_raw_with_offload(ReadonlyBytes payload, PacketOffload const&)
+{
+    // NOTE: Packets never leave the machine, and we don't verify checksums on receive, so there is no point in finishing them.
+    send_raw(payload);
+}
+
 }
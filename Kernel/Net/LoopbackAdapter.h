@@ -18,6 +18,10 @@ public:
     static ErrorOr<NonnullRefPtr<LoopbackAdapter>> try_create();
     virtual ~LoopbackAdapter() override;
 
+    // Randomly drop the given percentage of packets, to exercise TCP loss recovery without real hardware.
+    static u32 packet_loss_percentage();
+    static void set_packet_loss_percentage(u32);
+
     virtual ErrorOr<void> initialize(Badge<NetworkingManagement>) override { VERIFY_NOT_REACHED(); }
 
     virtual void send_raw(ReadonlyBytes) override;
@@ -26,6 +30,9 @@ public:
     virtual bool link_up() override { return true; }
     virtual bool link_full_duplex() override { return true; }
     virtual int link_speed() override { return 1000; }
+
+private:
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) override;
 };
 
 }
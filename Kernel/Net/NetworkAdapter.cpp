@@ -10,6 +10,9 @@
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/Routing.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
@@ -28,6 +31,83 @@ void NetworkAdapter::send_packet(ReadonlyBytes packet)
     send_raw(packet);
 }
 
+void NetworkAdapter::send_packet(ReadonlyBytes packet, PacketOffload const& offload)
+{
+    if (!offload.needs_checksum && offload.segment_size == 0) {
+        send_packet(packet);
+        return;
+    }
+
+    bool can_offload = (!offload.needs_checksum || has_offload_capability(OffloadCapabilities::TransmitChecksum))
+        && (offload.segment_size == 0 || has_offload_capability(OffloadCapabilities::TCPSegmentation));
+    if (!can_offload) {
+        send_packet_with_software_offload(packet, offload);
+        return;
+    }
+
+    m_packets_out++;
+    m_bytes_out += packet.size();
+    send_raw_with_offload(packet, offload);
+}
+
+void NetworkAdapter::send_packet_with_software_offload(ReadonlyBytes packet, PacketOffload const& offload)
+{
+    // NOTE: The sender may hand the same packet to us again later (e.g. to retransmit it), so we work on a copy.
+    if (offload.segment_size == 0) {
+        VERIFY(offload.checksum_start + offload.checksum_offset + sizeof(u16) <= packet.size());
+        auto copy = acquire_packet_buffer(packet.size());
+        if (!copy) {
+            dbgln("NetworkAdapter: Dropping packet because we're out of memory");
+            return;
+        }
+        memcpy(copy->buffer->data(), packet.data(), packet.size());
+        auto checksum_bytes = copy->buffer->bytes().slice(offload.checksum_start);
+        // The pseudo header checksum in the checksum field becomes part of the sum this way.
+        NetworkOrdered<u16> checksum = internet_checksum(checksum_bytes.data(), checksum_bytes.size());
+        memcpy(copy->buffer->data() + offload.checksum_start + offload.checksum_offset, &checksum, sizeof(checksum));
+        send_packet(copy->bytes());
+        release_packet_buffer(*copy);
+        return;
+    }
+
+    // Cut the packet into segments that each get a copy of the headers, like a TSO-capable adapter would.
+    auto ipv4_header_offset = layer3_payload_offset();
+    auto tcp_header_offset = ipv4_payload_offset();
+    VERIFY(offload.header_size > tcp_header_offset && offload.header_size <= packet.size());
+    auto const& original_tcp_packet = *reinterpret_cast<TCPPacket const*>(packet.data() + tcp_header_offset);
+    auto tcp_header_size = offload.header_size - tcp_header_offset;
+    auto payload = packet.slice(offload.header_size);
+
+    for (size_t offset = 0; offset < payload.size(); offset += offload.segment_size) {
+        auto segment_payload_size = min<size_t>(offload.segment_size, payload.size() - offset);
+        bool is_last_segment = offset + segment_payload_size == payload.size();
+
+        auto segment = acquire_packet_buffer(offload.header_size + segment_payload_size);
+        if (!segment) {
+            dbgln("NetworkAdapter: Dropping segment because we're out of memory");
+            return;
+        }
+        memcpy(segment->buffer->data(), packet.data(), offload.header_size);
+        memcpy(segment->buffer->data() + offload.header_size, payload.offset(offset), segment_payload_size);
+
+        auto& ipv4_packet = *reinterpret_cast<IPv4Packet*>(segment->buffer->data() + ipv4_header_offset);
+        ipv4_packet.set_length(offload.header_size - ipv4_header_offset + segment_payload_size);
+        ipv4_packet.set_checksum(0);
+        ipv4_packet.set_checksum(ipv4_packet.compute_checksum());
+
+        auto& tcp_packet = *reinterpret_cast<TCPPacket*>(segment->buffer->data() + tcp_header_offset);
+        tcp_packet.set_sequence_number(original_tcp_packet.sequence_number() + offset);
+        if (!is_last_segment)
+            tcp_packet.set_flags(original_tcp_packet.flags() & ~(TCPFlags::PSH | TCPFlags::FIN));
+        tcp_packet.set_checksum(0);
+        tcp_packet.set_checksum(TCPSocket::compute_tcp_checksum(ipv4_packet.source(), ipv4_packet.destination(), tcp_packet, segment_payload_size));
+        VERIFY(tcp_packet.header_size() == tcp_header_size);
+
+        send_packet(segment->bytes());
+        release_packet_buffer(*segment);
+    }
+}
+
 void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet)
 {
     size_t size_in_bytes = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -47,7 +127,8 @@ void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet
 void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, IPv4Protocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
 {
     size_t ipv4_packet_size = sizeof(IPv4Packet) + payload_size;
-    VERIFY(ipv4_packet_size <= mtu());
+    // NOTE: Packets that are larger than the MTU are split into segments by send_packet().
+    VERIFY(ipv4_packet_size <= NumericLimits<u16>::max());
 
     size_t ethernet_frame_size = ipv4_payload_offset() + payload_size;
     VERIFY(packet.buffer->size() == ethernet_frame_size);
@@ -95,6 +176,36 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
         on_receive();
 }
 
+void NetworkAdapter::schedule_receive_poll()
+{
+    if (m_receive_poll_scheduled.exchange(true))
+        return;
+    m_receive_poll_statistics.interrupts++;
+    if (on_receive_poll_scheduled)
+        on_receive_poll_scheduled();
+}
+
+size_t NetworkAdapter::poll_receive(size_t budget)
+{
+    if (!m_receive_poll_scheduled.exchange(false))
+        return 0;
+
+    auto count = receive_frames(budget);
+    auto& statistics = m_receive_poll_statistics;
+    statistics.polls++;
+    statistics.polled_packets += count;
+    statistics.max_batch_size = max(statistics.max_batch_size, count);
+
+    if (count == budget) {
+        // There is probably more where that came from, so stay in polling mode.
+        statistics.budget_exhausted++;
+        m_receive_poll_scheduled = true;
+    } else if (!enable_receive_interrupts()) {
+        m_receive_poll_scheduled = true;
+    }
+    return count;
+}
+
 size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
 {
     InterruptDisabler disabler;
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/MACAddress.h>
@@ -42,6 +44,27 @@ struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp>
     IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
 };
 
+// Work on an outgoing packet that is left to the adapter. If the adapter can't do it, send_packet() does it in software.
+struct PacketOffload {
+    // The internet checksum over everything from checksum_start to the end of the packet has to be stored at
+    // checksum_start + checksum_offset. That field already holds the (uncomplemented) checksum of the pseudo header.
+    bool needs_checksum { false };
+    u16 checksum_start { 0 };
+    u16 checksum_offset { 0 };
+
+    // If non-zero, this is a TCP/IPv4 packet that is larger than the MTU, and its payload (everything after
+    // the first header_size bytes) has to be split into segments of at most segment_size bytes.
+    u16 segment_size { 0 };
+    u16 header_size { 0 };
+};
+
+enum class OffloadCapabilities : u8 {
+    None = 0,
+    TransmitChecksum = 1 << 0,
+    TCPSegmentation = 1 << 1,
+};
+AK_ENUM_BITWISE_OPERATORS(OffloadCapabilities);
+
 class NetworkingManagement;
 class NetworkAdapter
     : public AtomicRefCounted<NetworkAdapter>
@@ -86,6 +109,9 @@ public:
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
 
+    OffloadCapabilities offload_capabilities() const { return m_offload_capabilities; }
+    bool has_offload_capability(OffloadCapabilities capability) const { return has_flag(m_offload_capabilities, capability); }
+
     u32 packets_in() const { return m_packets_in; }
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
@@ -98,16 +124,46 @@ public:
     constexpr size_t ipv4_payload_offset() const { return layer3_payload_offset() + sizeof(IPv4Packet); }
 
     Function<void()> on_receive;
+    Function<void()> on_receive_poll_scheduled;
+
+    struct ReceivePollStatistics {
+        // How often a receive interrupt switched the adapter over to polling.
+        u64 interrupts { 0 };
+        u64 polls { 0 };
+        u64 polled_packets { 0 };
+        u64 max_batch_size { 0 };
+        // How often a poll used up its whole budget, so the adapter stayed in polling mode.
+        u64 budget_exhausted { 0 };
+    };
+    ReceivePollStatistics const& receive_poll_statistics() const { return m_receive_poll_statistics; }
+
+    bool is_receive_poll_scheduled() const { return m_receive_poll_scheduled; }
+    // Called by the NetworkTask: takes up to `budget` frames from the adapter if a poll was scheduled.
+    size_t poll_receive(size_t budget);
 
     void send_packet(ReadonlyBytes);
+    void send_packet(ReadonlyBytes, PacketOffload const&);
 
 protected:
     NetworkAdapter(NonnullOwnPtr<KString>);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
+    void set_offload_capabilities(OffloadCapabilities capabilities) { m_offload_capabilities = capabilities; }
     void did_receive(ReadonlyBytes);
     virtual void send_raw(ReadonlyBytes) = 0;
+    // Only called for offloads that are covered by offload_capabilities().
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) { VERIFY_NOT_REACHED(); }
+
+    // Adapters that support receive polling mask their receive interrupts in their interrupt handler and
+    // call schedule_receive_poll(). The NetworkTask then takes the received frames out of the adapter
+    // in batches, and only once it has caught up are the receive interrupts unmasked again.
+    void schedule_receive_poll();
+    virtual size_t receive_frames(size_t) { VERIFY_NOT_REACHED(); }
+    // Returns false if more frames arrived in the meantime, in which case the interrupts stay masked.
+    virtual bool enable_receive_interrupts() { VERIFY_NOT_REACHED(); }
 
 private:
+    void send_packet_with_software_offload(ReadonlyBytes, PacketOffload const&);
+
     MACAddress m_mac_address;
     IPv4Address m_ipv4_address;
     IPv4Address m_ipv4_netmask;
@@ -126,6 +182,9 @@ private:
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
+    OffloadCapabilities m_offload_capabilities { OffloadCapabilities::None };
+    Atomic<bool> m_receive_poll_scheduled { false };
+    ReceivePollStatistics m_receive_poll_statistics;
 };
 
 }
@@ -25,6 +25,7 @@
 
 namespace Kernel {
 
+static void handle_packet(u8 const* buffer, size_t packet_size, UnixDateTime const& packet_timestamp);
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size);
 static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, UnixDateTime const& packet_timestamp);
 static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, UnixDateTime const& packet_timestamp);
@@ -35,6 +36,11 @@ static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_pac
 static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
+// How many frames a single poll may take out of an adapter.
+static constexpr size_t receive_poll_budget = 64;
+// How many queued packets we process before we go back to checking timers and polling the adapters.
+static constexpr size_t max_packets_per_batch = 64;
+
 static Thread* network_task = nullptr;
 static HashTable<NonnullRefPtr<TCPSocket>>* delayed_ack_sockets;
 
@@ -72,8 +78,21 @@ void NetworkTask_main(void*)
             pending_packets++;
             packet_wait_queue.wake_all();
         };
+        adapter.on_receive_poll_scheduled = [&]() {
+            packet_wait_queue.wake_all();
+        };
     });
 
+    auto poll_adapters = [] {
+        bool any_poll_scheduled = false;
+        NetworkingManagement::the().for_each([&](auto& adapter) {
+            adapter.poll_receive(receive_poll_budget);
+            if (adapter.is_receive_poll_scheduled())
+                any_poll_scheduled = true;
+        });
+        return any_poll_scheduled;
+    };
+
     auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp) -> size_t {
         if (pending_packets == 0)
             return 0;
@@ -99,36 +118,48 @@ void NetworkTask_main(void*)
     for (;;) {
         flush_delayed_tcp_acks();
         retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
+        bool any_poll_scheduled = poll_adapters();
+
+        size_t packets_processed = 0;
+        for (; packets_processed < max_packets_per_batch; ++packets_processed) {
+            size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
+            if (!packet_size)
+                break;
+            handle_packet(buffer, packet_size, packet_timestamp);
+        }
+
+        if (packets_processed == 0 && !any_poll_scheduled) {
             auto timeout_time = Duration::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
             [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
-            continue;
-        }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
-            break;
-        case EtherType::IPv6:
-            // ignore
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
         }
     }
 }
 
+void handle_packet(u8 const* buffer, size_t packet_size, UnixDateTime const& packet_timestamp)
+{
+    if (packet_size < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)buffer;
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, packet_size);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, packet_size, packet_timestamp);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
+}
+
 void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
 {
     constexpr size_t minimum_arp_frame_size = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
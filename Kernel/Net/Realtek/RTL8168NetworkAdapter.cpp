@@ -82,6 +82,8 @@ namespace Kernel {
 #define INT_RX_FIFO_OVERFLOW 0x40
 #define INT_SYS_ERR 0x8000
 
+static constexpr u16 receive_interrupts = INT_RXOK | INT_RX_OVERFLOW | INT_RX_FIFO_OVERFLOW;
+
 #define CFG9346_NONE 0x00
 #define CFG9346_EEM0 0x40
 #define CFG9346_EEM1 0x80
@@ -399,6 +401,7 @@ void RTL8168NetworkAdapter::startup()
         enabled_interrupts |= INT_RX_FIFO_OVERFLOW;
         enabled_interrupts &= ~INT_RX_OVERFLOW;
     }
+    m_enabled_interrupts = enabled_interrupts;
     out16(REG_IMR, enabled_interrupts);
 
     // update link status
@@ -1144,9 +1147,11 @@ bool RTL8168NetworkAdapter::handle_irq(RegisterState const&)
             break;
 
         was_handled = true;
-        if (status & INT_RXOK) {
+        if (status & receive_interrupts) {
+            // The NetworkTask takes it from here, and unmasks the interrupts once it has emptied the receive ring.
             dbgln_if(RTL8168_DEBUG, "RTL8168: RX ready");
-            receive();
+            out16(REG_IMR, m_enabled_interrupts & ~receive_interrupts);
+            schedule_receive_poll();
         }
         if (status & INT_RXERR) {
             dbgln_if(RTL8168_DEBUG, "RTL8168: RX error - invalid packet");
@@ -1160,7 +1165,6 @@ bool RTL8168NetworkAdapter::handle_irq(RegisterState const&)
         }
         if (status & INT_RX_OVERFLOW) {
             dmesgln_pci(*this, "RX descriptor unavailable (packet lost)");
-            receive();
         }
         if (status & INT_LINK_CHANGE) {
             m_link_up = (in8(REG_PHYSTATUS) & PHY_LINK_STATUS) != 0;
@@ -1168,7 +1172,6 @@ bool RTL8168NetworkAdapter::handle_irq(RegisterState const&)
         }
         if (status & INT_RX_FIFO_OVERFLOW) {
             dmesgln_pci(*this, "RX FIFO overflow");
-            receive();
         }
         if (status & INT_SYS_ERR) {
             dmesgln_pci(*this, "Fatal system error");
@@ -1223,17 +1226,32 @@ void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
     out8(REG_TXSTART, TXSTART_START); // FIXME: this shouldn't be done so often, we should look into doing this using the watchdog timer
 }
 
-void RTL8168NetworkAdapter::receive()
+bool RTL8168NetworkAdapter::has_received_frames()
+{
+    auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
+    return (rx_descriptors[m_rx_free_index].flags & RXDescriptor::Ownership) == 0;
+}
+
+bool RTL8168NetworkAdapter::enable_receive_interrupts()
+{
+    out16(REG_IMR, m_enabled_interrupts);
+    // NOTE: The interrupt handler may have acknowledged the status of a frame that arrived while we were polling.
+    if (!has_received_frames())
+        return true;
+    out16(REG_IMR, m_enabled_interrupts & ~receive_interrupts);
+    return false;
+}
+
+size_t RTL8168NetworkAdapter::receive_frames(size_t budget)
 {
     auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
-    for (u16 i = 0; i < number_of_rx_descriptors; ++i) {
-        auto descriptor_index = (m_rx_free_index + i) % number_of_rx_descriptors;
+    size_t received = 0;
+    for (; received < budget; ++received) {
+        auto descriptor_index = m_rx_free_index;
         auto& descriptor = rx_descriptors[descriptor_index];
 
-        if ((descriptor.flags & RXDescriptor::Ownership) != 0) {
-            m_rx_free_index = descriptor_index;
+        if ((descriptor.flags & RXDescriptor::Ownership) != 0)
             break;
-        }
 
         u16 flags = descriptor.flags;
         u16 length = descriptor.buffer_size & 0x3FFF;
@@ -1255,7 +1273,9 @@ void RTL8168NetworkAdapter::receive()
         if (descriptor_index == number_of_rx_descriptors - 1)
             flags |= RXDescriptor::EndOfRing;
         descriptor.flags = flags; // let the NIC know it can use this descriptor again
+        m_rx_free_index = (descriptor_index + 1) % number_of_rx_descriptors;
     }
+    return received;
 }
 
 void RTL8168NetworkAdapter::out8(u16 address, u8 data)
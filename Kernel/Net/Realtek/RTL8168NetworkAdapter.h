@@ -151,7 +151,9 @@ private:
     void initialize_rx_descriptors();
     void initialize_tx_descriptors();
 
-    void receive();
+    virtual size_t receive_frames(size_t budget) override;
+    virtual bool enable_receive_interrupts() override;
+    bool has_received_frames();
 
     void out8(u16 address, u8 data);
     void out16(u16 address, u16 data);
@@ -206,6 +208,7 @@ private:
     OwnPtr<Memory::Region> m_rx_descriptors_region;
     Vector<NonnullOwnPtr<Memory::Region>> m_rx_buffers_regions;
     u16 m_rx_free_index { 0 };
+    u16 m_enabled_interrupts { 0 };
     OwnPtr<Memory::Region> m_tx_descriptors_region;
     Vector<NonnullOwnPtr<Memory::Region>> m_tx_buffers_regions;
     u16 m_tx_free_index { 0 };
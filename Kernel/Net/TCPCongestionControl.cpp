@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/Debug.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+static Atomic<TCPCongestionControlAlgorithm> s_default_algorithm { TCPCongestionControlAlgorithm::NewReno };
+
+static inline bool sequence_number_is_at_or_after(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) >= 0;
+}
+
+void TCPRoundTripTimeEstimator::add_sample(Duration sample)
+{
+    auto sample_ns = sample.to_nanoseconds();
+    if (sample_ns < 0)
+        return;
+
+    auto smoothed_ns = m_smoothed_round_trip_time.to_nanoseconds();
+    auto variance_ns = m_round_trip_time_variance.to_nanoseconds();
+
+    if (!m_has_sample) {
+        // RFC 6298 (2.2): When the first RTT measurement R is made, the host MUST set
+        // SRTT <- R, RTTVAR <- R/2
+        smoothed_ns = sample_ns;
+        variance_ns = sample_ns / 2;
+        m_has_sample = true;
+    } else {
+        // RFC 6298 (2.3): When a subsequent RTT measurement R' is made, a host MUST set
+        // RTTVAR <- (1 - beta) * RTTVAR + beta * |SRTT - R'|, SRTT <- (1 - alpha) * SRTT + alpha * R'
+        // with alpha = 1/8 and beta = 1/4.
+        auto difference_ns = smoothed_ns - sample_ns;
+        if (difference_ns < 0)
+            difference_ns = -difference_ns;
+        variance_ns = (3 * variance_ns + difference_ns) / 4;
+        smoothed_ns = (7 * smoothed_ns + sample_ns) / 8;
+    }
+
+    m_smoothed_round_trip_time = Duration::from_nanoseconds(smoothed_ns);
+    m_round_trip_time_variance = Duration::from_nanoseconds(variance_ns);
+
+    // RTO <- SRTT + max (G, K*RTTVAR) where K = 4. Our clock granularity is well below the minimum RTO.
+    auto timeout = Duration::from_nanoseconds(smoothed_ns + 4 * variance_ns);
+    m_retransmission_timeout = clamp(timeout, minimum_retransmission_timeout, maximum_retransmission_timeout);
+}
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(TCPCongestionControlAlgorithm algorithm, u32 maximum_segment_size)
+{
+    switch (algorithm) {
+    case TCPCongestionControlAlgorithm::NewReno:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPNewRenoCongestionControl(maximum_segment_size)));
+    case TCPCongestionControlAlgorithm::Cubic:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPCubicCongestionControl(maximum_segment_size)));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControlAlgorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "newreno"sv || name == "reno"sv)
+        return TCPCongestionControlAlgorithm::NewReno;
+    if (name == "cubic"sv)
+        return TCPCongestionControlAlgorithm::Cubic;
+    return {};
+}
+
+StringView TCPCongestionControl::name_of(TCPCongestionControlAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case TCPCongestionControlAlgorithm::NewReno:
+        return "newreno"sv;
+    case TCPCongestionControlAlgorithm::Cubic:
+        return "cubic"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+TCPCongestionControlAlgorithm TCPCongestionControl::default_algorithm()
+{
+    return s_default_algorithm.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+void TCPCongestionControl::set_default_algorithm(TCPCongestionControlAlgorithm algorithm)
+{
+    s_default_algorithm.store(algorithm, AK::MemoryOrder::memory_order_relaxed);
+}
+
+TCPCongestionControl::TCPCongestionControl(u32 maximum_segment_size)
+    : m_maximum_segment_size(maximum_segment_size)
+{
+    VERIFY(m_maximum_segment_size > 0);
+    m_congestion_window = initial_window();
+}
+
+u32 TCPCongestionControl::initial_window() const
+{
+    // RFC 3390: min (4*MSS, max (2*MSS, 4380 bytes))
+    return min(4 * m_maximum_segment_size, max(2 * m_maximum_segment_size, 4380u));
+}
+
+void TCPCongestionControl::set_maximum_segment_size(u32 maximum_segment_size)
+{
+    VERIFY(maximum_segment_size > 0);
+    if (maximum_segment_size == m_maximum_segment_size)
+        return;
+
+    // If nothing has happened on this connection yet, start over with an initial window
+    // based on the actual segment size instead of our guess.
+    bool is_untouched = m_congestion_window == initial_window() && !m_in_fast_recovery;
+    m_maximum_segment_size = maximum_segment_size;
+    if (is_untouched)
+        m_congestion_window = initial_window();
+    m_congestion_window = max(m_congestion_window, m_maximum_segment_size);
+}
+
+bool TCPCongestionControl::on_new_ack(u32 ack_number, u32 bytes_acked, Duration smoothed_round_trip_time)
+{
+    m_duplicate_ack_count = 0;
+
+    if (m_in_fast_recovery) {
+        if (sequence_number_is_at_or_after(ack_number, m_recovery_point)) {
+            // RFC 6582 (3.2 step 3): Full acknowledgment, deflate the window and leave fast recovery.
+            m_in_fast_recovery = false;
+            m_congestion_window = max(m_slow_start_threshold, m_maximum_segment_size);
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPCongestionControl: Leaving fast recovery, cwnd={}", m_congestion_window);
+            return false;
+        }
+
+        // RFC 6582 (3.2 step 3): Partial acknowledgment. Retransmit the first unacknowledged segment,
+        // deflate the window by the amount of new data acknowledged and add back one MSS if that was
+        // at least a full segment.
+        m_congestion_window -= min(m_congestion_window, bytes_acked);
+        if (bytes_acked >= m_maximum_segment_size)
+            m_congestion_window += m_maximum_segment_size;
+        m_congestion_window = max(m_congestion_window, m_maximum_segment_size);
+        return true;
+    }
+
+    if (is_in_slow_start()) {
+        // RFC 5681 (3.1): During slow start, a TCP increments cwnd by at most SMSS bytes for each ACK
+        // received that cumulatively acknowledges new data.
+        m_congestion_window += min(bytes_acked, m_maximum_segment_size);
+        return false;
+    }
+
+    increase_window_in_congestion_avoidance(bytes_acked, smoothed_round_trip_time);
+    return false;
+}
+
+bool TCPCongestionControl::on_duplicate_ack(u32 bytes_in_flight, u32 highest_sequence_number_sent)
+{
+    if (m_in_fast_recovery) {
+        // RFC 5681 (3.2 step 4): For each additional duplicate ACK received, increment cwnd by SMSS.
+        m_congestion_window += m_maximum_segment_size;
+        return false;
+    }
+
+    if (++m_duplicate_ack_count < duplicate_ack_threshold)
+        return false;
+
+    // RFC 6582 (3.2 step 2): Enter fast retransmit. Remember the highest sequence number transmitted
+    // so we know when all data outstanding at the time of the loss has been acknowledged.
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight);
+    m_congestion_window = m_slow_start_threshold + duplicate_ack_threshold * m_maximum_segment_size;
+    m_in_fast_recovery = true;
+    m_recovery_point = highest_sequence_number_sent;
+    m_duplicate_ack_count = 0;
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPCongestionControl: Entering fast recovery, ssthresh={}, cwnd={}", m_slow_start_threshold, m_congestion_window);
+    return true;
+}
+
+void TCPCongestionControl::on_retransmission_timeout(u32 bytes_in_flight)
+{
+    // RFC 5681 (3.1): When a TCP sender detects segment loss using the retransmission timer, ssthresh is
+    // reduced and the loss window, LW, is set to one full-sized segment.
+    // A second timeout for the same segment must not reduce ssthresh any further.
+    if (!m_in_fast_recovery && m_congestion_window > m_maximum_segment_size)
+        m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight);
+    m_congestion_window = m_maximum_segment_size;
+    m_in_fast_recovery = false;
+    m_duplicate_ack_count = 0;
+    did_collapse_window();
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPCongestionControl: Retransmission timeout, ssthresh={}, cwnd={}", m_slow_start_threshold, m_congestion_window);
+}
+
+void TCPNewRenoCongestionControl::increase_window_in_congestion_avoidance(u32 bytes_acked, Duration)
+{
+    // RFC 5681 (3.1): Increase cwnd by one MSS for every cwnd bytes acknowledged ("appropriate byte counting").
+    m_bytes_acked_in_window += bytes_acked;
+    if (m_bytes_acked_in_window >= m_congestion_window) {
+        m_bytes_acked_in_window -= m_congestion_window;
+        m_congestion_window += m_maximum_segment_size;
+    }
+}
+
+u32 TCPNewRenoCongestionControl::slow_start_threshold_after_loss(u32 bytes_in_flight)
+{
+    m_bytes_acked_in_window = 0;
+    // RFC 5681 (4): ssthresh = max (FlightSize / 2, 2*SMSS)
+    return max(bytes_in_flight / 2, 2 * m_maximum_segment_size);
+}
+
+static u64 integer_cube_root(u64 value)
+{
+    u64 root = 0;
+    for (int shift = 63; shift >= 0; shift -= 3) {
+        root *= 2;
+        u64 bit = 3 * root * (root + 1) + 1;
+        if ((value >> shift) >= bit) {
+            value -= bit << shift;
+            ++root;
+        }
+    }
+    return root;
+}
+
+// RFC 8312 (5): C = 0.4 and beta_cubic = 0.7, expressed as fractions here.
+static constexpr u64 cubic_beta_numerator = 7;
+static constexpr u64 cubic_beta_denominator = 10;
+
+void TCPCubicCongestionControl::increase_window_in_congestion_avoidance(u32 bytes_acked, Duration smoothed_round_trip_time)
+{
+    auto now = TimeManagement::the().monotonic_time();
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        if (m_congestion_window < m_window_max) {
+            // K = cubic_root((W_max - cwnd) / C), with the window in segments and K in seconds.
+            // Scaled to milliseconds: cubic_root((W_max - cwnd) / MSS * 10^9 / 0.4)
+            u64 window_deficit = m_window_max - m_congestion_window;
+            m_time_to_window_max_ms = integer_cube_root(window_deficit * 2'500'000'000ull / m_maximum_segment_size);
+        } else {
+            m_time_to_window_max_ms = 0;
+            m_window_max = m_congestion_window;
+        }
+        m_reno_window_estimate = m_congestion_window;
+        m_reno_bytes_acked = 0;
+    }
+
+    // RFC 8312 (4.1): W_cubic(t + RTT) = C * (t + RTT - K)^3 + W_max
+    i64 elapsed_ms = (now - m_epoch_start.value()).to_milliseconds() + smoothed_round_trip_time.to_milliseconds();
+    i64 offset_ms = clamp(elapsed_ms - static_cast<i64>(m_time_to_window_max_ms), static_cast<i64>(-1'000'000), static_cast<i64>(1'000'000));
+    // C * offset^3 in segments is offset_ms^3 / (2.5 * 10^9). Divide in two steps to stay within 64 bits.
+    i64 cubic_offset = (offset_ms * offset_ms * offset_ms / 2'500'000) * static_cast<i64>(m_maximum_segment_size) / 1000;
+    i64 target = static_cast<i64>(m_window_max) + cubic_offset;
+
+    // RFC 8312 (4.1): The target is limited to 1.5 * cwnd to avoid bursts.
+    target = clamp(target, static_cast<i64>(m_congestion_window), static_cast<i64>(m_congestion_window) * 3 / 2);
+
+    // RFC 8312 (4.2): In the TCP-friendly region, follow the window a standard TCP would have,
+    // which grows by 3 * (1 - beta) / (1 + beta) segments per round trip.
+    m_reno_bytes_acked += bytes_acked;
+    if (m_reno_bytes_acked >= m_reno_window_estimate) {
+        m_reno_bytes_acked -= m_reno_window_estimate;
+        m_reno_window_estimate += m_maximum_segment_size * 3 * (cubic_beta_denominator - cubic_beta_numerator) / (cubic_beta_denominator + cubic_beta_numerator);
+    }
+    if (static_cast<i64>(m_reno_window_estimate) > target)
+        target = m_reno_window_estimate;
+
+    if (target > static_cast<i64>(m_congestion_window)) {
+        u64 increment = (static_cast<u64>(target) - m_congestion_window) * bytes_acked / m_congestion_window;
+        m_congestion_window += max(static_cast<u32>(min(increment, static_cast<u64>(m_maximum_segment_size))), 1u);
+    }
+}
+
+u32 TCPCubicCongestionControl::slow_start_threshold_after_loss(u32)
+{
+    // RFC 8312 (4.6): With fast convergence, release bandwidth to new flows by lowering W_max
+    // further if the window didn't get back to the previous maximum.
+    if (m_congestion_window < m_window_max)
+        m_window_max = static_cast<u32>(static_cast<u64>(m_congestion_window) * (cubic_beta_denominator + cubic_beta_numerator) / (2 * cubic_beta_denominator));
+    else
+        m_window_max = m_congestion_window;
+    m_epoch_start.clear();
+
+    // RFC 8312 (4.5): ssthresh = cwnd * beta_cubic
+    auto reduced_window = static_cast<u32>(static_cast<u64>(m_congestion_window) * cubic_beta_numerator / cubic_beta_denominator);
+    return max(reduced_window, 2 * m_maximum_segment_size);
+}
+
+void TCPCubicCongestionControl::did_collapse_window()
+{
+    m_epoch_start.clear();
+}
+
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+enum class TCPCongestionControlAlgorithm {
+    NewReno,
+    Cubic,
+};
+
+// Round-trip time estimation and retransmission timeout calculation as described in RFC 6298.
+class TCPRoundTripTimeEstimator {
+public:
+    // RFC 6298 (2.4): Whenever RTO is computed, if it is less than 1 second, then the RTO SHOULD be rounded up to 1 second.
+    static constexpr Duration minimum_retransmission_timeout = Duration::from_seconds(1);
+    static constexpr Duration maximum_retransmission_timeout = Duration::from_seconds(60);
+    static constexpr Duration initial_retransmission_timeout = Duration::from_seconds(1);
+
+    void add_sample(Duration);
+
+    bool has_sample() const { return m_has_sample; }
+    Duration smoothed_round_trip_time() const { return m_smoothed_round_trip_time; }
+    Duration round_trip_time_variance() const { return m_round_trip_time_variance; }
+    Duration retransmission_timeout() const { return m_retransmission_timeout; }
+
+private:
+    bool m_has_sample { false };
+    Duration m_smoothed_round_trip_time;
+    Duration m_round_trip_time_variance;
+    Duration m_retransmission_timeout { initial_retransmission_timeout };
+};
+
+// The congestion window bookkeeping and the NewReno fast recovery state machine (RFC 5681, RFC 6582)
+// live in this base class. Subclasses decide how the window grows while no loss is observed and how
+// far it shrinks once a loss is detected.
+class TCPCongestionControl {
+public:
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(TCPCongestionControlAlgorithm, u32 maximum_segment_size);
+    static Optional<TCPCongestionControlAlgorithm> algorithm_from_name(StringView);
+    static StringView name_of(TCPCongestionControlAlgorithm);
+
+    static TCPCongestionControlAlgorithm default_algorithm();
+    static void set_default_algorithm(TCPCongestionControlAlgorithm);
+
+    // RFC 5681 (3.2): The fast retransmit algorithm uses the arrival of 3 duplicate ACKs as an indication that a segment has been lost.
+    static constexpr u32 duplicate_ack_threshold = 3;
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual TCPCongestionControlAlgorithm algorithm() const = 0;
+    StringView name() const { return name_of(algorithm()); }
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 maximum_segment_size() const { return m_maximum_segment_size; }
+    bool is_in_slow_start() const { return m_congestion_window < m_slow_start_threshold; }
+    bool is_in_fast_recovery() const { return m_in_fast_recovery; }
+
+    void set_maximum_segment_size(u32);
+
+    // Called for every ACK that acknowledges new data. Returns true if we are in fast recovery and the ACK
+    // was a partial acknowledgement, in which case the first unacknowledged segment has to be retransmitted.
+    bool on_new_ack(u32 ack_number, u32 bytes_acked, Duration smoothed_round_trip_time);
+
+    // Called for every duplicate ACK. Returns true if the first unacknowledged segment should be retransmitted.
+    bool on_duplicate_ack(u32 bytes_in_flight, u32 highest_sequence_number_sent);
+
+    void on_retransmission_timeout(u32 bytes_in_flight);
+
+protected:
+    explicit TCPCongestionControl(u32 maximum_segment_size);
+
+    // Grow the window for bytes_acked newly acknowledged bytes while in congestion avoidance.
+    virtual void increase_window_in_congestion_avoidance(u32 bytes_acked, Duration smoothed_round_trip_time) = 0;
+
+    // Compute the new slow start threshold after a loss has been detected.
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight) = 0;
+
+    // Called after a retransmission timeout collapsed the window to a single segment.
+    virtual void did_collapse_window() { }
+
+    u32 m_maximum_segment_size { 0 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+
+private:
+    u32 initial_window() const;
+
+    u32 m_duplicate_ack_count { 0 };
+    bool m_in_fast_recovery { false };
+    u32 m_recovery_point { 0 };
+};
+
+class TCPNewRenoCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPNewRenoCongestionControl(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual TCPCongestionControlAlgorithm algorithm() const override { return TCPCongestionControlAlgorithm::NewReno; }
+
+private:
+    virtual void increase_window_in_congestion_avoidance(u32 bytes_acked, Duration smoothed_round_trip_time) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight) override;
+
+    u32 m_bytes_acked_in_window { 0 };
+};
+
+// CUBIC as described in RFC 8312, using integer arithmetic only.
+class TCPCubicCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPCubicCongestionControl(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual TCPCongestionControlAlgorithm algorithm() const override { return TCPCongestionControlAlgorithm::Cubic; }
+
+private:
+    virtual void increase_window_in_congestion_avoidance(u32 bytes_acked, Duration smoothed_round_trip_time) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight) override;
+    virtual void did_collapse_window() override;
+
+    // Window size (in bytes) just before the last reduction.
+    u32 m_window_max { 0 };
+    // Time (in milliseconds) it takes the cubic function to grow back to m_window_max.
+    u64 m_time_to_window_max_ms { 0 };
+    Optional<MonotonicTime> m_epoch_start;
+    // Estimate of the window a standard TCP would have, used for the "TCP-friendly" region.
+    u32 m_reno_window_estimate { 0 };
+    u32 m_reno_bytes_acked { 0 };
+};
+
+}
@@ -19,6 +19,7 @@
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/Tracepoints.h>
 
 namespace Kernel {
 
@@ -57,6 +58,7 @@ bool TCPSocket::unref() const
 void TCPSocket::set_state(State new_state)
 {
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) state moving from {} to {}", this, to_string(m_state), to_string(new_state));
+    Tracepoints::hit(TracepointID::TCPStateChange, local_address().to_u32(), peer_address().to_u32(), (local_port() << 16) | peer_port(), to_underlying(m_state), to_underlying(new_state));
 
     auto was_disconnected = protocol_is_disconnected();
     auto previous_role = m_role;
@@ -162,10 +164,11 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+    , m_congestion_control(move(congestion_control))
 {
-    m_last_retransmit_time = kgettimeofday();
+    m_retransmit_timer_start = kgettimeofday();
 }
 
 TCPSocket::~TCPSocket()
@@ -179,7 +182,10 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwn
 {
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer)));
+    // NOTE: We don't know the MSS until we have a route to the peer, so start out with the
+    //       default MSS from RFC 879 and adjust once we do.
+    auto congestion_control = TRY(TCPCongestionControl::try_create(TCPCongestionControl::default_algorithm(), 536));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -207,7 +213,18 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
     size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-    data_length = min(data_length, mss);
+    bool can_segment = routing_decision.adapter->has_offload_capability(OffloadCapabilities::TCPSegmentation);
+    size_t max_packet_payload_size = m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        m_congestion_control->set_maximum_segment_size(mss);
+        if (!can_segment)
+            return mss;
+        // The adapter will cut this into segments of mss bytes for us, so hand it as much as the windows
+        // allow in one go. We still send whole segments, so that we don't end up with a runt at the end.
+        size_t window_size = min(m_send_window_size, m_congestion_control->congestion_window());
+        size_t available = min(window_size - min(window_size, unacked_packets.size), NumericLimits<u16>::max() - sizeof(IPv4Packet) - sizeof(TCPPacket));
+        return max(mss, available / mss * mss);
+    });
+    data_length = min(data_length, max_packet_payload_size);
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
@@ -274,18 +291,35 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    PacketOffload offload;
+    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    if (payload_size > mss) {
+        offload.segment_size = mss;
+        offload.header_size = ipv4_payload_offset + tcp_header_size;
+    }
+    if (routing_decision.adapter->has_offload_capability(OffloadCapabilities::TransmitChecksum)) {
+        // The adapter finishes the checksum, we only provide the part that covers the pseudo header.
+        tcp_packet.set_checksum(compute_tcp_pseudo_header_checksum(local_address(), peer_address(), tcp_header_size + payload_size));
+        offload.needs_checksum = true;
+        offload.checksum_start = ipv4_payload_offset;
+        offload.checksum_offset = 16; // The offset of the checksum field in the TCP header.
+    } else {
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    }
 
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            bool was_empty = unacked_packets.packets.is_empty();
+            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter, 0, kgettimeofday(), false, offload });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
                 return;
             }
+            if (was_empty)
+                m_retransmit_timer_start = kgettimeofday();
             unacked_packets.size += payload_size;
             enqueue_for_retransmit();
         });
@@ -295,7 +329,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     m_packets_out++;
     m_bytes_out += buffer_size;
-    routing_decision.adapter->send_packet(packet->bytes());
+    routing_decision.adapter->send_packet(packet->bytes(), offload);
     if (!expect_ack)
         routing_decision.adapter->release_packet_buffer(*packet);
 
@@ -309,8 +343,29 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
+        // RFC 5681 (2): An ACK is a duplicate if it carries no data, has neither SYN nor FIN set,
+        // acknowledges the same data as the previous ACK and there is outstanding data.
+        // FIXME: Also require the advertised window to be unchanged once we track the peer's window properly.
+        bool is_duplicate_ack = m_last_ack_number_received == ack_number
+            && size == packet.header_size()
+            && !packet.has_syn() && !packet.has_fin();
+        m_last_ack_number_received = ack_number;
+
         int removed = 0;
+        size_t bytes_acked = 0;
+        Optional<UnixDateTime> rtt_sample_sent_time;
+        Optional<RetransmitLimit> retransmit_limit;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            if (is_duplicate_ack && !unacked_packets.packets.is_empty()) {
+                if (m_congestion_control->on_duplicate_ack(unacked_packets.size, m_sequence_number)) {
+                    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: Fast retransmit of {}", unacked_packets.packets.first().ack_number);
+                    ++m_fast_retransmits;
+                    mark_for_retransmit(unacked_packets, unacked_packets.packets.first());
+                    retransmit_limit = RetransmitLimit::OneSegment;
+                }
+                return;
+            }
+
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
@@ -326,6 +381,12 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
                     }
                     auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
                     unacked_packets.size -= payload_size;
+                    bytes_acked += payload_size;
+                    // Karn's algorithm: Never take RTT samples from retransmitted segments.
+                    if (packet.tx_counter == 0)
+                        rtt_sample_sent_time = packet.sent_time;
+                    if (packet.needs_retransmit)
+                        --unacked_packets.marked_for_retransmit;
                     evaluate_block_conditions();
                     unacked_packets.packets.take_first();
                     removed++;
@@ -334,13 +395,34 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
                 }
             }
 
+            if (removed == 0)
+                return;
+
+            auto now = kgettimeofday();
+            if (rtt_sample_sent_time.has_value())
+                m_round_trip_time_estimator.add_sample(now - rtt_sample_sent_time.value());
+
+            bool retransmit_first = m_congestion_control->on_new_ack(ack_number, bytes_acked, m_round_trip_time_estimator.smoothed_round_trip_time());
+            m_retransmit_attempts = 0;
+
             if (unacked_packets.packets.is_empty()) {
-                m_retransmit_attempts = 0;
                 dequeue_for_retransmit();
+            } else {
+                m_retransmit_timer_start = now;
+                if (retransmit_first) {
+                    ++m_fast_retransmits;
+                    mark_for_retransmit(unacked_packets, unacked_packets.packets.first());
+                }
+                // Continue resending anything still marked after a retransmission timeout, paced by the congestion window.
+                if (unacked_packets.marked_for_retransmit > 0)
+                    retransmit_limit = RetransmitLimit::CongestionWindow;
             }
 
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
+
+        if (retransmit_limit.has_value())
+            retransmit_marked_packets(*retransmit_limit);
     }
 
     m_packets_in++;
@@ -363,7 +445,7 @@ bool TCPSocket::should_delay_next_ack() const
     return true;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+u16 TCPSocket::compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_packet_size)
 {
     union PseudoHeader {
         struct [[gnu::packed]] {
@@ -377,11 +459,7 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
     };
     static_assert(sizeof(PseudoHeader) == 12);
 
-    Checked<u16> packet_size = packet.header_size();
-    packet_size += payload_size;
-    VERIFY(!packet_size.has_overflow());
-
-    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)IPv4Protocol::TCP, packet_size.value() } };
+    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)IPv4Protocol::TCP, tcp_packet_size } };
 
     u32 checksum = 0;
     auto* raw_pseudo_header = pseudo_header.raw;
@@ -390,6 +468,16 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
         if (checksum > 0xffff)
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
+    return checksum;
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+{
+    Checked<u16> packet_size = packet.header_size();
+    packet_size += payload_size;
+    VERIFY(!packet_size.has_overflow());
+
+    u32 checksum = compute_tcp_pseudo_header_checksum(source, destination, packet_size.value());
     auto* raw_packet = bit_cast<u16*>(&packet);
     for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
         checksum += AK::convert_between_host_and_network_endian(raw_packet[i]);
@@ -583,18 +671,18 @@ void TCPSocket::retransmit_packets()
 {
     auto now = kgettimeofday();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+    // RFC6298 says we should use the estimated retransmission timeout (which is at least one second)
+    // between retransmits. According to RFC1122 we must do exponential backoff - even for SYN packets.
+    auto retransmit_timeout = m_round_trip_time_estimator.retransmission_timeout();
+    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts && retransmit_timeout < TCPRoundTripTimeEstimator::maximum_retransmission_timeout; i++)
+        retransmit_timeout += retransmit_timeout;
 
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (m_retransmit_timer_start > now - retransmit_timeout)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
-    m_last_retransmit_time = now;
+    m_retransmit_timer_start = now;
     ++m_retransmit_attempts;
 
     if (m_retransmit_attempts > maximum_retransmits) {
@@ -604,47 +692,96 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
+    bool has_unacked_packets = m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (unacked_packets.packets.is_empty())
+            return false;
+
+        // RFC 5681 (3.1): The window collapses to a single segment. Everything that is still outstanding
+        // gets sent again, but only as fast as the congestion window opens up again.
+        m_congestion_control->on_retransmission_timeout(unacked_packets.size);
+        for (auto& packet : unacked_packets.packets)
+            mark_for_retransmit(unacked_packets, packet);
+        return true;
+    });
+    if (has_unacked_packets)
+        retransmit_marked_packets(RetransmitLimit::CongestionWindow);
+}
+
+void TCPSocket::mark_for_retransmit(UnackedPackets& unacked_packets, OutgoingPacket& packet)
+{
+    if (packet.needs_retransmit)
+        return;
+    packet.needs_retransmit = true;
+    ++unacked_packets.marked_for_retransmit;
+}
+
+void TCPSocket::retransmit_marked_packets(RetransmitLimit limit)
+{
+    // NOTE: We look up the route before taking the lock on the unacked packets, so that we never hold it while routing.
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     auto routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return;
 
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-        for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+        retransmit_marked_packets(unacked_packets, routing_decision, limit);
+    });
+}
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+void TCPSocket::retransmit_marked_packets(UnackedPackets& unacked_packets, RoutingDecision const& routing_decision, RetransmitLimit limit)
+{
+    if (unacked_packets.marked_for_retransmit == 0)
+        return;
 
-            auto packet_buffer = packet.buffer->bytes();
+    size_t byte_limit = limit == RetransmitLimit::OneSegment ? m_congestion_control->maximum_segment_size() : m_congestion_control->congestion_window();
+    size_t bytes_sent = 0;
+    for (auto& packet : unacked_packets.packets) {
+        if (!packet.needs_retransmit)
+            continue;
+
+        // Always allow at least one segment to go out, no matter how small the limit is.
+        auto packet_size = packet.buffer->buffer->size() - packet.ipv4_payload_offset;
+        if (bytes_sent > 0 && bytes_sent + packet_size > byte_limit)
+            break;
+
+        packet.needs_retransmit = false;
+        --unacked_packets.marked_for_retransmit;
+        packet.tx_counter++;
+        m_retransmits++;
+
+        if constexpr (TCP_SOCKET_DEBUG) {
+            auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+            dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+                local_address(), local_port(),
+                peer_address(), peer_port(),
+                (tcp_packet.has_syn() ? "SYN " : ""),
+                (tcp_packet.has_ack() ? "ACK " : ""),
+                (tcp_packet.has_fin() ? "FIN " : ""),
+                (tcp_packet.has_rst() ? "RST " : ""),
+                tcp_packet.sequence_number(),
+                tcp_packet.ack_number(),
+                packet.tx_counter);
+        }
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+        size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+        if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+            // FIXME: Add support for this. This can happen if after a route change
+            // we ended up on another adapter which doesn't have the same layer 2 type
+            // like the previous adapter.
+            VERIFY_NOT_REACHED();
         }
-    });
+
+        auto packet_buffer = packet.buffer->bytes();
+
+        routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+            local_address(), routing_decision.next_hop, peer_address(),
+            IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+        // NOTE: A packet that was segmented by the adapter is retransmitted as a whole.
+        routing_decision.adapter->send_packet(packet_buffer, packet.offload);
+        m_packets_out++;
+        m_bytes_out += packet_buffer.size();
+        bytes_sent += packet_size;
+    }
 }
 
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
@@ -658,8 +795,22 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (!file_description.is_blocking())
         return true;
 
+    // Don't put more data on the wire than both the peer (send window) and the network (congestion window) can take.
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        auto window_size = min(m_send_window_size, m_congestion_control->congestion_window());
+        return unacked_packets.size + size <= window_size;
+    });
+}
+
+TCPSocket::CongestionControlState TCPSocket::congestion_control_state() const
+{
+    return m_unacked_packets.with_shared([&](auto&) {
+        return CongestionControlState {
+            .name = m_congestion_control->name(),
+            .congestion_window = m_congestion_control->congestion_window(),
+            .slow_start_threshold = m_congestion_control->slow_start_threshold(),
+            .maximum_segment_size = m_congestion_control->maximum_segment_size(),
+        };
     });
 }
 }
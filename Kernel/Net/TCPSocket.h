@@ -13,6 +13,7 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 
 namespace Kernel {
 
@@ -133,6 +134,18 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 retransmits() const { return m_retransmits; }
+    u32 fast_retransmits() const { return m_fast_retransmits; }
+
+    // NOTE: The congestion control state is guarded by the lock on the unacked packets, so this returns a snapshot of it.
+    struct CongestionControlState {
+        StringView name;
+        u32 congestion_window { 0 };
+        u32 slow_start_threshold { 0 };
+        u32 maximum_segment_size { 0 };
+    };
+    CongestionControlState congestion_control_state() const;
+    TCPRoundTripTimeEstimator const& round_trip_time_estimator() const { return m_round_trip_time_estimator; }
 
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
@@ -163,12 +176,13 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
+    static u16 compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_packet_size);
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -185,6 +199,16 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    struct OutgoingPacket;
+    struct UnackedPackets;
+    enum class RetransmitLimit {
+        OneSegment,
+        CongestionWindow,
+    };
+    void mark_for_retransmit(UnackedPackets&, OutgoingPacket&);
+    void retransmit_marked_packets(RetransmitLimit);
+    void retransmit_marked_packets(UnackedPackets&, RoutingDecision const&, RetransmitLimit);
+
     LockWeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullRefPtr<TCPSocket>> m_pending_release_for_accept;
     Direction m_direction { Direction::Unspecified };
@@ -204,13 +228,18 @@ private:
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
         int tx_counter { 0 };
+        UnixDateTime sent_time;
+        bool needs_retransmit { false };
+        PacketOffload offload {};
     };
 
     struct UnackedPackets {
         SinglyLinkedList<OutgoingPacket> packets;
         size_t size { 0 };
+        size_t marked_for_retransmit { 0 };
     };
 
+    // NOTE: This also guards the congestion control state and the send window.
     MutexProtected<UnackedPackets> m_unacked_packets;
 
     u32 m_duplicate_acks { 0 };
@@ -220,8 +249,16 @@ private:
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
-    UnixDateTime m_last_retransmit_time;
+    // Restarted whenever new data is acknowledged or sent while nothing was outstanding (RFC 6298 section 5).
+    UnixDateTime m_retransmit_timer_start;
     u32 m_retransmit_attempts { 0 };
+    u32 m_retransmits { 0 };
+    u32 m_fast_retransmits { 0 };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+    TCPRoundTripTimeEstimator m_round_trip_time_estimator;
+    // The acknowledgment number of the last ACK we've received from the peer, used to detect duplicate ACKs.
+    Optional<u32> m_last_ack_number_received;
 
     // Default to maximum window size. receive_tcp_packet() will update from the
     // peer's advertised window size.
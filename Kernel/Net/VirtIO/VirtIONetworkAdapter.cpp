@@ -47,8 +47,8 @@ static constexpr u16 VIRTIO_NET_S_LINK_UP = 1;
 static constexpr u16 VIRTIO_NET_S_ANNOUNCE = 2;
 
 static constexpr u8 VIRTIO_NET_HDR_F_NEEDS_CSUM = 1;
-static constexpr u8 VIRTIO_NET_HDR_F_DATA_VALID = 1;
-static constexpr u8 VIRTIO_NET_HDR_F_RSC_INFO = 1;
+static constexpr u8 VIRTIO_NET_HDR_F_DATA_VALID = 2;
+static constexpr u8 VIRTIO_NET_HDR_F_RSC_INFO = 4;
 static constexpr u8 VIRTIO_NET_HDR_GSO_NONE = 0;
 static constexpr u8 VIRTIO_NET_HDR_GSO_TCPV4 = 1;
 static constexpr u8 VIRTIO_NET_HDR_GSO_UDP = 3;
@@ -87,8 +87,12 @@ static constexpr u16 RECEIVEQ = 0;
 static constexpr u16 TRANSMITQ = 1;
 
 static constexpr size_t MAX_RX_FRAME_SIZE = 1514; // Non-jumbo Ethernet frame limit.
-static constexpr size_t RX_BUFFER_SIZE = sizeof(VirtIONetHdr) * MAX_RX_FRAME_SIZE;
+static constexpr size_t RX_BUFFER_SIZE = sizeof(VirtIONetHdr) + MAX_RX_FRAME_SIZE;
 static constexpr u16 MAX_INFLIGHT_PACKETS = 128;
+// Enough for a few dozen TSO packets of up to 64 KiB each.
+static constexpr size_t TX_BUFFERS_SIZE = 2 * MiB;
+// The largest packet the device may split across several receive buffers.
+static constexpr size_t MAX_MERGED_RX_PACKET_SIZE = 64 * KiB + MAX_RX_FRAME_SIZE;
 
 UNMAP_AFTER_INIT ErrorOr<bool> VirtIONetworkAdapter::probe(PCI::DeviceIdentifier const& pci_device_identifier)
 {
@@ -114,7 +118,7 @@ UNMAP_AFTER_INIT VirtIONetworkAdapter::VirtIONetworkAdapter(PCI::DeviceIdentifie
 UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize(Badge<NetworkingManagement>)
 {
     m_rx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Rx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS));
-    m_tx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Tx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS));
+    m_tx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Tx buffer"sv, TX_BUFFERS_SIZE));
 
     return initialize_virtio_resources();
 }
@@ -135,11 +139,32 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
             negotiated |= VIRTIO_NET_F_SPEED_DUPLEX;
         if (is_feature_set(supported_features, VIRTIO_NET_F_MTU))
             negotiated |= VIRTIO_NET_F_MTU;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CSUM)) {
+            negotiated |= VIRTIO_NET_F_CSUM;
+            // The device can only segment packets for us if it also finishes their checksums.
+            if (is_feature_set(supported_features, VIRTIO_NET_F_HOST_TSO4))
+                negotiated |= VIRTIO_NET_F_HOST_TSO4;
+        }
+        // NOTE: We don't verify the checksums of received packets, so we can accept packets with partial checksums.
+        if (is_feature_set(supported_features, VIRTIO_NET_F_GUEST_CSUM))
+            negotiated |= VIRTIO_NET_F_GUEST_CSUM;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_MRG_RXBUF))
+            negotiated |= VIRTIO_NET_F_MRG_RXBUF;
         return negotiated;
     });
     if (!success)
         return Error::from_errno(EIO);
 
+    auto offload_capabilities = OffloadCapabilities::None;
+    if (is_feature_accepted(VIRTIO_NET_F_CSUM))
+        offload_capabilities |= OffloadCapabilities::TransmitChecksum;
+    if (is_feature_accepted(VIRTIO_NET_F_HOST_TSO4))
+        offload_capabilities |= OffloadCapabilities::TCPSegmentation;
+    set_offload_capabilities(offload_capabilities);
+
+    if (is_feature_accepted(VIRTIO_NET_F_MRG_RXBUF))
+        m_rx_packet = TRY(KBuffer::try_create_with_size("VirtIONetworkAdapter Rx packet"sv, MAX_MERGED_RX_PACKET_SIZE));
+
     success = handle_device_config_change();
     if (!success)
         return Error::from_errno(EIO);
@@ -159,8 +184,9 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
             // We know that the RingBuffer will not wraparound in this loop. But it's still awkward.
             auto buffer_start = MUST(m_rx_buffers->reserve_space(RX_BUFFER_SIZE));
             VERIFY(chain.add_buffer_to_chain(buffer_start, RX_BUFFER_SIZE, VirtIO::BufferType::DeviceWritable));
-            supply_chain_and_notify(RECEIVEQ, chain);
+            supply_chain(RECEIVEQ, chain);
         }
+        notify_queue_if_needed(RECEIVEQ);
     }
 
     return {};
@@ -202,23 +228,9 @@ void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: handle_queue_update {}", queue_index);
 
     if (queue_index == RECEIVEQ) {
-        // FIXME: Disable interrupts while receiving as recommended by the spec.
-        auto& queue = get_queue(RECEIVEQ);
-        SpinlockLocker queue_lock(queue.lock());
-        size_t used;
-        VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
-
-        while (!popped_chain.is_empty()) {
-            VERIFY(popped_chain.length() == 1);
-            popped_chain.for_each([&](PhysicalAddress addr, size_t length) {
-                size_t offset = addr.as_ptr() - m_rx_buffers->start_of_region().as_ptr();
-                auto* message = reinterpret_cast<VirtIONetHdr*>(m_rx_buffers->vaddr().offset(offset).as_ptr());
-                did_receive({ message->frame, length - sizeof(VirtIONetHdr) });
-            });
-
-            supply_chain_and_notify(RECEIVEQ, popped_chain);
-            popped_chain = queue.pop_used_buffer_chain(used);
-        }
+        // The NetworkTask takes it from here, and enables the interrupts again once it has caught up.
+        get_queue(RECEIVEQ).disable_interrupts();
+        schedule_receive_poll();
     } else if (queue_index == TRANSMITQ) {
         auto& queue = get_queue(TRANSMITQ);
         SpinlockLocker queue_lock(queue.lock());
@@ -257,10 +269,111 @@ static bool copy_data_to_chain(VirtIO::QueueChain& chain, Memory::RingBuffer& ri
     return true;
 }
 
+size_t VirtIONetworkAdapter::receive_frames(size_t budget)
+{
+    auto& queue = get_queue(RECEIVEQ);
+    SpinlockLocker queue_lock(queue.lock());
+
+    // Take what the device has filled so far, and only notify it once we've handed all of the buffers back.
+    size_t received = 0;
+    for (; received < budget; ++received) {
+        size_t used;
+        VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
+        if (popped_chain.is_empty())
+            break;
+        VERIFY(popped_chain.length() == 1);
+        popped_chain.for_each([&](PhysicalAddress addr, size_t length) {
+            size_t offset = addr.as_ptr() - m_rx_buffers->start_of_region().as_ptr();
+            receive_buffer({ m_rx_buffers->vaddr().offset(offset).as_ptr(), min(used, length) });
+        });
+        supply_chain(RECEIVEQ, popped_chain);
+    }
+    if (received > 0)
+        notify_queue_if_needed(RECEIVEQ);
+    return received;
+}
+
+bool VirtIONetworkAdapter::enable_receive_interrupts()
+{
+    auto& queue = get_queue(RECEIVEQ);
+    queue.enable_interrupts();
+    full_memory_barrier();
+    // NOTE: The device won't interrupt us for buffers it filled while the interrupts were disabled.
+    if (!queue.new_data_available())
+        return true;
+    queue.disable_interrupts();
+    return false;
+}
+
+void VirtIONetworkAdapter::receive_buffer(ReadonlyBytes buffer)
+{
+    if (m_rx_buffers_left > 0) {
+        // Only the first buffer of a merged packet starts with a header, the others just continue the frame.
+        append_to_rx_packet(buffer);
+        if (--m_rx_buffers_left == 0 && !m_rx_packet_overflowed)
+            did_receive(m_rx_packet->bytes().trim(m_rx_packet_size));
+        return;
+    }
+
+    if (buffer.size() < sizeof(VirtIONetHdr)) {
+        dbgln("VirtIONetworkAdapter: Dropping runt receive buffer of {} byte(s)", buffer.size());
+        return;
+    }
+    auto const& header = *reinterpret_cast<VirtIONetHdr const*>(buffer.data());
+    auto frame = buffer.slice(sizeof(VirtIONetHdr));
+    u16 buffer_count = m_rx_packet ? static_cast<u16>(header.num_buffers) : 1;
+    if (buffer_count <= 1) {
+        did_receive(frame);
+        return;
+    }
+
+    m_rx_packet_size = 0;
+    m_rx_packet_overflowed = false;
+    m_rx_buffers_left = buffer_count - 1;
+    append_to_rx_packet(frame);
+}
+
+void VirtIONetworkAdapter::append_to_rx_packet(ReadonlyBytes bytes)
+{
+    if (m_rx_packet_overflowed)
+        return;
+    if (m_rx_packet_size + bytes.size() > m_rx_packet->size()) {
+        dbgln("VirtIONetworkAdapter: Dropping merged packet that is too large");
+        m_rx_packet_overflowed = true;
+        return;
+    }
+    memcpy(m_rx_packet->data() + m_rx_packet_size, bytes.data(), bytes.size());
+    m_rx_packet_size += bytes.size();
+}
+
 void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw length={}", payload.size());
+    send_with_header({}, payload);
+}
+
+void VirtIONetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, PacketOffload const& offload)
+{
+    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw_with_offload length={} segment_size={}", payload.size(), offload.segment_size);
 
+    VirtIONetHdr header {};
+    if (offload.needs_checksum) {
+        header.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+        header.csum_start = offload.checksum_start;
+        header.csum_offset = offload.checksum_offset;
+    }
+    if (offload.segment_size > 0) {
+        // NOTE: The device expects the checksum of a segmented packet to be left to it as well.
+        VERIFY(offload.needs_checksum);
+        header.gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+        header.gso_size = offload.segment_size;
+        header.hdr_len = offload.header_size;
+    }
+    send_with_header(header, payload);
+}
+
+void VirtIONetworkAdapter::send_with_header(VirtIONetHdr const& header, ReadonlyBytes payload)
+{
     auto& queue = get_queue(TRANSMITQ);
     SpinlockLocker queue_lock(queue.lock());
     VirtIO::QueueChain chain(queue);
@@ -273,8 +386,7 @@ void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
     }
 
     // FIXME: Handle errors from pushing to the chain and rewind the RingBuffer.
-    VirtIONetHdr hdr {};
-    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8*>(&hdr), sizeof(hdr)));
+    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8 const*>(&header), sizeof(header)));
     VERIFY(copy_data_to_chain(chain, *m_tx_buffers, payload.data(), payload.size()));
 
     supply_chain_and_notify(TRANSMITQ, chain);
@@ -7,11 +7,16 @@
 #pragma once
 
 #include <Kernel/Bus/VirtIO/Device.h>
+#include <Kernel/Library/KBuffer.h>
 #include <Kernel/Memory/RingBuffer.h>
 #include <Kernel/Net/NetworkAdapter.h>
 
 namespace Kernel {
 
+namespace VirtIO {
+struct VirtIONetHdr;
+}
+
 class VirtIONetworkAdapter
     : public VirtIO::Device
     , public NetworkAdapter {
@@ -43,6 +48,13 @@ private:
 
     // NetworkAdapter
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) override;
+    virtual size_t receive_frames(size_t budget) override;
+    virtual bool enable_receive_interrupts() override;
+
+    void send_with_header(VirtIO::VirtIONetHdr const&, ReadonlyBytes);
+    void receive_buffer(ReadonlyBytes);
+    void append_to_rx_packet(ReadonlyBytes);
 
 private:
     VirtIO::Configuration const* m_device_config { nullptr };
@@ -55,6 +67,12 @@ private:
 
     OwnPtr<Memory::RingBuffer> m_rx_buffers;
     OwnPtr<Memory::RingBuffer> m_tx_buffers;
+
+    // With VIRTIO_NET_F_MRG_RXBUF, a packet may span several receive buffers, which we collect in here.
+    OwnPtr<KBuffer> m_rx_packet;
+    size_t m_rx_packet_size { 0 };
+    u16 m_rx_buffers_left { 0 };
+    bool m_rx_packet_overflowed { false };
 };
 
 }
@@ -97,7 +97,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     u32 cmd = params.futex_op & FUTEX_CMD_MASK;
 
     bool use_realtime_clock = (params.futex_op & FUTEX_CLOCK_REALTIME) != 0;
-    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET) {
+    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET && cmd != FUTEX_LOCK_PI) {
         return ENOSYS;
     }
 
@@ -107,7 +107,8 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
     case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_CMP_REQUEUE:
+    case FUTEX_LOCK_PI: {
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
@@ -238,6 +239,150 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         return woken_or_requeued;
     };
 
+    auto do_lock_pi = [&](bool try_only) -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value();
+        if ((tid & ~FUTEX_TID_MASK) != 0)
+            return EOVERFLOW;
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+
+        // NOTE: While the owner is running on another processor it is likely to release the lock soon,
+        //       so we spin for a little while before going to sleep. Userspace can't tell whether the
+        //       owner is running, which is why this spinning lives here and not in LibC.
+        static constexpr size_t max_spin_count = 1000;
+        size_t spin_count = 0;
+
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+
+            if (owner_tid == 0) {
+                // Keep the waiters bit set if anyone else is still waiting, so that our unlock comes back to us.
+                auto futex_queue = TRY(find_futex_queue(futex_key, false));
+                u32 inherited_priority = 0;
+                u32 new_value = tid;
+                if (futex_queue && !futex_queue->is_empty_and_no_imminent_waits()) {
+                    inherited_priority = futex_queue->highest_waiter_priority();
+                    new_value |= FUTEX_WAITERS;
+                }
+                auto did_lock = user_atomic_compare_exchange_relaxed(params.userspace_address, value, new_value);
+                if (!did_lock.has_value())
+                    return EFAULT;
+                if (!did_lock.value())
+                    continue;
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                if (inherited_priority != 0)
+                    current_thread->inherit_priority(inherited_priority);
+                return 0;
+            }
+
+            if (owner_tid == tid)
+                return EDEADLK;
+            if (try_only)
+                return EAGAIN;
+
+            // NOTE: The owner TID comes from userspace, so we must not boost just any thread it names.
+            auto owner = Thread::from_tid(owner_tid);
+            if (!owner)
+                return ESRCH;
+            if (owner->process().is_kernel_process())
+                return EPERM;
+            bool owner_is_in_this_process = &owner->process() == this;
+            if (!shared && !owner_is_in_this_process)
+                return EPERM;
+
+            if ((value & FUTEX_WAITERS) == 0) {
+                if (spin_count < max_spin_count && owner->state() == Thread::State::Running && owner->cpu() != Processor::current_id()) {
+                    ++spin_count;
+                    Processor::pause();
+                    continue;
+                }
+                auto did_mark = user_atomic_compare_exchange_relaxed(params.userspace_address, value, value | FUTEX_WAITERS);
+                if (!did_mark.has_value())
+                    return EFAULT;
+                if (!did_mark.value())
+                    continue;
+            }
+
+            // FIXME: Owners of a shared futex in other processes don't inherit our priority, as we can't tell
+            //        whether they really own it.
+            if (owner_is_in_this_process)
+                owner->inherit_priority(current_thread->effective_priority());
+
+            bool did_create;
+            LockRefPtr<FutexQueue> futex_queue;
+            do {
+                did_create = false;
+                futex_queue = TRY(find_futex_queue(futex_key, true, &did_create));
+                VERIFY(futex_queue);
+            } while (!did_create && !futex_queue->queue_imminent_wait());
+
+            // The owner may have unlocked the futex before we queued up, in which case nobody is going to wake us.
+            auto current_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!current_value.has_value() || (current_value.value() & FUTEX_TID_MASK) == 0) {
+                futex_queue->cancel_imminent_wait();
+                if (futex_queue->is_empty_and_no_imminent_waits())
+                    remove_futex_queue(futex_key);
+                if (!current_value.has_value())
+                    return EFAULT;
+                spin_count = 0;
+                continue;
+            }
+
+            Thread::BlockResult block_result = futex_queue->wait_on(timeout, 0u);
+
+            bool gave_up = block_result == Thread::BlockResult::InterruptedByTimeout || block_result.was_interrupted();
+            if (gave_up && owner_is_in_this_process) {
+                // The owner shouldn't keep running with our priority now that we aren't waiting anymore.
+                auto value_after_wait = user_atomic_load_relaxed(params.userspace_address);
+                if (value_after_wait.has_value() && (value_after_wait.value() & FUTEX_TID_MASK) == owner_tid) {
+                    owner->drop_inherited_priority();
+                    if (auto priority = futex_queue->highest_waiter_priority(); priority != 0)
+                        owner->inherit_priority(priority);
+                }
+            }
+
+            if (futex_queue->is_empty_and_no_imminent_waits())
+                remove_futex_queue(futex_key);
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.was_interrupted())
+                return EINTR;
+
+            // We were handed the lock, but someone may have grabbed it from userspace in the meantime.
+            spin_count = 0;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != static_cast<u32>(current_thread->tid().value()))
+            return EPERM;
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+
+        // FIXME: If we own more than one priority-inheritance futex, this drops the boost we got from the others as well.
+        current_thread->drop_inherited_priority();
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        if (!user_atomic_exchange_relaxed(params.userspace_address, 0).has_value())
+            return EFAULT;
+
+        auto futex_queue = TRY(find_futex_queue(futex_key, false));
+        if (!futex_queue)
+            return 0;
+        bool is_empty;
+        futex_queue->wake_highest_priority(is_empty);
+        if (is_empty)
+            remove_futex_queue(futex_key);
+        return 0;
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
         return do_wait(0);
@@ -324,6 +469,15 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         if (params.val3 == 0)
             return EINVAL;
         return TRY(do_wake(user_address, params.val, params.val3));
+
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
     }
     return ENOSYS;
 }
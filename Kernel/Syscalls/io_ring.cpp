@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_ring_create(u32 entries, int options)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (entries == 0 || entries > IO_RING_MAX_ENTRIES || !is_power_of_two(entries))
+        return EINVAL;
+
+    auto ring = TRY(IORing::try_create(entries));
+    auto description = TRY(OpenFileDescription::try_create(move(ring)));
+
+    description->set_readable(true);
+    description->set_writable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(description, fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 to_submit)
+{
+    // NOTE: The submissions go through the same paths as sys$read, sys$write and sys$accept4, which expect the big lock.
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto description = TRY(open_file_description(fd));
+    if (!description->file().is_io_ring())
+        return EINVAL;
+    auto& ring = static_cast<IORing&>(description->file());
+
+    // NOTE: Submissions are executed synchronously and in order. The win over plain syscalls
+    //       comes from paying the syscall entry cost once per batch rather than once per operation.
+    MutexLocker locker(ring.enter_lock());
+    u32 submitted = 0;
+    while (submitted < to_submit) {
+        if (ring.completion_ring_is_full())
+            break;
+        auto submission = TRY(ring.pop_submission());
+        if (!submission.has_value())
+            break;
+
+        auto result = do_io_ring_submission(*submission);
+        ++submitted;
+        if (result.is_error()) {
+            ring.post_completion(submission->user_data, -static_cast<i64>(result.error().code()));
+            // Give the signal that interrupted us a chance to be dispatched before continuing.
+            if (result.error().code() == EINTR)
+                break;
+            continue;
+        }
+        ring.post_completion(submission->user_data, static_cast<i64>(result.value()));
+    }
+    return submitted;
+}
+
+ErrorOr<FlatPtr> Process::do_io_ring_submission(IORingSubmission const& submission)
+{
+    if (submission.opcode == IORingOpcode::Nop)
+        return 0;
+
+    if (submission.length > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto description = TRY(open_file_description(submission.fd));
+    Optional<off_t> offset;
+    if (submission.offset >= 0)
+        offset = submission.offset;
+    else if (submission.offset != -1)
+        return EINVAL;
+
+    switch (submission.opcode) {
+    case IORingOpcode::Read: {
+        if (!description->is_readable())
+            return EBADF;
+        if (description->is_directory())
+            return EISDIR;
+        if (offset.has_value() && !description->file().is_seekable())
+            return EINVAL;
+        if (submission.length == 0)
+            return 0;
+        if (description->is_blocking() && !description->can_read()) {
+            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+            if (Thread::current()->block<Thread::ReadBlocker>({}, *description, unblock_flags).was_interrupted())
+                return EINTR;
+            if (!has_flag(unblock_flags, Thread::FileBlocker::BlockFlags::Read))
+                return EAGAIN;
+        }
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(static_cast<FlatPtr>(submission.buffer)), submission.length));
+        if (offset.has_value())
+            return TRY(description->read(buffer, offset.value(), submission.length));
+        return TRY(description->read(buffer, submission.length));
+    }
+    case IORingOpcode::Write: {
+        if (!description->is_writable())
+            return EBADF;
+        if (offset.has_value() && !description->file().is_seekable())
+            return EINVAL;
+        if (submission.length == 0)
+            return 0;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(static_cast<FlatPtr>(submission.buffer)), submission.length));
+        return do_write(*description, buffer, submission.length, offset);
+    }
+    case IORingOpcode::Poll: {
+        // Poll only samples the current state of the description; it never waits.
+        FlatPtr revents = 0;
+        if ((submission.op_flags & POLLIN) && description->can_read())
+            revents |= POLLIN;
+        if ((submission.op_flags & POLLOUT) && description->can_write())
+            revents |= POLLOUT;
+        return revents;
+    }
+    case IORingOpcode::Accept: {
+        TRY(require_promise(Pledge::accept));
+        if (!description->is_socket())
+            return ENOTSOCK;
+        auto& socket = *description->socket();
+
+        auto fd_allocation = TRY(m_fds.with_exclusive([](auto& fds) { return fds.allocate(); }));
+
+        LockRefPtr<Socket> accepted_socket;
+        for (;;) {
+            accepted_socket = socket.accept();
+            if (accepted_socket)
+                break;
+            if (!description->is_blocking())
+                return EAGAIN;
+            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+            if (Thread::current()->block<Thread::AcceptBlocker>({}, *description, unblock_flags).was_interrupted())
+                return EINTR;
+        }
+
+        auto accepted_socket_description = TRY(OpenFileDescription::try_create(*accepted_socket));
+        accepted_socket_description->set_readable(true);
+        accepted_socket_description->set_writable(true);
+        if (submission.op_flags & SOCK_NONBLOCK)
+            accepted_socket_description->set_blocking(false);
+        int fd_flags = 0;
+        if (submission.op_flags & SOCK_CLOEXEC)
+            fd_flags |= FD_CLOEXEC;
+
+        m_fds.with_exclusive([&](auto& fds) {
+            fds[fd_allocation.fd].set(move(accepted_socket_description), fd_flags);
+        });
+
+        // NOTE: Moving this state to Completed is what causes connect() to unblock on the client side.
+        accepted_socket->set_setup_state(Socket::SetupState::Completed);
+        return fd_allocation.fd;
+    }
+    default:
+        return EINVAL;
+    }
+}
+
+}
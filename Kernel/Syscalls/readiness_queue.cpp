@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FileSystem/ReadinessQueue.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+static constexpr size_t max_events_per_wait = 1024;
+
+ErrorOr<FlatPtr> Process::sys$readiness_queue_create(int options)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto queue = TRY(ReadinessQueue::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(queue)));
+
+    description->set_readable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(description, fd_flags);
+        return new_fd.fd;
+    });
+}
+
+static ErrorOr<NonnullRefPtr<OpenFileDescription>> open_readiness_queue_description(Process& process, int queue_fd)
+{
+    auto description = TRY(process.open_file_description(queue_fd));
+    if (!description->file().is_readiness_queue())
+        return EINVAL;
+    return description;
+}
+
+ErrorOr<FlatPtr> Process::sys$readiness_queue_ctl(int queue_fd, int operation, int fd, Userspace<ReadinessEvent const*> user_event)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto queue_description = TRY(open_readiness_queue_description(*this, queue_fd));
+    auto& queue = static_cast<ReadinessQueue&>(queue_description->file());
+
+    if (operation == READINESS_QUEUE_REMOVE) {
+        TRY(queue.remove(fd));
+        return 0;
+    }
+
+    auto event = TRY(copy_typed_from_user(user_event));
+    if (event.events & ~(POLLIN | POLLOUT))
+        return EINVAL;
+
+    auto description = TRY(open_file_description(fd));
+    switch (operation) {
+    case READINESS_QUEUE_ADD:
+        TRY(queue.add(fd, *description, event.events, event.user_data));
+        return 0;
+    case READINESS_QUEUE_MODIFY:
+        TRY(queue.modify(fd, *description, event.events, event.user_data));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$readiness_queue_wait(int queue_fd, Userspace<ReadinessEvent*> user_events, int max_events, Userspace<timespec const*> user_timeout)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (max_events <= 0)
+        return EINVAL;
+
+    auto queue_description = TRY(open_readiness_queue_description(*this, queue_fd));
+    auto& queue = static_cast<ReadinessQueue&>(queue_description->file());
+
+    Thread::BlockTimeout timeout;
+    bool should_block = true;
+    if (user_timeout) {
+        auto timeout_time = TRY(copy_time_from_user(user_timeout));
+        should_block = timeout_time > Duration::zero();
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    Vector<ReadinessEvent, 32> events;
+    TRY(events.try_resize(min(static_cast<size_t>(max_events), max_events_per_wait)));
+
+    size_t count = 0;
+    for (;;) {
+        count = TRY(queue.collect_ready_events(events.span()));
+        if (count > 0 || !should_block)
+            break;
+
+        // NOTE: The queue becomes readable once any of its entries may have become ready.
+        //       That might turn out to be a false alarm, in which case we simply go back to sleep.
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto block_result = Thread::current()->block<Thread::ReadBlocker>(timeout, *queue_description, unblock_flags);
+        if (block_result.was_interrupted())
+            return EINTR;
+        if (block_result == Thread::BlockResult::InterruptedByTimeout)
+            should_block = false;
+    }
+
+    if (count > 0)
+        TRY(copy_n_to_user(user_events, events.data(), count));
+    return count;
+}
+
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/SharedInodeVMObject.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+struct PageCacheChunk {
+    NonnullOwnPtr<Memory::Region> region;
+    size_t offset_in_region { 0 };
+    size_t size { 0 };
+};
+
+// Maps the page cache pages that back the given range of the file into the kernel, so they can be handed
+// to the output description as they are. Returns an empty chunk at the end of the file, and ENOTSUP if
+// the range isn't covered by the page cache.
+static ErrorOr<Optional<PageCacheChunk>> map_page_cache_chunk(Inode& inode, Memory::SharedInodeVMObject& page_cache, OpenFileDescription& description, u64 offset, size_t count)
+{
+    auto inode_size = inode.size();
+    if (offset >= inode_size)
+        return OptionalNone {};
+    count = min(count, inode_size - offset);
+
+    auto first_page_index = offset / PAGE_SIZE;
+    auto end_page_index = ceil_div(offset + count, static_cast<u64>(PAGE_SIZE));
+    if (end_page_index > page_cache.page_count())
+        return ENOTSUP;
+
+    Vector<NonnullRefPtr<Memory::PhysicalPage>, sendfile_chunk_size / PAGE_SIZE + 1> pages;
+    for (auto page_index = first_page_index; page_index < end_page_index; ++page_index) {
+        auto page = TRY(page_cache.try_get_or_read_page(page_index, &description));
+        // The inode was truncated while we were reading it.
+        if (!page)
+            break;
+        TRY(pages.try_append(page.release_nonnull()));
+    }
+    if (pages.is_empty())
+        return OptionalNone {};
+
+    auto offset_in_region = offset % PAGE_SIZE;
+    count = min(count, pages.size() * PAGE_SIZE - offset_in_region);
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_physical_pages(pages.span()));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, pages.size() * PAGE_SIZE, "sendfile"sv, Memory::Region::Access::Read));
+    return PageCacheChunk { move(region), offset_in_region, count };
+}
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> userspace_offset, size_t count)
+{
+    // NOTE: The data goes through the same paths as sys$read and sys$write, which expect the big lock.
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    if (!in_description->file().is_seekable())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    // NOTE: Like pread(), an explicit offset leaves the offset of the input description alone.
+    off_t start_offset = 0;
+    if (userspace_offset) {
+        start_offset = TRY(copy_typed_from_user(userspace_offset));
+        if (start_offset < 0)
+            return EINVAL;
+    } else {
+        start_offset = in_description->offset();
+    }
+
+    if (count == 0)
+        return 0;
+
+    LockRefPtr<Memory::SharedInodeVMObject> page_cache;
+    if (in_description->file().is_inode())
+        page_cache = TRY(in_description->inode()->page_cache());
+
+    // Files in the page cache are sent straight from the cached pages, so the data is only copied once,
+    // into the output description. Everything else goes through a bounce buffer, which still saves the
+    // copies to and from userspace and a syscall pair per chunk.
+    OwnPtr<KBuffer> bounce_buffer;
+    size_t total_nsent = 0;
+    ErrorOr<void> result {};
+    while (total_nsent < count) {
+        auto chunk_size = min(count - total_nsent, sendfile_chunk_size);
+        auto chunk_offset = start_offset + total_nsent;
+
+        Optional<PageCacheChunk> page_cache_chunk;
+        if (page_cache) {
+            auto chunk_or_error = map_page_cache_chunk(*in_description->inode(), *page_cache, *in_description, chunk_offset, chunk_size);
+            if (chunk_or_error.is_error() && chunk_or_error.error().code() == ENOTSUP) {
+                // The file has grown past what the page cache covers.
+                page_cache = nullptr;
+            } else if (chunk_or_error.is_error()) {
+                result = chunk_or_error.release_error();
+                break;
+            } else if (!chunk_or_error.value().has_value()) {
+                break;
+            } else {
+                page_cache_chunk = chunk_or_error.release_value();
+            }
+        }
+
+        u8* data = nullptr;
+        size_t nread = 0;
+        if (page_cache_chunk.has_value()) {
+            data = page_cache_chunk->region->vaddr().offset(page_cache_chunk->offset_in_region).as_ptr();
+            nread = page_cache_chunk->size;
+        } else {
+            if (!bounce_buffer) {
+                auto bounce_buffer_or_error = KBuffer::try_create_with_size("sendfile"sv, min(count, sendfile_chunk_size));
+                if (bounce_buffer_or_error.is_error()) {
+                    result = bounce_buffer_or_error.release_error();
+                    break;
+                }
+                bounce_buffer = bounce_buffer_or_error.release_value();
+            }
+            data = bounce_buffer->data();
+            auto read_buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+            auto nread_or_error = in_description->read(read_buffer, chunk_offset, chunk_size);
+            if (nread_or_error.is_error()) {
+                result = nread_or_error.release_error();
+                break;
+            }
+            nread = nread_or_error.release_value();
+            if (nread == 0)
+                break;
+        }
+
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        auto nwritten_or_error = do_write(*out_description, buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            result = nwritten_or_error.release_error();
+            break;
+        }
+        auto nwritten = nwritten_or_error.release_value();
+        total_nsent += nwritten;
+        // A short write means that the output would block (or was interrupted), so stop here like write() does.
+        if (nwritten < nread)
+            break;
+    }
+
+    if (total_nsent == 0 && result.is_error())
+        return result.release_error();
+
+    off_t end_offset = start_offset + total_nsent;
+    if (userspace_offset)
+        TRY(copy_to_user(userspace_offset, &end_offset));
+    else
+        TRY(in_description->seek(end_offset, SEEK_SET));
+
+    return total_nsent;
+}
+
+}
@@ -25,6 +25,11 @@ bool FutexQueue::should_add_blocker(Thread::Blocker& b, void*)
         dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: was removed", this, b.thread());
         return false;
     }
+    if (m_has_pending_wake) {
+        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: was woken before blocking", this, b.thread());
+        m_has_pending_wake = false;
+        return false;
+    }
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should block thread {}", this, b.thread());
 
     return true;
@@ -132,6 +137,61 @@ u32 FutexQueue::wake_all(bool& is_empty)
     return did_wake;
 }
 
+u32 FutexQueue::highest_waiter_priority()
+{
+    SpinlockLocker lock(m_lock);
+    u32 highest_priority = 0;
+    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool&) {
+        highest_priority = max(highest_priority, b.thread().effective_priority());
+        return false;
+    });
+    return highest_priority;
+}
+
+bool FutexQueue::wake_highest_priority(bool& is_empty)
+{
+    SpinlockLocker lock(m_lock);
+    dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_highest_priority", this);
+    Thread::FutexBlocker* highest_priority_blocker = nullptr;
+    u32 highest_priority = 0;
+    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool&) {
+        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+        // NOTE: Waiters of equal priority are woken in the order they started waiting.
+        auto priority = b.thread().effective_priority();
+        if (!highest_priority_blocker || priority > highest_priority) {
+            highest_priority_blocker = static_cast<Thread::FutexBlocker*>(&b);
+            highest_priority = priority;
+        }
+        return false;
+    });
+
+    bool did_wake = false;
+    if (highest_priority_blocker) {
+        unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
+            if (&b != highest_priority_blocker)
+                return false;
+            stop_iterating = true;
+            dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_highest_priority unblocking {}", this, b.thread());
+            did_wake = highest_priority_blocker->unblock();
+            return did_wake;
+        });
+    }
+    if (!did_wake) {
+        // The waiter we picked was already on its way out (e.g. it timed out), so settle for anyone else.
+        unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
+            if (&b == highest_priority_blocker || !static_cast<Thread::FutexBlocker&>(b).unblock())
+                return false;
+            stop_iterating = true;
+            did_wake = true;
+            return true;
+        });
+    }
+    if (!did_wake && m_imminent_waits > 0)
+        m_has_pending_wake = true;
+    is_empty = is_empty_and_no_imminent_waits_locked();
+    return did_wake;
+}
+
 bool FutexQueue::is_empty_and_no_imminent_waits_locked()
 {
     return m_imminent_waits == 0 && is_empty_locked();
@@ -146,6 +206,14 @@ bool FutexQueue::queue_imminent_wait()
     return true;
 }
 
+void FutexQueue::cancel_imminent_wait()
+{
+    SpinlockLocker lock(m_lock);
+    VERIFY(m_imminent_waits > 0);
+    if (--m_imminent_waits == 0)
+        m_has_pending_wake = false;
+}
+
 bool FutexQueue::try_remove()
 {
     SpinlockLocker lock(m_lock);
@@ -23,6 +23,10 @@ public:
     u32 wake_n(u32, Optional<u32> const&, bool&);
     u32 wake_all(bool&);
 
+    // Used by the priority-inheritance futex operations, which hand the lock to the most important waiter.
+    u32 highest_waiter_priority();
+    bool wake_highest_priority(bool&);
+
     template<class... Args>
     Thread::BlockResult wait_on(Thread::BlockTimeout const& timeout, Args&&... args)
     {
@@ -30,6 +34,7 @@ public:
     }
 
     bool queue_imminent_wait();
+    void cancel_imminent_wait();
     bool try_remove();
 
     bool is_empty_and_no_imminent_waits()
@@ -45,6 +50,9 @@ protected:
 private:
     size_t m_imminent_waits { 1 }; // We only create this object if we're going to be waiting, so start out with 1
     bool m_was_removed { false };
+    // Set when wake_highest_priority() found nobody blocked yet, but someone about to block.
+    // That waiter then doesn't block at all, instead of missing its wakeup.
+    bool m_has_pending_wake { false };
 };
 
 }
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Devices/Generic/MemoryPressureDevice.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/MemoryPressureTask.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+static constexpr Duration check_interval = Duration::from_milliseconds(250);
+
+// A level is entered once the uncommitted memory drops below its watermark, and only left again
+// once there is some headroom above it, so we don't keep flapping between two levels.
+static constexpr u64 moderate_watermark_percent = 10;
+static constexpr u64 critical_watermark_percent = 4;
+static constexpr u64 hysteresis_percent = 2;
+
+static Atomic<MemoryPressureLevel> s_level { MemoryPressureLevel::Normal };
+static Atomic<u32> s_sequence { 0 };
+static Atomic<u64> s_pages_purged { 0 };
+
+static MemoryPressureLevel level_for(MemoryPressureLevel current_level, u64 available_pages, u64 total_pages)
+{
+    auto is_below = [&](u64 percent) { return available_pages * 100 < total_pages * percent; };
+
+    if (is_below(critical_watermark_percent))
+        return MemoryPressureLevel::Critical;
+    if (current_level == MemoryPressureLevel::Critical && is_below(critical_watermark_percent + hysteresis_percent))
+        return MemoryPressureLevel::Critical;
+    if (is_below(moderate_watermark_percent))
+        return MemoryPressureLevel::Moderate;
+    if (current_level != MemoryPressureLevel::Normal && is_below(moderate_watermark_percent + hysteresis_percent))
+        return MemoryPressureLevel::Moderate;
+    return MemoryPressureLevel::Normal;
+}
+
+static StringView level_name(MemoryPressureLevel level)
+{
+    switch (level) {
+    case MemoryPressureLevel::Normal:
+        return "normal"sv;
+    case MemoryPressureLevel::Moderate:
+        return "moderate"sv;
+    case MemoryPressureLevel::Critical:
+        return "critical"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static void update_level()
+{
+    auto current_level = s_level.load();
+    auto memory_info = MM.get_system_memory_info();
+    auto level = level_for(current_level, memory_info.physical_pages_uncommitted, memory_info.physical_pages);
+
+    if (level != MemoryPressureLevel::Normal) {
+        // Free up memory until we are back above the point where we would leave moderate pressure.
+        // This way, it happens here instead of in the middle of some unlucky allocation.
+        // Clean file-backed pages are the cheapest to give up (they can simply be read again), and they count
+        // against the uncommitted memory, so we drop those before purging volatile memory.
+        auto goal = memory_info.physical_pages * (moderate_watermark_percent + hysteresis_percent) / 100;
+        if (goal > memory_info.physical_pages_uncommitted) {
+            if (MM.release_clean_inode_pages(goal - memory_info.physical_pages_uncommitted)) {
+                memory_info = MM.get_system_memory_info();
+                level = level_for(current_level, memory_info.physical_pages_uncommitted, memory_info.physical_pages);
+            }
+        }
+        if (goal > memory_info.physical_pages_uncommitted) {
+            if (auto pages_purged = MM.purge_volatile_memory(goal - memory_info.physical_pages_uncommitted)) {
+                s_pages_purged.fetch_add(pages_purged, AK::MemoryOrder::memory_order_relaxed);
+                memory_info = MM.get_system_memory_info();
+                level = level_for(current_level, memory_info.physical_pages_uncommitted, memory_info.physical_pages);
+            }
+        }
+    }
+
+    if (level == current_level)
+        return;
+
+    dbgln("MemoryPressureTask: Memory pressure changed from {} to {}", level_name(current_level), level_name(level));
+    s_level.store(level);
+    s_sequence.fetch_add(1);
+    MemoryPressureDevice::notify_level_changed();
+}
+
+UNMAP_AFTER_INIT void MemoryPressureTask::spawn()
+{
+    MUST(Process::create_kernel_process(KString::must_create("Memory Pressure Task"sv), [] {
+        for (;;) {
+            // Keep the page caches in check before they can push us into memory pressure.
+            MM.enforce_clean_inode_page_limit();
+            update_level();
+            (void)Thread::current()->sleep(check_interval);
+        }
+    }));
+}
+
+MemoryPressureLevel MemoryPressureTask::level()
+{
+    return s_level.load();
+}
+
+u32 MemoryPressureTask::sequence()
+{
+    return s_sequence.load();
+}
+
+MemoryPressureEvent MemoryPressureTask::current_event()
+{
+    auto memory_info = MM.get_system_memory_info();
+    return {
+        .level = s_level.load(),
+        .sequence = s_sequence.load(),
+        .available_bytes = static_cast<u64>(memory_info.physical_pages_uncommitted) * PAGE_SIZE,
+        .total_bytes = static_cast<u64>(memory_info.physical_pages) * PAGE_SIZE,
+    };
+}
+
+u64 MemoryPressureTask::pages_purged()
+{
+    return s_pages_purged.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+}
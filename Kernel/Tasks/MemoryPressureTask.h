@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/API/MemoryPressure.h>
+
+namespace Kernel {
+
+// Keeps track of the memory pressure level, and purges volatile memory before allocations start failing.
+// Userspace is told about changes of the level through /dev/memory_pressure.
+class MemoryPressureTask {
+public:
+    static void spawn();
+
+    static MemoryPressureLevel level();
+    static u32 sequence();
+    static MemoryPressureEvent current_event();
+
+    // How many pages were purged ahead of time, instead of when an allocation failed.
+    static u64 pages_purged();
+};
+
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/FixedArray.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/StringHash.h>
+#include <AK/Vector.h>
+#include <Kernel/Debug.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PageMergeTask.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+static constexpr Duration scan_interval = Duration::from_seconds(5);
+// How many pages we look at before giving others a chance to run.
+static constexpr size_t pages_per_batch = 256;
+
+static Atomic<bool> s_enabled { false };
+static Atomic<u64> s_full_scans { 0 };
+static Atomic<u64> s_pages_merged { 0 };
+static Atomic<u64> s_pages_sharing { 0 };
+
+class PageMerger {
+public:
+    static ErrorOr<NonnullOwnPtr<PageMerger>> try_create()
+    {
+        auto compare_buffer = TRY(FixedArray<u8>::create(PAGE_SIZE));
+        return adopt_nonnull_own_or_enomem(new (nothrow) PageMerger(move(compare_buffer)));
+    }
+
+    ErrorOr<void> scan();
+
+private:
+    explicit PageMerger(FixedArray<u8>&& compare_buffer)
+        : m_compare_buffer(move(compare_buffer))
+    {
+    }
+
+    struct Candidate {
+        NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject;
+        size_t page_index { 0 };
+    };
+
+    static u32 checksum_page(Memory::PhysicalPage&);
+    bool pages_are_identical(Memory::PhysicalPage&, Memory::PhysicalPage&);
+    Optional<PhysicalPtr> try_merge(Candidate& target, Memory::AnonymousVMObject&, size_t page_index);
+
+    FixedArray<u8> m_compare_buffer;
+    // The checksums from the previous scan. We only merge pages whose contents didn't change since then,
+    // since pages that are still being written to would just be copied again right away.
+    HashMap<PhysicalPtr, u32> m_previous_checksums;
+    // The pages that others were merged into, so we can tell how much memory we are saving.
+    HashTable<PhysicalPtr> m_merge_targets;
+};
+
+u32 PageMerger::checksum_page(Memory::PhysicalPage& page)
+{
+    InterruptDisabler disabler;
+    auto* data = MM.quickmap_page(page);
+    auto checksum = string_hash(reinterpret_cast<char const*>(data), PAGE_SIZE);
+    MM.unquickmap_page();
+    return checksum;
+}
+
+bool PageMerger::pages_are_identical(Memory::PhysicalPage& a, Memory::PhysicalPage& b)
+{
+    // NOTE: We can only quickmap one page at a time, so we compare against a copy of the first one.
+    {
+        InterruptDisabler disabler;
+        auto* data = MM.quickmap_page(a);
+        memcpy(m_compare_buffer.data(), data, PAGE_SIZE);
+        MM.unquickmap_page();
+    }
+
+    InterruptDisabler disabler;
+    auto* data = MM.quickmap_page(b);
+    bool identical = memcmp(m_compare_buffer.data(), data, PAGE_SIZE) == 0;
+    MM.unquickmap_page();
+    return identical;
+}
+
+Optional<PhysicalPtr> PageMerger::try_merge(Candidate& target, Memory::AnonymousVMObject& vmobject, size_t page_index)
+{
+    // Sharing both pages copy-on-write freezes their contents for as long as we hold on to them,
+    // as any write will end up in a copy instead.
+    // NOTE: Committing a page for each copy would reserve as much memory as merging frees. Like KSM on Linux,
+    //       we don't, so a write to a merged page allocates its copy like any other page fault, and can run out of memory.
+    auto target_page_or_error = target.vmobject->share_page_copy_on_write(target.page_index, Memory::AnonymousVMObject::ShouldCommitCopy::No);
+    if (target_page_or_error.is_error())
+        return {};
+    auto page_or_error = vmobject.share_page_copy_on_write(page_index, Memory::AnonymousVMObject::ShouldCommitCopy::No);
+    if (page_or_error.is_error())
+        return {};
+
+    auto target_page = target_page_or_error.release_value();
+    auto page = page_or_error.release_value();
+    if (target_page.ptr() == page.ptr() || !pages_are_identical(*target_page, *page))
+        return {};
+
+    auto target_paddr = target_page->paddr().get();
+    if (!vmobject.replace_with_identical_page(page_index, *page, move(target_page)))
+        return {};
+    return target_paddr;
+}
+
+ErrorOr<void> PageMerger::scan()
+{
+    Vector<NonnullLockRefPtr<Memory::AnonymousVMObject>> vmobjects;
+    ErrorOr<void> result {};
+    Memory::MemoryManager::for_each_vmobject([&](Memory::VMObject& vmobject) {
+        if (!vmobject.is_anonymous())
+            return IterationDecision::Continue;
+        if (auto append_result = vmobjects.try_append(static_cast<Memory::AnonymousVMObject&>(vmobject)); append_result.is_error()) {
+            result = append_result.release_error();
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    TRY(result);
+
+    HashMap<PhysicalPtr, u32> checksums;
+    HashMap<u32, Candidate> candidates;
+    size_t pages_scanned = 0;
+    size_t pages_merged = 0;
+
+    for (auto& vmobject : vmobjects) {
+        if (!s_enabled)
+            return {};
+        if (!vmobject->is_mergeable())
+            continue;
+        for (size_t page_index = 0; page_index < vmobject->page_count(); ++page_index) {
+            if (++pages_scanned % pages_per_batch == 0)
+                Scheduler::yield();
+
+            auto page = vmobject->mergeable_page(page_index);
+            if (!page)
+                continue;
+            auto paddr = page->paddr().get();
+            auto checksum = checksum_page(*page);
+            page = nullptr;
+            TRY(checksums.try_set(paddr, checksum));
+
+            auto previous_checksum = m_previous_checksums.get(paddr);
+            if (!previous_checksum.has_value() || previous_checksum.value() != checksum)
+                continue;
+
+            auto it = candidates.find(checksum);
+            if (it == candidates.end()) {
+                TRY(candidates.try_set(checksum, Candidate { vmobject, page_index }));
+                continue;
+            }
+            if (auto target_paddr = try_merge(it->value, *vmobject, page_index); target_paddr.has_value()) {
+                dbgln_if(PAGE_MERGE_DEBUG, "PageMergeTask: Merged page {} of {} into {:p}", page_index, &*vmobject, target_paddr.value());
+                TRY(m_merge_targets.try_set(target_paddr.value()));
+                ++pages_merged;
+            }
+        }
+    }
+
+    // Count how many pages are still sharing the pages we merged into. Merged pages go back
+    // to being separate pages as soon as they are written to.
+    HashMap<PhysicalPtr, size_t> merge_target_users;
+    for (auto& vmobject : vmobjects) {
+        for (size_t page_index = 0; page_index < vmobject->page_count(); ++page_index) {
+            auto page = vmobject->mergeable_page(page_index);
+            if (!page || !m_merge_targets.contains(page->paddr().get()))
+                continue;
+            auto users = merge_target_users.get(page->paddr().get()).value_or(0);
+            TRY(merge_target_users.try_set(page->paddr().get(), users + 1));
+        }
+    }
+
+    u64 pages_sharing = 0;
+    HashTable<PhysicalPtr> merge_targets;
+    for (auto& it : merge_target_users) {
+        if (it.value < 2)
+            continue;
+        pages_sharing += it.value - 1;
+        TRY(merge_targets.try_set(it.key));
+    }
+
+    m_previous_checksums = move(checksums);
+    m_merge_targets = move(merge_targets);
+    s_pages_merged.fetch_add(pages_merged, AK::MemoryOrder::memory_order_relaxed);
+    s_pages_sharing.store(pages_sharing, AK::MemoryOrder::memory_order_relaxed);
+    s_full_scans.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    return {};
+}
+
+UNMAP_AFTER_INIT void PageMergeTask::spawn()
+{
+    MUST(Process::create_kernel_process(KString::must_create("Page Merge Task"sv), [] {
+        Thread::current()->set_priority(THREAD_PRIORITY_LOW);
+        OwnPtr<PageMerger> merger;
+        for (;;) {
+            (void)Thread::current()->sleep(scan_interval);
+            if (!s_enabled)
+                continue;
+            if (!merger) {
+                auto merger_or_error = PageMerger::try_create();
+                if (merger_or_error.is_error())
+                    continue;
+                merger = merger_or_error.release_value();
+            }
+            if (auto result = merger->scan(); result.is_error())
+                dbgln("PageMergeTask: Scan failed: {}", result.error());
+        }
+    }));
+}
+
+bool PageMergeTask::is_enabled()
+{
+    return s_enabled;
+}
+
+void PageMergeTask::set_enabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+PageMergeTask::Statistics PageMergeTask::statistics()
+{
+    return {
+        .full_scans = s_full_scans.load(AK::MemoryOrder::memory_order_relaxed),
+        .pages_merged = s_pages_merged.load(AK::MemoryOrder::memory_order_relaxed),
+        .pages_sharing = s_pages_sharing.load(AK::MemoryOrder::memory_order_relaxed),
+    };
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Periodically looks for anonymous pages with identical contents, and merges them into a single
+// copy-on-write page. This is off by default, and can be turned on via /sys/kernel/variables/same_page_merging.
+class PageMergeTask {
+public:
+    static void spawn();
+
+    static bool is_enabled();
+    static void set_enabled(bool);
+
+    struct Statistics {
+        u64 full_scans { 0 };
+        u64 pages_merged { 0 };
+        // How many pages we saved as of the last full scan.
+        u64 pages_sharing { 0 };
+    };
+    static Statistics statistics();
+};
+
+}
@@ -16,6 +16,7 @@
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
+#include <Kernel/Tasks/Tracepoints.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/kstdio.h>
 
@@ -46,10 +47,24 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Every processor owns its own set of priority buckets, so that enqueueing and
+// picking threads on one processor does not contend with the other processors.
+// A processor that runs out of local work steals from its peers (see pull_next_runnable_thread()),
+// and busy processors periodically even out their queues (see balance_load()).
+// The ready queues are only protected by their own locks. At most two of them are ever held at once,
+// in which case the one of the lower processor is taken first.
+using PerProcessorReadyQueues = Array<SpinlockProtected<ThreadReadyQueues, LockRank::None>, MAX_CPU_COUNT>;
+static Singleton<PerProcessorReadyQueues> g_ready_queues;
+// How many threads are queued on each processor. Kept outside of the ready queues, so that
+// balance_load() can find the busiest processor without taking everyone's lock.
+static Array<Atomic<size_t>, MAX_CPU_COUNT> s_ready_thread_counts {};
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
+// NOTE: Each processor only ever touches its own entry, from within the timer interrupt.
+static constexpr u32 load_balance_interval_in_time_slices = 8;
+static Array<u32, MAX_CPU_COUNT> s_time_slices_until_load_balance {};
+
 static void dump_thread_list(bool = false);
 
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
@@ -64,73 +79,120 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline bool thread_may_run_on(Thread const& thread, u32 cpu)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+    return (thread.affinity() & (1u << cpu)) != 0;
+}
+
+static u32 select_ready_queue_for(Thread const& thread)
+{
+    // Prefer the processor the thread last ran on, as its caches are most likely still warm.
+    // Otherwise queue it on the current processor, and only if that's not permitted by the
+    // thread's affinity fall back to the first processor it is allowed to run on.
+    auto processor_count = Processor::count();
+    auto last_cpu = thread.cpu();
+    if (thread.times_scheduled() > 0 && last_cpu < processor_count && thread_may_run_on(thread, last_cpu))
+        return last_cpu;
+    auto current_cpu = Processor::current_id();
+    if (thread_may_run_on(thread, current_cpu))
+        return current_cpu;
+    for (u32 cpu = 0; cpu < processor_count; ++cpu) {
+        if (thread_may_run_on(thread, cpu))
+            return cpu;
+    }
+    // The affinity mask doesn't contain any online processor, so just keep it
+    // somewhere it can be found again once the mask is changed.
+    return current_cpu;
+}
+
+Thread* Scheduler::take_runnable_thread_from(ThreadReadyQueues& ready_queues, u32 cpu)
+{
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!thread_may_run_on(thread, cpu))
+                continue;
+            remove_from_ready_queues(ready_queues, thread);
+            // Mark it as active because we are using this thread. This is similar
+            // to comparing it with Processor::current_thread, but when there are
+            // multiple processors there's no easy way to check whether the thread
+            // is actually still needed. This prevents accidental finalization when
+            // a thread is no longer in Running state, but running on another core.
+
+            // We need to mark it active here so that this thread won't be
+            // scheduled on another core if it were to be queued before actually
+            // switching to it.
+            // FIXME: Figure out a better way maybe?
+            thread.set_active(true);
+            return &thread;
         }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
-    });
+Thread* Scheduler::find_runnable_thread_in(ThreadReadyQueues& ready_queues, u32 cpu)
+{
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!thread_may_run_on(thread, cpu))
+                continue;
+            return &thread;
+        }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+Thread& Scheduler::pull_next_runnable_thread()
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
+    auto current_cpu = Processor::current_id();
+
+    if (auto* thread = g_ready_queues->at(current_cpu).with([&](auto& ready_queues) { return take_runnable_thread_from(ready_queues, current_cpu); }))
+        return *thread;
+
+    // Our own queues are empty, so rather than going idle try to steal work from the other
+    // processors. We start with our neighbor so that not every idle processor hammers the
+    // queues of processor 0 first, and only ever hold one ready queue lock at a time.
+    auto processor_count = Processor::count();
+    for (u32 i = 1; i < processor_count; ++i) {
+        auto victim_cpu = (current_cpu + i) % processor_count;
+        auto* thread = g_ready_queues->at(victim_cpu).with([&](auto& ready_queues) { return take_runnable_thread_from(ready_queues, current_cpu); });
+        if (thread) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", current_cpu, *thread, victim_cpu);
+            return *thread;
         }
+    }
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
+}
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto current_cpu = Processor::current_id();
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled. We also only look at our own queues here: threads queued
+    // on other processors are either picked up there, stolen by an idle processor,
+    // or pulled over by balance_load().
+    return g_ready_queues->at(current_cpu).with([&](auto& ready_queues) {
+        return find_runnable_thread_in(ready_queues, current_cpu);
     });
 }
 
@@ -139,42 +201,108 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
-            VERIFY(!thread.m_ready_queue_node.is_in_list());
+    for (;;) {
+        auto queue_cpu = thread.m_ready_queue_cpu.load(AK::MemoryOrder::memory_order_relaxed);
+        if (queue_cpu < 0)
             return false;
-        }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
+        auto was_dequeued = g_ready_queues->at(queue_cpu).with([&](auto& ready_queues) -> Optional<bool> {
+            // The thread may have been moved to another processor before we got the lock, so look again.
+            if (thread.m_ready_queue_cpu.load(AK::MemoryOrder::memory_order_relaxed) != queue_cpu)
+                return {};
+            if (check_affinity && !thread_may_run_on(thread, Processor::current_id()))
+                return false;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
-        return true;
-    });
+            remove_from_ready_queues(ready_queues, thread);
+            return true;
+        });
+        if (was_dequeued.has_value())
+            return was_dequeued.value();
+    }
 }
 
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
-
-    g_ready_queues->with([&](auto& ready_queues) {
-        VERIFY(thread.m_runnable_priority < 0);
-        thread.m_runnable_priority = (int)priority;
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        auto& ready_queue = ready_queues.queues[priority];
-        bool was_empty = ready_queue.thread_list.is_empty();
-        ready_queue.thread_list.append(thread);
-        if (was_empty)
-            ready_queues.mask |= (1u << priority);
+    auto priority = thread_priority_to_priority_index(thread.effective_priority());
+    auto queue_cpu = select_ready_queue_for(thread);
+
+    g_ready_queues->at(queue_cpu).with([&](auto& ready_queues) {
+        add_to_ready_queues(ready_queues, thread, priority, queue_cpu);
+    });
+}
+
+void Scheduler::add_to_ready_queues(ThreadReadyQueues& ready_queues, Thread& thread, u32 priority, u32 cpu)
+{
+    VERIFY(thread.m_runnable_priority < 0);
+    VERIFY(thread.m_ready_queue_cpu < 0);
+    thread.m_runnable_priority = (int)priority;
+    thread.m_ready_queue_cpu.store((int)cpu, AK::MemoryOrder::memory_order_relaxed);
+    VERIFY(!thread.m_ready_queue_node.is_in_list());
+    auto& ready_queue = ready_queues.queues[priority];
+    bool was_empty = ready_queue.thread_list.is_empty();
+    ready_queue.thread_list.append(thread);
+    if (was_empty)
+        ready_queues.mask |= (1u << priority);
+    s_ready_thread_counts[cpu].fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+void Scheduler::remove_from_ready_queues(ThreadReadyQueues& ready_queues, Thread& thread)
+{
+    auto priority = thread.m_runnable_priority;
+    VERIFY(priority >= 0);
+    VERIFY(ready_queues.mask & (1u << priority));
+    auto& ready_queue = ready_queues.queues[priority];
+    auto cpu = thread.m_ready_queue_cpu.exchange(-1, AK::MemoryOrder::memory_order_relaxed);
+    VERIFY(cpu >= 0);
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        ready_queues.mask &= ~(1u << priority);
+    auto previous_count = s_ready_thread_counts[cpu].fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    VERIFY(previous_count > 0);
+}
+
+void Scheduler::balance_load()
+{
+    auto current_cpu = Processor::current_id();
+    auto local_thread_count = s_ready_thread_counts[current_cpu].load(AK::MemoryOrder::memory_order_relaxed);
+
+    // Only move a thread if that actually evens things out: With a difference of one thread,
+    // we would just keep passing a thread back and forth.
+    Optional<u32> busiest_cpu;
+    auto busiest_thread_count = local_thread_count + 1;
+    auto processor_count = Processor::count();
+    for (u32 cpu = 0; cpu < processor_count; ++cpu) {
+        if (cpu == current_cpu)
+            continue;
+        auto thread_count = s_ready_thread_counts[cpu].load(AK::MemoryOrder::memory_order_relaxed);
+        if (thread_count > busiest_thread_count) {
+            busiest_cpu = cpu;
+            busiest_thread_count = thread_count;
+        }
+    }
+    if (!busiest_cpu.has_value())
+        return;
+
+    // NOTE: We move the thread while holding both locks, so that it is always on one of the queues
+    //       whenever dequeue_runnable_thread() looks for it.
+    auto lower_cpu = min(current_cpu, *busiest_cpu);
+    auto higher_cpu = max(current_cpu, *busiest_cpu);
+    g_ready_queues->at(lower_cpu).with([&](auto& lower_ready_queues) {
+        g_ready_queues->at(higher_cpu).with([&](auto& higher_ready_queues) {
+            auto& busiest_ready_queues = lower_cpu == current_cpu ? higher_ready_queues : lower_ready_queues;
+            auto& local_ready_queues = lower_cpu == current_cpu ? lower_ready_queues : higher_ready_queues;
+
+            auto* thread = find_runnable_thread_in(busiest_ready_queues, current_cpu);
+            if (!thread)
+                return;
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Pulled {} over from processor {}", current_cpu, *thread, *busiest_cpu);
+            auto priority = thread->m_runnable_priority;
+            remove_from_ready_queues(busiest_ready_queues, *thread);
+            add_to_ready_queues(local_ready_queues, *thread, priority, current_cpu);
+        });
     });
 }
 
@@ -217,6 +345,8 @@ void Scheduler::pick_next()
             Processor::set_current_in_scheduler(false);
         });
 
+    // NOTE: The scheduler lock serializes this with the thread state changes (a thread we pick must not
+    //       get blocked under us), the ready queues themselves are protected by their own locks.
     SpinlockLocker lock(g_scheduler_lock);
 
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
@@ -288,6 +418,7 @@ void Scheduler::context_switch(Thread* thread)
     thread->set_state(Thread::State::Running);
 
     PerformanceManager::add_context_switch_perf_event(*from_thread, *thread);
+    Tracepoints::hit(TracepointID::ContextSwitch, from_thread->tid().value(), thread->tid().value(), to_underlying(from_thread->state()), thread->pid().value());
 
     proc.switch_context(from_thread, thread);
 
@@ -439,6 +570,16 @@ void Scheduler::timer_tick(RegisterState const& regs)
     if (current_thread->tick())
         return;
 
+    // A processor only steals work once it runs out of it, so one that keeps running the same thread
+    // would never take any load off its peers. So every once in a while, we even out the queues.
+    auto& time_slices_until_load_balance = s_time_slices_until_load_balance[Processor::current_id()];
+    if (time_slices_until_load_balance == 0) {
+        time_slices_until_load_balance = load_balance_interval_in_time_slices;
+        balance_load();
+    } else {
+        --time_slices_until_load_balance;
+    }
+
     if (!current_thread->is_idle_thread() && !peek_next_runnable_thread()) {
         // If no other thread is ready to be scheduled we don't need to
         // switch to the idle thread. Just give the current thread another
@@ -480,7 +621,9 @@ void Scheduler::idle_loop(void*)
 
     for (;;) {
         proc.idle_begin();
+        TimeManagement::the().enter_idle();
         proc.wait_for_interrupt();
+        TimeManagement::the().exit_idle();
         proc.idle_end();
         VERIFY_INTERRUPTS_ENABLED();
         yield();
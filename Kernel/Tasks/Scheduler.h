@@ -18,6 +18,7 @@
 namespace Kernel {
 
 struct RegisterState;
+struct ThreadReadyQueues;
 
 extern Thread* g_finalizer;
 extern WaitQueue* g_finalizer_wait_queue;
@@ -55,6 +56,13 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+
+private:
+    static void balance_load();
+    static void add_to_ready_queues(ThreadReadyQueues&, Thread&, u32 priority, u32 cpu);
+    static void remove_from_ready_queues(ThreadReadyQueues&, Thread&);
+    static Thread* take_runnable_thread_from(ThreadReadyQueues&, u32 cpu);
+    static Thread* find_runnable_thread_in(ThreadReadyQueues&, u32 cpu);
 };
 
 }
@@ -101,6 +101,7 @@ Thread::~Thread()
 
     // We shouldn't be queued
     VERIFY(m_runnable_priority < 0);
+    VERIFY(m_ready_queue_cpu < 0);
 }
 
 Thread::BlockResult Thread::block_impl(BlockTimeout const& timeout, Blocker& blocker)
@@ -1470,6 +1471,30 @@ void Thread::set_name(NonnullOwnPtr<KString> name)
     });
 }
 
+void Thread::inherit_priority(u32 priority)
+{
+    VERIFY(priority <= THREAD_PRIORITY_MAX);
+    SpinlockLocker lock(g_scheduler_lock);
+    if (priority <= m_inherited_priority.load(AK::MemoryOrder::memory_order_relaxed))
+        return;
+    // If we are waiting in a ready queue, we have to move to the bucket that matches our new priority.
+    bool was_queued = Scheduler::dequeue_runnable_thread(*this) && !is_idle_thread();
+    m_inherited_priority.store(priority, AK::MemoryOrder::memory_order_relaxed);
+    if (was_queued)
+        Scheduler::enqueue_runnable_thread(*this);
+}
+
+void Thread::drop_inherited_priority()
+{
+    SpinlockLocker lock(g_scheduler_lock);
+    if (m_inherited_priority.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+        return;
+    bool was_queued = Scheduler::dequeue_runnable_thread(*this) && !is_idle_thread();
+    m_inherited_priority.store(0, AK::MemoryOrder::memory_order_relaxed);
+    if (was_queued)
+        Scheduler::enqueue_runnable_thread(*this);
+}
+
 }
 
 ErrorOr<void> AK::Formatter<Kernel::Thread>::format(FormatBuilder& builder, Kernel::Thread const& value)
@@ -79,6 +79,12 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    // Threads holding a priority-inheritance futex run with the priority of their most
+    // important waiter, so that a low priority owner can't hold up a high priority waiter.
+    u32 effective_priority() const { return max(m_priority, m_inherited_priority.load(AK::MemoryOrder::memory_order_relaxed)); }
+    void inherit_priority(u32);
+    void drop_inherited_priority();
+
     void detach()
     {
         SpinlockLocker lock(m_lock);
@@ -1089,6 +1095,9 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    // NOTE: Only modified while holding the lock of the ready queues of the processor it refers to
+    //       (and of the one it is set to, when a thread is moved between processors).
+    Atomic<int> m_ready_queue_cpu { -1 };
 
     friend class WaitQueue;
 
@@ -1223,6 +1232,7 @@ private:
     State m_state { Thread::State::Invalid };
     SpinlockProtected<NonnullOwnPtr<KString>, LockRank::None> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    Atomic<u32> m_inherited_priority { 0 };
 
     State m_stop_state { Thread::State::Invalid };
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/Thread.h>
+#include <Kernel/Tasks/Tracepoints.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+Atomic<u32> Tracepoints::s_enabled_mask { 0 };
+
+// NOTE: Trace buffers are never freed once allocated, so tracepoints can use them without holding a reference.
+static Array<TraceBuffer*, MAX_CPU_COUNT> s_buffers {};
+
+ErrorOr<NonnullOwnPtr<TraceBuffer>> TraceBuffer::try_create(u32 processor)
+{
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(TRACE_BUFFER_SIZE, AllocationStrategy::AllocateNow));
+    auto name = TRY(KString::formatted("Trace buffer #{}", processor));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, TRACE_BUFFER_SIZE, name->view(), Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_own_or_enomem(new (nothrow) TraceBuffer(move(vmobject), move(region)));
+}
+
+TraceBuffer::TraceBuffer(NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region)
+    : m_vmobject(move(vmobject))
+    , m_region(move(region))
+{
+    auto& buffer_header = header();
+    buffer_header.record_count = trace_buffer_record_count();
+    buffer_header.records_offset = trace_buffer_records_offset();
+}
+
+void TraceBuffer::append(TraceRecord const& record)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+
+    auto tail = AK::atomic_load(&header().tail, AK::memory_order_acquire);
+    // NOTE: A bogus tail written by the reader makes the buffer look full, which only drops records.
+    if (m_head - tail >= trace_buffer_record_count()) {
+        ++m_dropped;
+        AK::atomic_store(&header().dropped, m_dropped, AK::memory_order_relaxed);
+        return;
+    }
+
+    __builtin_memcpy(&records()[m_head % trace_buffer_record_count()], &record, sizeof(record));
+    ++m_head;
+    AK::atomic_store(&header().head, m_head, AK::memory_order_release);
+}
+
+ErrorOr<void> Tracepoints::allocate_buffers()
+{
+    // NOTE: Our caller (TraceDevice) makes sure that we don't race with ourselves here.
+    for (u32 processor = 0; processor < Processor::count(); ++processor) {
+        if (s_buffers[processor])
+            continue;
+        s_buffers[processor] = TRY(TraceBuffer::try_create(processor)).leak_ptr();
+    }
+    return {};
+}
+
+TraceBuffer* Tracepoints::buffer_for_processor(u32 processor)
+{
+    if (processor >= Processor::count())
+        return nullptr;
+    return s_buffers[processor];
+}
+
+void Tracepoints::enable(u32 mask)
+{
+    VERIFY((mask & ~all_tracepoints_mask) == 0);
+    s_enabled_mask.store(mask, AK::memory_order_release);
+}
+
+void Tracepoints::disable()
+{
+    s_enabled_mask.store(0, AK::memory_order_release);
+}
+
+void Tracepoints::record(TracepointID id, u64 arg0, u64 arg1, u64 arg2, u64 arg3, u64 arg4)
+{
+    // NOTE: Disabling interrupts keeps us on this processor, and keeps tracepoints that are hit from
+    //       interrupt handlers from writing into the same buffer at the same time.
+    InterruptDisabler disabler;
+    auto processor = Processor::current_id();
+    auto* buffer = s_buffers[processor];
+    if (!buffer)
+        return;
+
+    TraceRecord record {};
+    record.timestamp_ns = TimeManagement::the().monotonic_time(TimePrecision::Precise).nanoseconds();
+    if (auto* thread = Thread::current()) {
+        record.pid = thread->pid().value();
+        record.tid = thread->tid().value();
+    }
+    record.id = id;
+    record.processor = processor;
+    record.arguments[0] = arg0;
+    record.arguments[1] = arg1;
+    record.arguments[2] = arg2;
+    record.arguments[3] = arg3;
+    record.arguments[4] = arg4;
+    buffer->append(record);
+}
+
+}
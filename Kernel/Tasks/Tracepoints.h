@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/Tracepoint.h>
+#include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+// The trace buffer of a single processor. Only that processor writes records into it, always with
+// interrupts disabled, so appending needs no lock. The reader consumes the records through a shared
+// mapping of the same VMObject and lets us know how far it got by advancing the tail in the header.
+class TraceBuffer {
+public:
+    static ErrorOr<NonnullOwnPtr<TraceBuffer>> try_create(u32 processor);
+
+    void append(TraceRecord const&);
+
+    NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject() const { return m_vmobject; }
+
+private:
+    TraceBuffer(NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+    TraceBufferHeader& header() { return *reinterpret_cast<TraceBufferHeader*>(m_region->vaddr().as_ptr()); }
+    TraceRecord* records() { return reinterpret_cast<TraceRecord*>(m_region->vaddr().offset(trace_buffer_records_offset()).as_ptr()); }
+
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+
+    // NOTE: The header lives in memory that the reader can write to, so we keep our own copies.
+    u64 m_head { 0 };
+    u64 m_dropped { 0 };
+};
+
+class Tracepoints {
+public:
+    // The trace buffers are allocated when /dev/trace is opened for the first time, and kept from then on.
+    static ErrorOr<void> allocate_buffers();
+    static TraceBuffer* buffer_for_processor(u32 processor);
+
+    static void enable(u32 mask);
+    static void disable();
+
+    ALWAYS_INLINE static bool is_enabled(TracepointID id)
+    {
+        return s_enabled_mask.load(AK::memory_order_relaxed) & tracepoint_mask(id);
+    }
+
+    // NOTE: The arguments are evaluated even while the tracepoint is disabled, so keep them cheap.
+    ALWAYS_INLINE static void hit(TracepointID id, u64 arg0 = 0, u64 arg1 = 0, u64 arg2 = 0, u64 arg3 = 0, u64 arg4 = 0)
+    {
+        if (is_enabled(id)) [[unlikely]]
+            record(id, arg0, arg1, arg2, arg3, arg4);
+    }
+
+private:
+    static void record(TracepointID, u64 arg0, u64 arg1, u64 arg2, u64 arg3, u64 arg4);
+
+    static Atomic<u32> s_enabled_mask;
+};
+
+}
@@ -17,6 +17,7 @@ namespace Kernel {
 
 extern WorkQueue* g_io_work;
 extern WorkQueue* g_ata_work;
+extern WorkQueue* g_fs_work;
 
 class WorkQueue {
     AK_MAKE_NONCOPYABLE(WorkQueue);
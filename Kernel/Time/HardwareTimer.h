@@ -56,6 +56,10 @@ public:
     virtual bool try_to_set_frequency(size_t frequency) = 0;
     virtual bool is_capable_of_frequency(size_t frequency) const = 0;
     virtual size_t calculate_nearest_possible_frequency(size_t frequency) const = 0;
+
+    // Timers that can be armed to fire once after an arbitrary delay let us skip ticks while there is nothing to do.
+    virtual bool is_one_shot_capable() const { return false; }
+    virtual void arm_one_shot(u64) { VERIFY_NOT_REACHED(); }
 };
 
 template<>
@@ -37,6 +37,11 @@ namespace Kernel {
 
 static Singleton<TimeManagement> s_the;
 
+// Idle processors still wake up this often in tickless mode, just in case.
+static constexpr u64 max_idle_interval_ns = 1'000'000'000;
+// We don't arm timer interrupts that are closer together than this.
+static constexpr u64 min_timer_interrupt_interval_ns = 10'000;
+
 bool TimeManagement::is_initialized()
 {
     return s_the.is_initialized();
@@ -189,6 +194,14 @@ UNMAP_AFTER_INIT void TimeManagement::initialize([[maybe_unused]] u32 cpu)
             if (auto* apic_timer = APIC::the().initialize_timers(*s_the->m_system_timer)) {
                 dmesgln("Duration: Using APIC timer as system timer");
                 s_the->set_system_timer(*apic_timer);
+
+                // NOTE: We need a precise clock to tell when the next tick or timer is due.
+                if (kernel_command_line().is_tickless_enabled() && apic_timer->is_one_shot_capable() && s_the->m_can_query_precise_time) {
+                    dmesgln("Duration: Using tickless mode");
+                    s_the->m_tick_interval_ns = 1'000'000'000ull / apic_timer->ticks_per_second();
+                    s_the->m_is_tickless = true;
+                    s_the->enable_tickless_timer_on_current_processor();
+                }
             }
         }
     } else {
@@ -196,6 +209,8 @@ UNMAP_AFTER_INIT void TimeManagement::initialize([[maybe_unused]] u32 cpu)
         if (auto* apic_timer = APIC::the().get_timer()) {
             dmesgln("Duration: Enable APIC timer on CPU #{}", cpu);
             apic_timer->enable_local_timer();
+            if (s_the->m_is_tickless)
+                s_the->enable_tickless_timer_on_current_processor();
         }
     }
 #elif ARCH(AARCH64)
@@ -509,11 +524,124 @@ void TimeManagement::increment_time_since_boot()
 
 void TimeManagement::system_timer_tick(RegisterState const& regs)
 {
+    auto& time_management = TimeManagement::the();
+    bool is_tick = true;
+    u64 now_ns = 0;
+    if (time_management.m_is_tickless) {
+        // In tickless mode, we are also interrupted for timers that are due in between two ticks.
+        now_ns = time_management.current_time_ns();
+        auto& state = time_management.m_processor_timer_states[Processor::current_id()];
+        is_tick = now_ns >= state.next_tick_ns;
+        if (is_tick)
+            state.next_tick_ns = now_ns + time_management.m_tick_interval_ns;
+    }
+
     if (Processor::current_in_irq() <= 1) {
         // Don't expire timers while handling IRQs
         TimerQueue::the().fire();
     }
-    Scheduler::timer_tick(regs);
+    if (is_tick)
+        Scheduler::timer_tick(regs);
+
+    if (time_management.m_is_tickless)
+        time_management.program_next_timer_interrupt(now_ns);
+}
+
+u64 TimeManagement::current_time_ns() const
+{
+    return static_cast<u64>(monotonic_time(TimePrecision::Precise).nanoseconds());
+}
+
+void TimeManagement::enable_tickless_timer_on_current_processor()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    auto& state = m_processor_timer_states[Processor::current_id()];
+    auto now_ns = current_time_ns();
+    state.next_tick_ns = now_ns + m_tick_interval_ns;
+    state.is_enabled = true;
+    arm_timer_interrupt(state, now_ns, state.next_tick_ns);
+}
+
+void TimeManagement::program_next_timer_interrupt(u64 now_ns)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    auto& state = m_processor_timer_states[Processor::current_id()];
+    bool is_bootstrap_processor = Processor::is_bootstrap_processor();
+
+    // The bootstrap processor keeps the time, so it never stops ticking.
+    u64 next_interrupt_ns = state.is_idle && !is_bootstrap_processor ? now_ns + max_idle_interval_ns : state.next_tick_ns;
+
+    // Other processors only wake up for timers that are due before the bootstrap processor wakes up,
+    // so that we don't wake up every processor for every timer.
+    if (auto next_timer_due = TimerQueue::the().next_timer_due(); next_timer_due.has_value()) {
+        auto due_ns = static_cast<u64>(max(next_timer_due->to_nanoseconds(), 0));
+        if (is_bootstrap_processor || due_ns < m_bootstrap_processor_next_interrupt_ns.load(AK::MemoryOrder::memory_order_relaxed))
+            next_interrupt_ns = min(next_interrupt_ns, due_ns);
+    }
+
+    arm_timer_interrupt(state, now_ns, next_interrupt_ns);
+}
+
+void TimeManagement::arm_timer_interrupt(ProcessorTimerState& state, u64 now_ns, u64 next_interrupt_ns)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    auto delay_ns = next_interrupt_ns > now_ns ? next_interrupt_ns - now_ns : 0;
+    delay_ns = max(delay_ns, min_timer_interrupt_interval_ns);
+    state.next_interrupt_ns = now_ns + delay_ns;
+    if (Processor::is_bootstrap_processor())
+        m_bootstrap_processor_next_interrupt_ns.store(state.next_interrupt_ns, AK::MemoryOrder::memory_order_relaxed);
+    m_system_timer->arm_one_shot(delay_ns);
+}
+
+void TimeManagement::timer_queue_changed()
+{
+    if (!m_is_tickless)
+        return;
+
+    InterruptDisabler disabler;
+    auto& state = m_processor_timer_states[Processor::current_id()];
+    if (!state.is_enabled)
+        return;
+
+    auto next_timer_due = TimerQueue::the().next_timer_due();
+    if (!next_timer_due.has_value())
+        return;
+    auto due_ns = static_cast<u64>(max(next_timer_due->to_nanoseconds(), 0));
+    if (due_ns >= state.next_interrupt_ns)
+        return;
+    if (!Processor::is_bootstrap_processor() && due_ns >= m_bootstrap_processor_next_interrupt_ns.load(AK::MemoryOrder::memory_order_relaxed))
+        return;
+
+    arm_timer_interrupt(state, current_time_ns(), due_ns);
+}
+
+void TimeManagement::enter_idle()
+{
+    if (!m_is_tickless)
+        return;
+
+    // NOTE: We don't stop the tick right away, but on the next timer interrupt.
+    InterruptDisabler disabler;
+    m_processor_timer_states[Processor::current_id()].is_idle = true;
+}
+
+void TimeManagement::exit_idle()
+{
+    if (!m_is_tickless)
+        return;
+
+    InterruptDisabler disabler;
+    auto& state = m_processor_timer_states[Processor::current_id()];
+    state.is_idle = false;
+    if (!state.is_enabled)
+        return;
+
+    // We may have stopped ticking, so start again right away.
+    auto now_ns = current_time_ns();
+    if (state.next_interrupt_ns > now_ns + m_tick_interval_ns) {
+        state.next_tick_ns = now_ns + m_tick_interval_ns;
+        arm_timer_interrupt(state, now_ns, state.next_tick_ns);
+    }
 }
 
 bool TimeManagement::enable_profile_timer()
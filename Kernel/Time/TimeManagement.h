@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Error.h>
 #include <AK/OwnPtr.h>
 #include <AK/Platform.h>
@@ -16,6 +17,7 @@
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/LockRefPtr.h>
+#include <Kernel/Sections.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
@@ -74,6 +76,15 @@ public:
 
     bool can_query_precise_time() const { return m_can_query_precise_time; }
 
+    // In tickless mode, each processor's timer is armed for exactly the next point in time at which
+    // there is something to do, which is the next tick, or a timer that is due before it.
+    // Processors other than the bootstrap processor stop ticking while they are idle.
+    bool is_tickless() const { return m_is_tickless; }
+    // Called after a timer was added, in case it is due before the next timer interrupt.
+    void timer_queue_changed();
+    void enter_idle();
+    void exit_idle();
+
     Memory::VMObject& time_page_vmobject();
 
 private:
@@ -96,6 +107,17 @@ private:
     void set_system_timer(HardwareTimerBase&);
     static void system_timer_tick(RegisterState const&);
 
+    struct ProcessorTimerState {
+        bool is_enabled { false };
+        bool is_idle { false };
+        u64 next_tick_ns { 0 };
+        u64 next_interrupt_ns { 0 };
+    };
+    void enable_tickless_timer_on_current_processor();
+    void program_next_timer_interrupt(u64 now_ns);
+    void arm_timer_interrupt(ProcessorTimerState&, u64 now_ns, u64 next_interrupt_ns);
+    u64 current_time_ns() const;
+
     // Variables between m_update1 and m_update2 are synchronized
     // FIXME: Replace m_update1 and m_update2 with a SpinlockLocker
     Atomic<u32> m_update1 { 0 };
@@ -116,6 +138,13 @@ private:
     LockRefPtr<HardwareTimerBase> m_profile_timer;
 
     NonnullOwnPtr<Memory::Region> m_time_page_region;
+
+    bool m_is_tickless { false };
+    u64 m_tick_interval_ns { 0 };
+    // NOTE: Each processor only ever touches its own state, with interrupts disabled.
+    Array<ProcessorTimerState, KERNEL_MAX_CPU_COUNT> m_processor_timer_states {};
+    // The bootstrap processor takes care of all timers, unless another processor is awake before it anyway.
+    Atomic<u64> m_bootstrap_processor_next_interrupt_ns { 0 };
 };
 
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Sections.h>
@@ -45,6 +46,172 @@ Duration Timer::now(bool is_firing) const
     return TimeManagement::the().current_time(clock_id);
 }
 
+u64 TimerWheel::tick_for(Duration time)
+{
+    auto nanoseconds = time.to_nanoseconds();
+    if (nanoseconds <= 0)
+        return 0;
+    return static_cast<u64>(nanoseconds) >> tick_shift;
+}
+
+void TimerWheel::place(Timer& timer)
+{
+    auto tick = max(tick_for(timer.m_expires), m_current_tick);
+    for (size_t level = 0; level < level_count; ++level) {
+        auto window_shift = bits_per_level * (level + 1);
+        if ((tick >> window_shift) != (m_current_tick >> window_shift))
+            continue;
+        auto slot = (tick >> (bits_per_level * level)) & (slots_per_level - 1);
+        m_slots[level][slot].append(timer);
+        m_occupied_slots[level] |= 1ull << slot;
+        timer.m_wheel_level = level;
+        timer.m_wheel_slot = slot;
+        return;
+    }
+    m_overflow.append(timer);
+    timer.m_wheel_level = overflow_level;
+}
+
+void TimerWheel::add(Timer& timer)
+{
+    place(timer);
+    ++m_timer_count;
+}
+
+void TimerWheel::remove(Timer& timer)
+{
+    VERIFY(m_timer_count > 0);
+    --m_timer_count;
+
+    if (timer.m_wheel_level == overflow_level) {
+        m_overflow.remove(timer);
+        return;
+    }
+    if (timer.m_wheel_level == expired_level) {
+        m_expired.remove(timer);
+        return;
+    }
+    auto& slot = m_slots[timer.m_wheel_level][timer.m_wheel_slot];
+    slot.remove(timer);
+    if (slot.is_empty())
+        m_occupied_slots[timer.m_wheel_level] &= ~(1ull << timer.m_wheel_slot);
+}
+
+Optional<Duration> TimerWheel::next_expiration() const
+{
+    if (!m_expired.is_empty())
+        return m_expired.first()->m_expires;
+
+    auto earliest_in = [](Timer::List const& list) {
+        Optional<Duration> earliest;
+        for (auto& timer : list) {
+            if (!earliest.has_value() || timer.m_expires < earliest.value())
+                earliest = timer.m_expires;
+        }
+        return earliest;
+    };
+
+    // Every timer in a level expires before any timer in the levels above it, and all occupied slots
+    // of a level lie ahead of the current position. So the earliest timer is in the first occupied slot.
+    for (size_t level = 0; level < level_count; ++level) {
+        if (m_occupied_slots[level] == 0)
+            continue;
+        auto slot = count_trailing_zeroes(m_occupied_slots[level]);
+        return earliest_in(m_slots[level][slot]);
+    }
+    return earliest_in(m_overflow);
+}
+
+u64 TimerWheel::next_event_tick() const
+{
+    // This is the next tick at which a slot starts that has timers in it. Nothing happens until then.
+    auto next_tick = NumericLimits<u64>::max();
+    for (size_t level = 0; level < level_count; ++level) {
+        auto level_shift = bits_per_level * level;
+        auto current_slot = (m_current_tick >> level_shift) & (slots_per_level - 1);
+        auto later_slots = m_occupied_slots[level] & ~((2ull << current_slot) - 1);
+        if (later_slots == 0)
+            continue;
+        auto window_shift = level_shift + bits_per_level;
+        auto window_start = (m_current_tick >> window_shift) << window_shift;
+        next_tick = min(next_tick, window_start + (static_cast<u64>(count_trailing_zeroes(later_slots)) << level_shift));
+    }
+    if (!m_overflow.is_empty()) {
+        auto wheel_shift = bits_per_level * level_count;
+        next_tick = min(next_tick, ((m_current_tick >> wheel_shift) + 1) << wheel_shift);
+    }
+    return next_tick;
+}
+
+void TimerWheel::cascade()
+{
+    // We just reached the start of a slot. Move the timers in it down to the levels below, starting
+    // with the highest level, as its timers may end up in the slot we are about to cascade next.
+    auto wheel_shift = bits_per_level * level_count;
+    if ((m_current_tick & ((1ull << wheel_shift) - 1)) == 0) {
+        Timer::List overflow;
+        while (auto* timer = m_overflow.take_first())
+            overflow.append(*timer);
+        while (auto* timer = overflow.take_first())
+            place(*timer);
+    }
+
+    for (size_t level = level_count - 1; level > 0; --level) {
+        auto level_shift = bits_per_level * level;
+        if ((m_current_tick & ((1ull << level_shift) - 1)) != 0)
+            continue;
+        auto slot_index = (m_current_tick >> level_shift) & (slots_per_level - 1);
+        if (!(m_occupied_slots[level] & (1ull << slot_index)))
+            continue;
+        m_occupied_slots[level] &= ~(1ull << slot_index);
+        auto& slot = m_slots[level][slot_index];
+        while (auto* timer = slot.take_first())
+            place(*timer);
+    }
+}
+
+void TimerWheel::advance(Duration now)
+{
+    auto now_tick = tick_for(now);
+    for (;;) {
+        auto slot_index = m_current_tick & (slots_per_level - 1);
+        if (m_occupied_slots[0] & (1ull << slot_index)) {
+            auto& slot = m_slots[0][slot_index];
+            for (auto it = slot.begin(); it != slot.end();) {
+                auto& timer = *it;
+                ++it;
+                // NOTE: A slot covers more than a single nanosecond, so some of its timers may not be due yet.
+                if (timer.m_expires > now)
+                    continue;
+                slot.remove(timer);
+                m_expired.append(timer);
+                timer.m_wheel_level = expired_level;
+            }
+            if (slot.is_empty())
+                m_occupied_slots[0] &= ~(1ull << slot_index);
+        }
+
+        if (m_current_tick >= now_tick)
+            return;
+
+        auto next_tick = next_event_tick();
+        if (next_tick > now_tick) {
+            m_current_tick = now_tick;
+            return;
+        }
+        m_current_tick = next_tick;
+        cascade();
+    }
+}
+
+Timer* TimerWheel::take_expired()
+{
+    auto* timer = m_expired.take_first();
+    if (timer)
+        --m_timer_count;
+    return timer;
+}
+
 TimerQueue& TimerQueue::the()
 {
     return *s_the;
@@ -67,20 +234,27 @@ bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t cloc
     // returning from the timer handler and a call to cancel_timer().
     timer->setup(clock_id, deadline, move(callback));
 
-    SpinlockLocker lock(g_timerqueue_lock);
-    timer->m_id = 0; // Don't generate a timer id
-    add_timer_locked(move(timer));
+    {
+        SpinlockLocker lock(g_timerqueue_lock);
+        timer->m_id = 0; // Don't generate a timer id
+        add_timer_locked(move(timer));
+    }
+    TimeManagement::the().timer_queue_changed();
     return true;
 }
 
 TimerId TimerQueue::add_timer(NonnullRefPtr<Timer>&& timer)
 {
-    SpinlockLocker lock(g_timerqueue_lock);
+    TimerId id;
+    {
+        SpinlockLocker lock(g_timerqueue_lock);
 
-    timer->m_id = ++m_timer_id_count;
-    VERIFY(timer->m_id != 0); // wrapped
-    auto id = timer->m_id;
-    add_timer_locked(move(timer));
+        timer->m_id = ++m_timer_id_count;
+        VERIFY(timer->m_id != 0); // wrapped
+        id = timer->m_id;
+        add_timer_locked(move(timer));
+    }
+    TimeManagement::the().timer_queue_changed();
     return id;
 }
 
@@ -91,28 +265,24 @@ void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
     timer->clear_cancelled();
     timer->clear_callback_finished();
     timer->set_in_use();
+    timer->m_is_executing = false;
 
-    auto& queue = queue_for_timer(*timer);
-    if (queue.list.is_empty()) {
-        queue.list.append(timer.leak_ref());
-        queue.next_timer_due = timer_expiration;
-    } else {
-        Timer* following_timer = nullptr;
-        for (auto& t : queue.list) {
-            if (t.m_expires > timer_expiration) {
-                following_timer = &t;
-                break;
-            }
-        }
-        if (following_timer) {
-            bool next_timer_needs_update = queue.list.first() == following_timer;
-            queue.list.insert_before(*following_timer, timer.leak_ref());
-            if (next_timer_needs_update)
-                queue.next_timer_due = timer_expiration;
-        } else {
-            queue.list.append(timer.leak_ref());
+    if (is_monotonic(*timer)) {
+        m_monotonic_timers.add(timer.leak_ref());
+        return;
+    }
+
+    Timer* following_timer = nullptr;
+    for (auto& t : m_realtime_timers) {
+        if (t.m_expires > timer_expiration) {
+            following_timer = &t;
+            break;
         }
     }
+    if (following_timer)
+        m_realtime_timers.insert_before(*following_timer, timer.leak_ref());
+    else
+        m_realtime_timers.append(timer.leak_ref());
 }
 
 bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
@@ -128,15 +298,14 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
     }
 
     bool did_already_run = timer.set_cancelled();
-    auto& timer_queue = queue_for_timer(timer);
     if (!did_already_run) {
         timer.clear_in_use();
 
         SpinlockLocker lock(g_timerqueue_lock);
-        if (timer_queue.list.contains(timer)) {
+        if (!timer.m_is_executing) {
             // The timer has not fired, remove it
             VERIFY(timer.ref_count() > 1);
-            remove_timer_locked(timer_queue, timer);
+            remove_timer_locked(timer);
             return true;
         }
 
@@ -145,8 +314,8 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
         // and we don't need to spin. It still holds a reference
         // that will be dropped when it does get a chance to run,
         // but since we called set_cancelled it will only drop its reference
-        VERIFY(m_timers_executing.contains(timer));
         m_timers_executing.remove(timer);
+        timer.m_is_executing = false;
         return true;
     }
 
@@ -158,16 +327,17 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
     return false;
 }
 
-void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
+void TimerQueue::remove_timer_locked(Timer& timer)
 {
-    bool was_next_timer = (queue.list.first() == &timer);
-    queue.list.remove(timer);
+    if (is_monotonic(timer))
+        m_monotonic_timers.remove(timer);
+    else
+        m_realtime_timers.remove(timer);
+
     auto now = timer.now(false);
     if (timer.m_expires > now)
         timer.m_remaining = timer.m_expires - now;
 
-    if (was_next_timer)
-        update_next_timer_due(queue);
     // Whenever we remove a timer that was still queued (but hasn't been
     // fired) we added a reference to it. So, when removing it from the
     // queue we need to drop that reference.
@@ -178,55 +348,61 @@ void TimerQueue::fire()
 {
     SpinlockLocker lock(g_timerqueue_lock);
 
-    auto fire_timers = [&](Queue& queue) {
-        auto* timer = queue.list.first();
-        VERIFY(timer);
-        VERIFY(queue.next_timer_due == timer->m_expires);
-
-        while (timer && timer->now(true) > timer->m_expires) {
-            queue.list.remove(*timer);
-
-            m_timers_executing.append(*timer);
-
-            update_next_timer_due(queue);
-
-            lock.unlock();
-
-            // Defer executing the timer outside of the irq handler
-            Processor::deferred_call_queue([this, timer]() {
-                // Check if we were cancelled in between being triggered
-                // by the timer irq handler and now. If so, just drop
-                // our reference and don't execute the callback.
-                if (!timer->set_cancelled()) {
-                    timer->m_callback();
-                    SpinlockLocker lock(g_timerqueue_lock);
-                    m_timers_executing.remove(*timer);
-                }
-                timer->clear_in_use();
-                timer->set_callback_finished();
-                // Drop the reference we added when queueing the timer
-                timer->unref();
-            });
-
-            lock.lock();
-            timer = queue.list.first();
-        }
+    auto execute_timer = [&](Timer& timer) {
+        m_timers_executing.append(timer);
+        timer.m_is_executing = true;
+
+        lock.unlock();
+
+        // Defer executing the timer outside of the irq handler
+        Processor::deferred_call_queue([this, timer = &timer]() {
+            // Check if we were cancelled in between being triggered
+            // by the timer irq handler and now. If so, just drop
+            // our reference and don't execute the callback.
+            if (!timer->set_cancelled()) {
+                timer->m_callback();
+                SpinlockLocker lock(g_timerqueue_lock);
+                m_timers_executing.remove(*timer);
+                timer->m_is_executing = false;
+            }
+            timer->clear_in_use();
+            timer->set_callback_finished();
+            // Drop the reference we added when queueing the timer
+            timer->unref();
+        });
+
+        lock.lock();
     };
 
-    if (!m_timer_queue_monotonic.list.is_empty())
-        fire_timers(m_timer_queue_monotonic);
-    if (!m_timer_queue_realtime.list.is_empty())
-        fire_timers(m_timer_queue_realtime);
+    if (!m_monotonic_timers.is_empty()) {
+        // NOTE: Only the bootstrap processor keeps the coarse time up to date, and we may well
+        //       be on another processor that woke up for exactly this timer.
+        m_monotonic_timers.advance(TimeManagement::the().current_time(CLOCK_MONOTONIC));
+        while (auto* timer = m_monotonic_timers.take_expired())
+            execute_timer(*timer);
+    }
+
+    auto* timer = m_realtime_timers.first();
+    while (timer && timer->now(true) > timer->m_expires) {
+        m_realtime_timers.remove(*timer);
+        execute_timer(*timer);
+        timer = m_realtime_timers.first();
+    }
 }
 
-void TimerQueue::update_next_timer_due(Queue& queue)
+Optional<Duration> TimerQueue::next_timer_due()
 {
-    VERIFY(g_timerqueue_lock.is_locked());
-
-    if (auto* next_timer = queue.list.first())
-        queue.next_timer_due = next_timer->m_expires;
-    else
-        queue.next_timer_due = {};
+    SpinlockLocker lock(g_timerqueue_lock);
+    auto next_due = m_monotonic_timers.next_expiration();
+    if (auto* timer = m_realtime_timers.first()) {
+        // Translate the realtime deadline into monotonic time. This is only an estimate, as the realtime
+        // clock may be adjusted in the meantime, but then we just check again when we get there.
+        auto& time_management = TimeManagement::the();
+        auto realtime_due = time_management.current_time(CLOCK_MONOTONIC_COARSE) + (timer->m_expires - time_management.current_time(CLOCK_REALTIME_COARSE));
+        if (!next_due.has_value() || realtime_due < next_due.value())
+            next_due = realtime_due;
+    }
+    return next_due;
 }
 
 }
@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/Time.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
@@ -20,6 +22,7 @@ AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, TimerId);
 
 class Timer final : public AtomicRefCounted<Timer> {
     friend class TimerQueue;
+    friend class TimerWheel;
 
 public:
     void setup(clockid_t clock_id, Duration expires, Function<void()>&& callback)
@@ -46,6 +49,11 @@ private:
     Atomic<bool> m_cancelled { false };
     Atomic<bool> m_callback_finished { false };
     Atomic<bool> m_in_use { false };
+    // Where the timer is queued, so that it can be removed without searching for it.
+    // These are protected by the timer queue lock.
+    u8 m_wheel_level { 0 };
+    u8 m_wheel_slot { 0 };
+    bool m_is_executing { false };
 
     bool operator<(Timer const& rhs) const
     {
@@ -80,6 +88,47 @@ public:
     using List = IntrusiveList<&Timer::m_list_node>;
 };
 
+// A hierarchical timing wheel, as described in "Hashed and Hierarchical Timing Wheels" by Varghese and Lauck.
+// Every level has 64 slots, and each slot of a level covers as much time as all slots of the level below it.
+// A timer goes into the lowest level whose current window contains its expiration time, so adding and removing
+// timers takes constant time. Timers move down a level whenever the wheel reaches the slot they are in.
+// Only the lowest non-empty slot has to be searched to find the next expiration time, which lets us program
+// the hardware timer for exactly that point in time instead of waiting for the next tick.
+class TimerWheel {
+public:
+    void add(Timer&);
+    void remove(Timer&);
+    bool is_empty() const { return m_timer_count == 0; }
+
+    Optional<Duration> next_expiration() const;
+
+    // Moves the wheel forward to the given time. Any timer that is due by then can be taken with take_expired().
+    void advance(Duration now);
+    Timer* take_expired();
+
+private:
+    static constexpr size_t bits_per_level = 6;
+    static constexpr size_t slots_per_level = 1 << bits_per_level;
+    static constexpr size_t level_count = 7;
+    // Each slot of the lowest level covers 2^16 ns (~65us). With 7 levels, the wheel spans about 9 years.
+    static constexpr size_t tick_shift = 16;
+    // Pseudo levels for timers that are too far in the future for the wheel, and for timers that are due.
+    static constexpr u8 overflow_level = level_count;
+    static constexpr u8 expired_level = level_count + 1;
+
+    static u64 tick_for(Duration);
+    void place(Timer&);
+    u64 next_event_tick() const;
+    void cascade();
+
+    Array<Array<Timer::List, slots_per_level>, level_count> m_slots;
+    Array<u64, level_count> m_occupied_slots {};
+    Timer::List m_overflow;
+    Timer::List m_expired;
+    u64 m_current_tick { 0 };
+    size_t m_timer_count { 0 };
+};
+
 class TimerQueue {
     friend class Timer;
 
@@ -92,25 +141,23 @@ public:
     bool cancel_timer(Timer& timer, bool* was_in_use = nullptr);
     void fire();
 
+    // The monotonic time at which the next timer is due, if any.
+    Optional<Duration> next_timer_due();
+
 private:
-    struct Queue {
-        Timer::List list;
-        Duration next_timer_due {};
-    };
-    void remove_timer_locked(Queue&, Timer&);
-    void update_next_timer_due(Queue&);
+    void remove_timer_locked(Timer&);
     void add_timer_locked(NonnullRefPtr<Timer>);
 
-    Queue& queue_for_timer(Timer& timer)
+    static bool is_monotonic(Timer const& timer)
     {
         switch (timer.m_clock_id) {
         case CLOCK_MONOTONIC:
         case CLOCK_MONOTONIC_COARSE:
         case CLOCK_MONOTONIC_RAW:
-            return m_timer_queue_monotonic;
+            return true;
         case CLOCK_REALTIME:
         case CLOCK_REALTIME_COARSE:
-            return m_timer_queue_realtime;
+            return false;
         default:
             VERIFY_NOT_REACHED();
         }
@@ -118,8 +165,11 @@ private:
 
     u64 m_timer_id_count { 0 };
     u64 m_ticks_per_second { 0 };
-    Queue m_timer_queue_monotonic;
-    Queue m_timer_queue_realtime;
+    TimerWheel m_monotonic_timers;
+    // NOTE: The realtime clock can be set to any value at any time, so these are simply kept sorted
+    //       by their expiration time instead. There are few of them, as they are only used for alarm()
+    //       and for sleeping until an absolute point in realtime.
+    Timer::List m_realtime_timers;
     Timer::List m_timers_executing;
 };
 
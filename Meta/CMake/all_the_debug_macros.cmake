@@ -126,6 +126,7 @@ set(OCCLUSIONS_DEBUG ON)
 set(OFFD_DEBUG ON)
 set(OPENTYPE_GPOS_DEBUG ON)
 set(PAGE_FAULT_DEBUG ON)
+set(PAGE_MERGE_DEBUG ON)
 set(HTML_PARSER_DEBUG ON)
 set(PATA_DEBUG ON)
 set(PATH_DEBUG ON)
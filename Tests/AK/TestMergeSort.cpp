@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/MergeSort.h>
+#include <AK/Noncopyable.h>
+#include <AK/Random.h>
+#include <AK/Vector.h>
+
+TEST_CASE(sorts)
+{
+    for (size_t size : { 0, 1, 2, 15, 16, 17, 100, 1000, 4097 }) {
+        Vector<int> values;
+        for (size_t i = 0; i < size; ++i)
+            values.append(get_random<int>());
+
+        merge_sort(values);
+
+        for (size_t i = 1; i < size; ++i)
+            EXPECT(values[i - 1] <= values[i]);
+    }
+}
+
+TEST_CASE(is_stable)
+{
+    struct Entry {
+        u32 key;
+        size_t original_index;
+    };
+
+    for (size_t size : { 10, 100, 1000, 4097 }) {
+        Vector<Entry> entries;
+        for (size_t i = 0; i < size; ++i)
+            entries.append({ get_random<u32>() % 8, i });
+
+        merge_sort(entries, [](auto& a, auto& b) { return a.key < b.key; });
+
+        for (size_t i = 1; i < size; ++i) {
+            EXPECT(entries[i - 1].key <= entries[i].key);
+            if (entries[i - 1].key == entries[i].key)
+                EXPECT(entries[i - 1].original_index < entries[i].original_index);
+        }
+    }
+}
+
+TEST_CASE(sorts_without_copy)
+{
+    struct NoCopy {
+        AK_MAKE_NONCOPYABLE(NoCopy);
+        AK_MAKE_DEFAULT_MOVABLE(NoCopy);
+
+    public:
+        NoCopy() = default;
+
+        int value { 0 };
+    };
+
+    Vector<NoCopy> values;
+    for (int i = 0; i < 100; ++i) {
+        NoCopy value;
+        value.value = (100 - i) % 32;
+        values.append(move(value));
+    }
+
+    merge_sort(values, [](auto& a, auto& b) { return a.value < b.value; });
+
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1].value <= values[i].value);
+}
@@ -6,9 +6,64 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/IntegralMath.h>
+#include <AK/MergeSort.h>
 #include <AK/Noncopyable.h>
 #include <AK/QuickSort.h>
+#include <AK/Random.h>
 #include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+
+enum class InputPattern {
+    Random,
+    Sorted,
+    Reversed,
+    OrganPipe,
+    ManyDuplicates,
+};
+
+static constexpr InputPattern all_input_patterns[] = {
+    InputPattern::Random,
+    InputPattern::Sorted,
+    InputPattern::Reversed,
+    InputPattern::OrganPipe,
+    InputPattern::ManyDuplicates,
+};
+
+static Vector<int> make_input(InputPattern pattern, int size)
+{
+    Vector<int> input;
+    input.ensure_capacity(size);
+    for (int i = 0; i < size; ++i) {
+        switch (pattern) {
+        case InputPattern::Random:
+            input.unchecked_append(get_random<int>());
+            break;
+        case InputPattern::Sorted:
+            input.unchecked_append(i);
+            break;
+        case InputPattern::Reversed:
+            input.unchecked_append(size - i);
+            break;
+        case InputPattern::OrganPipe:
+            input.unchecked_append(i < size / 2 ? i : size - i);
+            break;
+        case InputPattern::ManyDuplicates:
+            input.unchecked_append(get_random<u32>() % 16);
+            break;
+        }
+    }
+    return input;
+}
+
+static bool is_sorted(Vector<int> const& values)
+{
+    for (size_t i = 1; i < values.size(); ++i) {
+        if (values[i] < values[i - 1])
+            return false;
+    }
+    return true;
+}
 
 TEST_CASE(sorts_without_copy)
 {
@@ -41,6 +96,60 @@ TEST_CASE(sorts_without_copy)
 
     for (size_t i = 0; i < 63; ++i)
         EXPECT(array[i].value <= array[i + 1].value);
+
+    // Test the pattern-defeating quick sort.
+    for (size_t i = 0; i < 64; ++i)
+        array[i].value = (64 - i) % 32 + 32;
+
+    quick_sort(array, [](auto& a, auto& b) { return a.value < b.value; });
+
+    for (size_t i = 0; i < 63; ++i)
+        EXPECT(array[i].value <= array[i + 1].value);
+}
+
+TEST_CASE(sorts_input_patterns)
+{
+    for (auto pattern : all_input_patterns) {
+        for (int size : { 0, 1, 2, 10, 24, 25, 100, 129, 1000, 10000 }) {
+            auto values = make_input(pattern, size);
+            size_t comparisons = 0;
+            quick_sort(values, [&](int a, int b) {
+                ++comparisons;
+                return a < b;
+            });
+            EXPECT(is_sorted(values));
+
+            // However the input looks, we should never need more than O(n log n) comparisons.
+            if (size > 1)
+                EXPECT(comparisons <= 3 * size * AK::log2(static_cast<size_t>(size)) + size);
+        }
+    }
+}
+
+TEST_CASE(sorts_part_of_collection)
+{
+    Vector<int> values;
+    for (int i = 0; i < 1000; ++i)
+        values.append(1000 - i);
+
+    AK::pattern_defeating_quick_sort(values, 100, 899, [](int a, int b) { return a < b; });
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(values[i], 1000 - i);
+    for (int i = 100; i < 899; ++i)
+        EXPECT(values[i] <= values[i + 1]);
+    for (int i = 900; i < 1000; ++i)
+        EXPECT_EQ(values[i], 1000 - i);
+}
+
+TEST_CASE(heap_sort_fallback)
+{
+    // The heap sort only kicks in once partitioning went badly again and again, which is hard to provoke
+    // on purpose with a pivot choice that tries to avoid exactly that. So we test it on its own.
+    auto values = make_input(InputPattern::Random, 1000);
+    auto less_than = [](int a, int b) { return a < b; };
+    AK::Detail::heap_sort(values, 0, static_cast<ssize_t>(values.size()) - 1, less_than);
+    EXPECT(is_sorted(values));
 }
 
 // This test case may fail to construct a worst-case input if the pivot choice
@@ -95,3 +204,53 @@ TEST_CASE(maximum_stack_depth)
 
     delete[] data;
 }
+
+static void benchmark_sort(InputPattern pattern, auto sort)
+{
+    auto input = make_input(pattern, 100000);
+    for (int i = 0; i < 10; ++i) {
+        auto values = input;
+        sort(values);
+        EXPECT(is_sorted(values));
+    }
+}
+
+BENCHMARK_CASE(quick_sort_random)
+{
+    benchmark_sort(InputPattern::Random, [](auto& values) { quick_sort(values); });
+}
+
+BENCHMARK_CASE(quick_sort_sorted)
+{
+    benchmark_sort(InputPattern::Sorted, [](auto& values) { quick_sort(values); });
+}
+
+BENCHMARK_CASE(quick_sort_reversed)
+{
+    benchmark_sort(InputPattern::Reversed, [](auto& values) { quick_sort(values); });
+}
+
+BENCHMARK_CASE(quick_sort_many_duplicates)
+{
+    benchmark_sort(InputPattern::ManyDuplicates, [](auto& values) { quick_sort(values); });
+}
+
+BENCHMARK_CASE(merge_sort_random)
+{
+    benchmark_sort(InputPattern::Random, [](auto& values) { merge_sort(values); });
+}
+
+BENCHMARK_CASE(merge_sort_sorted)
+{
+    benchmark_sort(InputPattern::Sorted, [](auto& values) { merge_sort(values); });
+}
+
+BENCHMARK_CASE(merge_sort_reversed)
+{
+    benchmark_sort(InputPattern::Reversed, [](auto& values) { merge_sort(values); });
+}
+
+BENCHMARK_CASE(merge_sort_many_duplicates)
+{
+    benchmark_sort(InputPattern::ManyDuplicates, [](auto& values) { merge_sort(values); });
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+
+static IORingCompletion pop_single_completion(Core::IORing& ring)
+{
+    EXPECT_EQ(ring.available_completions(), 1u);
+    auto completion = ring.pop_completion();
+    VERIFY(completion.has_value());
+    return completion.release_value();
+}
+
+TEST_CASE(io_ring_file_round_trip)
+{
+    char pattern[] = "/tmp/io_ring.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    auto ring = MUST(Core::IORing::create(8));
+
+    auto data = "Well hello friends!"sv;
+    MUST(ring->submit_write(fd, data.bytes(), 0, 1));
+    EXPECT_EQ(MUST(ring->submit()), 1u);
+    auto write_completion = pop_single_completion(*ring);
+    EXPECT_EQ(write_completion.user_data, 1u);
+    EXPECT_EQ(write_completion.result, static_cast<i64>(data.length()));
+
+    Array<u8, 64> buffer {};
+    MUST(ring->submit_read(fd, buffer.span(), 0, 2));
+    EXPECT_EQ(MUST(ring->submit()), 1u);
+    auto read_completion = pop_single_completion(*ring);
+    EXPECT_EQ(read_completion.user_data, 2u);
+    EXPECT_EQ(read_completion.result, static_cast<i64>(data.length()));
+    EXPECT_EQ(StringView(buffer.span().trim(data.length())), data);
+
+    MUST(Core::System::close(fd));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+}
+
+TEST_CASE(io_ring_pipe_round_trip)
+{
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    auto ring = MUST(Core::IORing::create(8));
+
+    // Both operations go into one batch and are executed in order, so the read finds the data that was just written.
+    auto data = "Batched pipe data"sv;
+    Array<u8, 64> buffer {};
+    MUST(ring->submit_write(pipe_fds[1], data.bytes(), {}, 1));
+    MUST(ring->submit_read(pipe_fds[0], buffer.span(), {}, 2));
+    EXPECT_EQ(MUST(ring->submit()), 2u);
+    EXPECT_EQ(ring->available_completions(), 2u);
+
+    auto write_completion = ring->pop_completion();
+    VERIFY(write_completion.has_value());
+    EXPECT_EQ(write_completion->user_data, 1u);
+    EXPECT_EQ(write_completion->result, static_cast<i64>(data.length()));
+
+    auto read_completion = ring->pop_completion();
+    VERIFY(read_completion.has_value());
+    EXPECT_EQ(read_completion->user_data, 2u);
+    EXPECT_EQ(read_completion->result, static_cast<i64>(data.length()));
+    EXPECT_EQ(StringView(buffer.span().trim(data.length())), data);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
+
+TEST_CASE(io_ring_reports_errors_as_completions)
+{
+    auto ring = MUST(Core::IORing::create(8));
+    Array<u8, 16> buffer {};
+    MUST(ring->submit_read(-1, buffer.span(), {}, 3));
+    EXPECT_EQ(MUST(ring->submit()), 1u);
+    auto completion = pop_single_completion(*ring);
+    EXPECT_EQ(completion.user_data, 3u);
+    EXPECT_EQ(completion.result, -static_cast<i64>(EBADF));
+}
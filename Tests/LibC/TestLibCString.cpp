@@ -5,9 +5,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <LibTest/TestCase.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 TEST_CASE(strerror_r_basic)
 {
@@ -29,3 +32,202 @@ TEST_CASE(strtok_r_delimiters_only)
     // The string to which `saved_str` initially points to shouldn't be modified.
     EXPECT_EQ(strcmp(dummy, "a;"), 0);
 }
+
+// The byte-at-a-time versions of the functions that have optimized implementations, to check them against
+// and to see how much faster the optimized ones are.
+static size_t scalar_strlen(char const* string)
+{
+    size_t length = 0;
+    while (string[length])
+        ++length;
+    return length;
+}
+
+static void const* scalar_memchr(void const* buffer, int c, size_t length)
+{
+    auto const* bytes = static_cast<u8 const*>(buffer);
+    for (size_t i = 0; i < length; ++i) {
+        if (bytes[i] == static_cast<u8>(c))
+            return bytes + i;
+    }
+    return nullptr;
+}
+
+static char const* scalar_strchr(char const* string, int c)
+{
+    for (;; ++string) {
+        if (*string == static_cast<char>(c))
+            return string;
+        if (!*string)
+            return nullptr;
+    }
+}
+
+static int scalar_memcmp(void const* a, void const* b, size_t length)
+{
+    auto const* a_bytes = static_cast<u8 const*>(a);
+    auto const* b_bytes = static_cast<u8 const*>(b);
+    for (size_t i = 0; i < length; ++i) {
+        if (a_bytes[i] != b_bytes[i])
+            return a_bytes[i] < b_bytes[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static int scalar_strcmp(char const* a, char const* b)
+{
+    for (; *a == *b; ++a, ++b) {
+        if (!*a)
+            return 0;
+    }
+    return *reinterpret_cast<u8 const*>(a) < *reinterpret_cast<u8 const*>(b) ? -1 : 1;
+}
+
+static int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+static constexpr size_t max_tested_length = 300;
+static constexpr size_t max_tested_alignment = 64;
+
+TEST_CASE(string_functions_at_all_lengths_and_alignments)
+{
+    Array<char, max_tested_length + max_tested_alignment + 1> a_storage;
+    Array<char, max_tested_length + max_tested_alignment + 1> b_storage;
+
+    for (size_t alignment = 0; alignment < max_tested_alignment; alignment += 7) {
+        for (size_t length = 0; length < max_tested_length; ++length) {
+            auto* a = a_storage.data() + alignment;
+            auto* b = b_storage.data() + (max_tested_alignment - 1 - alignment);
+            for (size_t i = 0; i < length; ++i)
+                a[i] = static_cast<char>('a' + (i * 7 + length) % 26);
+            a[length] = '\0';
+            memcpy(b, a, length + 1);
+
+            EXPECT_EQ(strlen(a), scalar_strlen(a));
+            EXPECT_EQ(strcmp(a, b), 0);
+            EXPECT_EQ(memcmp(a, b, length), 0);
+            EXPECT_EQ(strchr(a, '\0'), scalar_strchr(a, '\0'));
+            EXPECT_EQ(strchr(a, 'z'), scalar_strchr(a, 'z'));
+            EXPECT_EQ(strchr(a, '#'), nullptr);
+            EXPECT_EQ(memchr(a, 'z', length), scalar_memchr(a, 'z', length));
+            EXPECT_EQ(memchr(a, '\0', length), nullptr);
+
+            if (length == 0)
+                continue;
+
+            // Make the strings differ at every position, with bytes above and below 0x80.
+            auto position = (alignment * 13 + length / 2) % length;
+            b[position] = static_cast<char>(0xf0);
+            EXPECT_EQ(sign(strcmp(a, b)), sign(scalar_strcmp(a, b)));
+            EXPECT_EQ(sign(strcmp(b, a)), sign(scalar_strcmp(b, a)));
+            EXPECT_EQ(sign(memcmp(a, b, length)), sign(scalar_memcmp(a, b, length)));
+            EXPECT_EQ(sign(memcmp(b, a, length)), sign(scalar_memcmp(b, a, length)));
+            EXPECT_EQ(memchr(b, 0xf0, length), scalar_memchr(b, 0xf0, length));
+            EXPECT_EQ(strchr(b, 0xf0), scalar_strchr(b, 0xf0));
+        }
+    }
+}
+
+TEST_CASE(string_functions_at_page_boundary)
+{
+    // Put the strings right in front of an inaccessible page, to make sure nobody reads past the end of them.
+    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto* region = static_cast<char*>(mmap(nullptr, page_size * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    VERIFY(region != MAP_FAILED);
+    EXPECT_EQ(mprotect(region + page_size, page_size, PROT_NONE), 0);
+
+    Array<char, max_tested_length + 1> other;
+    for (size_t length = 0; length < max_tested_length; ++length) {
+        auto* string = region + page_size - length - 1;
+        memset(string, 'x', length);
+        string[length] = '\0';
+        memcpy(other.data(), string, length + 1);
+
+        EXPECT_EQ(strlen(string), length);
+        EXPECT_EQ(strchr(string, 'y'), nullptr);
+        EXPECT_EQ(strchr(string, '\0'), string + length);
+        EXPECT_EQ(memchr(string, 'y', length + 1), nullptr);
+        EXPECT_EQ(strcmp(string, other.data()), 0);
+        EXPECT_EQ(strcmp(other.data(), string), 0);
+        EXPECT_EQ(memcmp(string, other.data(), length + 1), 0);
+    }
+
+    EXPECT_EQ(munmap(region, page_size * 2), 0);
+}
+
+static constexpr Array<size_t, 5> benchmarked_lengths = { 7, 32, 100, 1000, 10000 };
+static constexpr size_t benchmark_iterations = 20000;
+
+// Runs the given function on strings of various lengths and alignments, all of them ending in a null byte.
+template<typename Callback>
+static void run_string_benchmark(Callback callback)
+{
+    static Array<char, 10000 + max_tested_alignment + 1> a_storage;
+    static Array<char, 10000 + max_tested_alignment + 1> b_storage;
+
+    for (auto length : benchmarked_lengths) {
+        for (size_t alignment = 0; alignment < max_tested_alignment; alignment += 13) {
+            auto* a = a_storage.data() + alignment;
+            auto* b = b_storage.data() + (max_tested_alignment - 1 - alignment);
+            memset(a, 'a', length);
+            a[length] = '\0';
+            memcpy(b, a, length + 1);
+            for (size_t i = 0; i < benchmark_iterations * 10 / (length + 10); ++i) {
+                callback(a, b, length);
+                AK::taint_for_optimizer(a);
+            }
+        }
+    }
+}
+
+BENCHMARK_CASE(strlen_scalar)
+{
+    run_string_benchmark([](char* a, char*, size_t length) { EXPECT_EQ(scalar_strlen(a), length); });
+}
+
+BENCHMARK_CASE(strlen_libc)
+{
+    run_string_benchmark([](char* a, char*, size_t length) { EXPECT_EQ(strlen(a), length); });
+}
+
+BENCHMARK_CASE(memchr_scalar)
+{
+    run_string_benchmark([](char* a, char*, size_t length) { EXPECT_EQ(scalar_memchr(a, '\0', length + 1), a + length); });
+}
+
+BENCHMARK_CASE(memchr_libc)
+{
+    run_string_benchmark([](char* a, char*, size_t length) { EXPECT_EQ(memchr(a, '\0', length + 1), a + length); });
+}
+
+BENCHMARK_CASE(strchr_scalar)
+{
+    run_string_benchmark([](char* a, char*, size_t) { EXPECT_EQ(scalar_strchr(a, 'b'), nullptr); });
+}
+
+BENCHMARK_CASE(strchr_libc)
+{
+    run_string_benchmark([](char* a, char*, size_t) { EXPECT_EQ(strchr(a, 'b'), nullptr); });
+}
+
+BENCHMARK_CASE(memcmp_scalar)
+{
+    run_string_benchmark([](char* a, char* b, size_t length) { EXPECT_EQ(scalar_memcmp(a, b, length), 0); });
+}
+
+BENCHMARK_CASE(memcmp_libc)
+{
+    run_string_benchmark([](char* a, char* b, size_t length) { EXPECT_EQ(memcmp(a, b, length), 0); });
+}
+
+BENCHMARK_CASE(strcmp_scalar)
+{
+    run_string_benchmark([](char* a, char* b, size_t) { EXPECT_EQ(scalar_strcmp(a, b), 0); });
+}
+
+BENCHMARK_CASE(strcmp_libc)
+{
+    run_string_benchmark([](char* a, char* b, size_t) { EXPECT_EQ(strcmp(a, b), 0); });
+}
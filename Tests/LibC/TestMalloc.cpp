@@ -4,11 +4,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/HashTable.h>
 #include <LibTest/TestCase.h>
 
 #include <errno.h>
 #include <mallocdefs.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +44,120 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+static constexpr size_t thread_count = 4;
+static constexpr size_t chunks_per_thread = 4096;
+
+// The owners of the chunks have to stay alive while the other threads free them, as chunks
+// freed after their owner exited go straight back to the global pool instead.
+static Atomic<size_t> s_owners_done_allocating { 0 };
+static Atomic<size_t> s_threads_done_freeing { 0 };
+
+static void wait_until(Atomic<size_t>& counter, size_t value)
+{
+    while (counter.load() < value)
+        sched_yield();
+}
+
+struct CrossThreadFreeArguments {
+    Array<void*, chunks_per_thread> chunks;
+    Array<void*, chunks_per_thread> reallocated_chunks;
+    size_t reused_chunks { 0 };
+    u8 fill_byte { 0 };
+};
+
+static size_t chunk_size(size_t index)
+{
+    return size_classes[index % (num_size_classes - 1)];
+}
+
+static void* allocate_chunks(void* argument)
+{
+    auto& arguments = *static_cast<CrossThreadFreeArguments*>(argument);
+    for (size_t i = 0; i < chunks_per_thread; ++i) {
+        arguments.chunks[i] = malloc(chunk_size(i));
+        memset(arguments.chunks[i], arguments.fill_byte, chunk_size(i));
+    }
+    s_owners_done_allocating.fetch_add(1);
+    wait_until(s_threads_done_freeing, thread_count);
+
+    // Allocating again drains the chunks that the other threads handed back to our blocks.
+    HashTable<void*> freed_chunks;
+    for (auto* chunk : arguments.chunks)
+        MUST(freed_chunks.try_set(chunk));
+    for (size_t i = 0; i < chunks_per_thread; ++i) {
+        arguments.reallocated_chunks[i] = malloc(chunk_size(i));
+        memset(arguments.reallocated_chunks[i], arguments.fill_byte, chunk_size(i));
+        if (freed_chunks.contains(arguments.reallocated_chunks[i]))
+            ++arguments.reused_chunks;
+    }
+    return nullptr;
+}
+
+static void* free_chunks(void* argument)
+{
+    auto& arguments = *static_cast<CrossThreadFreeArguments*>(argument);
+    wait_until(s_owners_done_allocating, thread_count);
+    bool contents_are_intact = true;
+    for (auto* chunk : arguments.chunks) {
+        if (*static_cast<u8*>(chunk) != arguments.fill_byte)
+            contents_are_intact = false;
+        free(chunk);
+    }
+    s_threads_done_freeing.fetch_add(1);
+    return contents_are_intact ? nullptr : reinterpret_cast<void*>(1);
+}
+
+TEST_CASE(cross_thread_free)
+{
+    Array<CrossThreadFreeArguments, thread_count> arguments;
+    Array<pthread_t, thread_count> owner_threads;
+    Array<pthread_t, thread_count> freeing_threads;
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        arguments[i].fill_byte = static_cast<u8>(i + 1);
+        EXPECT_EQ(pthread_create(&owner_threads[i], nullptr, allocate_chunks, &arguments[i]), 0);
+    }
+    // Free all chunks on a different thread than the one that allocated them, while their owner is still around.
+    for (size_t i = 0; i < thread_count; ++i)
+        EXPECT_EQ(pthread_create(&freeing_threads[i], nullptr, free_chunks, &arguments[(i + 1) % thread_count]), 0);
+
+    for (auto& thread : freeing_threads) {
+        void* result = nullptr;
+        EXPECT_EQ(pthread_join(thread, &result), 0);
+        EXPECT_EQ(result, nullptr);
+    }
+    for (auto& thread : owner_threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        // The owners must have gotten some of their freed chunks back.
+        EXPECT(arguments[i].reused_chunks > 0);
+        for (size_t j = 0; j < chunks_per_thread; ++j)
+            EXPECT_EQ(*static_cast<u8*>(arguments[i].reallocated_chunks[j]), arguments[i].fill_byte);
+        for (auto* chunk : arguments[i].reallocated_chunks)
+            free(chunk);
+    }
+}
+
+static void* allocate_and_free_in_a_loop(void*)
+{
+    Array<void*, 64> live_chunks {};
+    for (size_t i = 0; i < 1'000'000; ++i) {
+        auto& chunk = live_chunks[i % live_chunks.size()];
+        free(chunk);
+        chunk = malloc(16 + (i % 256));
+    }
+    for (auto* chunk : live_chunks)
+        free(chunk);
+    return nullptr;
+}
+
+BENCHMARK_CASE(multi_threaded_malloc_throughput)
+{
+    Array<pthread_t, thread_count> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, allocate_and_free_in_a_loop, nullptr), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+}
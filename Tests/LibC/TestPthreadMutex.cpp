@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+
+static constexpr size_t thread_count = 4;
+static constexpr size_t iterations_per_thread = 10000;
+
+struct Counter {
+    pthread_mutex_t mutex;
+    size_t value { 0 };
+};
+
+static void* increment_counter(void* argument)
+{
+    auto& counter = *static_cast<Counter*>(argument);
+    for (size_t i = 0; i < iterations_per_thread; ++i) {
+        pthread_mutex_lock(&counter.mutex);
+        ++counter.value;
+        pthread_mutex_unlock(&counter.mutex);
+    }
+    return nullptr;
+}
+
+static void run_contended_counter(pthread_mutexattr_t const* attributes)
+{
+    Counter counter;
+    EXPECT_EQ(pthread_mutex_init(&counter.mutex, attributes), 0);
+
+    Array<pthread_t, thread_count> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, increment_counter, &counter), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    EXPECT_EQ(counter.value, thread_count * iterations_per_thread);
+    EXPECT_EQ(pthread_mutex_destroy(&counter.mutex), 0);
+}
+
+TEST_CASE(mutexattr_protocol)
+{
+    pthread_mutexattr_t attributes;
+    EXPECT_EQ(pthread_mutexattr_init(&attributes), 0);
+
+    int protocol = -1;
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attributes, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_NONE);
+
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT), 0);
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attributes, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_INHERIT);
+
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, 1234), ENOTSUP);
+    EXPECT_EQ(pthread_mutexattr_destroy(&attributes), 0);
+}
+
+TEST_CASE(contended_normal_mutex)
+{
+    run_contended_counter(nullptr);
+}
+
+TEST_CASE(contended_priority_inheriting_mutex)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+    run_contended_counter(&attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+
+TEST_CASE(priority_inheriting_trylock)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+
+    pthread_mutex_t mutex;
+    EXPECT_EQ(pthread_mutex_init(&mutex, &attributes), 0);
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), EBUSY);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+
+    pthread_mutexattr_destroy(&attributes);
+}
+
+TEST_CASE(recursive_priority_inheriting_mutex)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+
+    pthread_mutex_t mutex;
+    EXPECT_EQ(pthread_mutex_init(&mutex, &attributes), 0);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+
+    pthread_mutexattr_destroy(&attributes);
+}
@@ -67,3 +67,103 @@ TEST_CASE(quick_sort)
         }
     }
 }
+
+static void sort_and_check(Vector<SortableObject>& test_objects)
+{
+    qsort(test_objects.data(), test_objects.size(), sizeof(SortableObject), compare_sortable_object);
+    for (auto i = 0u; i + 1 < test_objects.size(); ++i) {
+        auto const& key1 = test_objects[i].m_key;
+        auto const& key2 = test_objects[i + 1].m_key;
+        if (key1 > key2) {
+            FAIL(DeprecatedString::formatted("saw key {} before key {}\n", key1, key2));
+        }
+    }
+    // Check that every object still carries the payload that belongs to its key
+    for (auto const& object : test_objects) {
+        auto const expected = calc_payload_for_pos(object.m_key);
+        if (object.m_payload != expected) {
+            FAIL(DeprecatedString::formatted("Expected payload {} for key {}, got payload {}", expected, object.m_key, object.m_payload));
+        }
+    }
+}
+
+static Vector<SortableObject> make_objects(size_t count, auto key_for_index)
+{
+    Vector<SortableObject> objects;
+    objects.ensure_capacity(count);
+    for (size_t i = 0; i < count; ++i) {
+        int const key = key_for_index(i);
+        objects.unchecked_append({ key, calc_payload_for_pos(key) });
+    }
+    return objects;
+}
+
+TEST_CASE(quick_sort_sorted_and_reversed)
+{
+    auto sorted = make_objects(1024, [](size_t i) { return static_cast<int>(i); });
+    sort_and_check(sorted);
+
+    auto reversed = make_objects(1024, [](size_t i) { return static_cast<int>(1024 - i); });
+    sort_and_check(reversed);
+}
+
+TEST_CASE(quick_sort_many_duplicates)
+{
+    auto objects = make_objects(1024, [](size_t) { return static_cast<int>(get_random_uniform(4)); });
+    sort_and_check(objects);
+}
+
+TEST_CASE(quick_sort_odd_element_size)
+{
+    // Elements that aren't a multiple of the word size get their last few bytes swapped one by one.
+    struct OddObject {
+        u8 key;
+        u8 payload[10];
+    };
+    Vector<OddObject> objects;
+    for (auto i = 0; i < 256; ++i) {
+        OddObject object { static_cast<u8>(255 - i), {} };
+        for (auto& byte : object.payload)
+            byte = object.key;
+        objects.append(object);
+    }
+
+    qsort(objects.data(), objects.size(), sizeof(OddObject), [](void const* a, void const* b) {
+        return static_cast<OddObject const*>(a)->key - static_cast<OddObject const*>(b)->key;
+    });
+
+    for (auto i = 0; i < 256; ++i) {
+        EXPECT_EQ(objects[i].key, i);
+        for (auto byte : objects[i].payload)
+            EXPECT_EQ(byte, i);
+    }
+}
+
+static void benchmark_qsort(auto key_for_index)
+{
+    auto input = make_objects(100000, key_for_index);
+    for (size_t i = 0; i < NUM_RUNS; ++i) {
+        auto objects = input;
+        sort_and_check(objects);
+    }
+}
+
+BENCHMARK_CASE(qsort_random)
+{
+    benchmark_qsort([](size_t) { return static_cast<int>(get_random_uniform(1000000)); });
+}
+
+BENCHMARK_CASE(qsort_sorted)
+{
+    benchmark_qsort([](size_t i) { return static_cast<int>(i); });
+}
+
+BENCHMARK_CASE(qsort_reversed)
+{
+    benchmark_qsort([](size_t i) { return static_cast<int>(100000 - i); });
+}
+
+BENCHMARK_CASE(qsort_many_duplicates)
+{
+    benchmark_qsort([](size_t) { return static_cast<int>(get_random_uniform(16)); });
+}
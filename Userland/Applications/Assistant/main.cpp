@@ -127,7 +127,7 @@ private:
             }
         }
 
-        dual_pivot_quick_sort(all_results, 0, static_cast<int>(all_results.size() - 1), [](auto& a, auto& b) {
+        quick_sort(all_results, [](auto& a, auto& b) {
             return a->score() > b->score();
         });
 
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Types.h>
+#include <cpuid.h>
+#include <string.h>
+
+extern "C" {
+
+extern size_t strlen_sse2(char const*);
+extern size_t strlen_avx2(char const*);
+extern void* memchr_sse2(void const*, int, size_t);
+extern void* memchr_avx2(void const*, int, size_t);
+extern char* strchr_sse2(char const*, int);
+extern char* strchr_avx2(char const*, int);
+extern int memcmp_sse2(void const*, void const*, size_t);
+extern int memcmp_avx2(void const*, void const*, size_t);
+extern int strcmp_sse2(char const*, char const*);
+extern int strcmp_avx2(char const*, char const*);
+
+// Bit 27 of ecx in cpuid[eax = 1] indicates that the OS has enabled XSAVE (and thus XGETBV)
+constexpr u32 cpuid_1_ecx_bit_osxsave = 1 << 27;
+// Bit 28 of ecx in cpuid[eax = 1] indicates support for AVX
+constexpr u32 cpuid_1_ecx_bit_avx = 1 << 28;
+// Bit 5 of ebx in cpuid[eax = 7] indicates support for AVX2
+constexpr u32 cpuid_7_ebx_bit_avx2 = 1 << 5;
+// The SSE and AVX state components in XCR0, both of which have to be enabled by the OS to use ymm registers
+constexpr u32 xcr0_sse_and_avx_state = (1 << 1) | (1 << 2);
+
+namespace {
+bool has_avx2()
+{
+    u32 eax, ebx, ecx, edx;
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    if ((ecx & cpuid_1_ecx_bit_osxsave) == 0 || (ecx & cpuid_1_ecx_bit_avx) == 0)
+        return false;
+
+    u32 xcr0_low, xcr0_high;
+    asm volatile("xgetbv"
+                 : "=a"(xcr0_low), "=d"(xcr0_high)
+                 : "c"(0));
+    if ((xcr0_low & xcr0_sse_and_avx_state) != xcr0_sse_and_avx_state)
+        return false;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & cpuid_7_ebx_bit_avx2) != 0;
+}
+
+[[gnu::used]] decltype(&strlen) resolve_strlen()
+{
+    return has_avx2() ? strlen_avx2 : strlen_sse2;
+}
+
+[[gnu::used]] decltype(&memchr) resolve_memchr()
+{
+    return has_avx2() ? memchr_avx2 : memchr_sse2;
+}
+
+[[gnu::used]] decltype(&strchr) resolve_strchr()
+{
+    return has_avx2() ? strchr_avx2 : strchr_sse2;
+}
+
+[[gnu::used]] decltype(&memcmp) resolve_memcmp()
+{
+    return has_avx2() ? memcmp_avx2 : memcmp_sse2;
+}
+
+[[gnu::used]] decltype(&strcmp) resolve_strcmp()
+{
+    return has_avx2() ? strcmp_avx2 : strcmp_sse2;
+}
+}
+
+#if !defined(AK_COMPILER_CLANG) && !defined(_DYNAMIC_LOADER)
+[[gnu::ifunc("resolve_strlen")]] size_t strlen(char const*);
+[[gnu::ifunc("resolve_memchr")]] void* memchr(void const*, int, size_t);
+[[gnu::ifunc("resolve_strchr")]] char* strchr(char const*, int);
+[[gnu::ifunc("resolve_memcmp")]] int memcmp(void const*, void const*, size_t);
+[[gnu::ifunc("resolve_strcmp")]] int strcmp(char const*, char const*);
+#else
+// See memset.cpp for why we can't use IFUNCs here.
+size_t strlen(char const* string)
+{
+    static decltype(&strlen) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_strlen();
+
+    return s_impl(string);
+}
+
+void* memchr(void const* buffer, int c, size_t length)
+{
+    static decltype(&memchr) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memchr();
+
+    return s_impl(buffer, c, length);
+}
+
+char* strchr(char const* string, int c)
+{
+    static decltype(&strchr) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_strchr();
+
+    return s_impl(string, c);
+}
+
+int memcmp(void const* a, void const* b, size_t length)
+{
+    static decltype(&memcmp) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memcmp();
+
+    return s_impl(a, b, length);
+}
+
+int strcmp(char const* a, char const* b)
+{
+    static decltype(&strcmp) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_strcmp();
+
+    return s_impl(a, b);
+}
+#endif
+}
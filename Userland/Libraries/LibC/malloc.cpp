@@ -49,6 +49,8 @@ bool __heap_is_stable = true;
 constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
+constexpr size_t max_number_of_empty_blocks_per_thread_cache_size_class = 4;
+constexpr size_t number_of_empty_blocks_to_keep_per_thread_cache_size_class = 1;
 
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
@@ -115,6 +117,9 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_releases;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -284,6 +289,77 @@ static void* try_allocate_chunk_aligned(size_t align, ChunkedBlock& block)
     return nullptr;
 }
 
+// Must be called with s_malloc_mutex held. The returned block is not on any list yet.
+static ErrorOr<ChunkedBlock*> take_empty_block(Allocator& allocator, size_t good_size)
+{
+    if (s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        auto* block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        return block;
+    }
+
+    if (s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        auto* block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+        }
+        return block;
+    }
+
+    g_malloc_stats.number_of_block_allocs++;
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+    auto* block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+    new (block) ChunkedBlock(good_size);
+    ++allocator.block_count;
+    return block;
+}
+
+// Must be called with s_malloc_mutex held, and the block must not be on any list.
+static void retire_empty_block(Allocator& allocator, ChunkedBlock& block)
+{
+    if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+        dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", &block);
+        g_malloc_stats.number_of_hot_keeps++;
+        s_hot_empty_blocks[s_hot_empty_block_count++] = &block;
+        return;
+    }
+    if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+        dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", &block);
+        g_malloc_stats.number_of_cold_keeps++;
+        s_cold_empty_blocks[s_cold_empty_block_count++] = &block;
+        mprotect(&block, ChunkedBlock::block_size, PROT_NONE);
+        madvise(&block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+        return;
+    }
+    dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", &block, allocator.size);
+    g_malloc_stats.number_of_frees++;
+    --allocator.block_count;
+    os_free(&block, ChunkedBlock::block_size);
+}
+
 enum class CallerWillInitializeMemory {
     No,
     Yes,
@@ -291,6 +367,224 @@ enum class CallerWillInitializeMemory {
 
 #ifndef NO_TLS
 __thread bool s_allocation_enabled = true;
+
+// Every thread owns a few blocks of each size class, so that the common malloc() and free() calls
+// don't have to take s_malloc_mutex at all. The global pool is only involved when a thread runs out
+// of blocks, ends up with too many empty ones, or exits.
+struct ThreadCache {
+    struct SizeClass {
+        ChunkedBlock::List usable_blocks;
+        ChunkedBlock::List full_blocks;
+        ChunkedBlock::List empty_blocks;
+        size_t empty_block_count { 0 };
+    };
+    SizeClass size_classes[num_size_classes];
+};
+
+enum class ThreadCacheState : u8 {
+    Uninitialized,
+    Active,
+    Destroyed,
+};
+
+// Like the allocators, the thread cache must not be constructed or destructed behind our back.
+alignas(ThreadCache) static __thread u8 s_thread_cache_storage[sizeof(ThreadCache)];
+static __thread ThreadCacheState s_thread_cache_state = ThreadCacheState::Uninitialized;
+
+static ThreadCache* thread_cache()
+{
+    if (s_thread_cache_state == ThreadCacheState::Active) [[likely]]
+        return reinterpret_cast<ThreadCache*>(s_thread_cache_storage);
+    if (s_thread_cache_state == ThreadCacheState::Destroyed)
+        return nullptr;
+    s_thread_cache_state = ThreadCacheState::Active;
+    return new (s_thread_cache_storage) ThreadCache();
+}
+
+static ThreadCache::SizeClass& thread_cache_size_class(ThreadCache& cache, size_t chunk_size)
+{
+    size_t good_size;
+    return cache.size_classes[allocator_for_size(chunk_size, good_size) - allocators()];
+}
+
+// Moves the chunks that other threads freed back onto the freelist, and returns how many there were.
+static size_t take_remote_frees(ChunkedBlock& block, FreelistEntry* new_remote_freelist = nullptr)
+{
+    auto* entry = block.m_remote_freelist.exchange(new_remote_freelist, AK::memory_order_acq_rel);
+    VERIFY(entry != ChunkedBlock::closed_remote_freelist());
+    size_t count = 0;
+    while (entry) {
+        auto* next = entry->next;
+        entry->next = block.m_freelist;
+        block.m_freelist = entry;
+        entry = next;
+        ++count;
+    }
+    return count;
+}
+
+// Returns false if the remote freelist was closed, i.e. the owner gave the block back to the global pool.
+static bool push_remote_free(ChunkedBlock& block, FreelistEntry* entry)
+{
+    auto* head = block.m_remote_freelist.load(AK::memory_order_relaxed);
+    do {
+        if (head == ChunkedBlock::closed_remote_freelist())
+            return false;
+        entry->next = head;
+    } while (!block.m_remote_freelist.compare_exchange_strong(head, entry, AK::memory_order_release));
+    return true;
+}
+
+// Must be called with s_malloc_mutex held, and the block must not be on any list of its owner.
+static void release_block_to_global_pool(ChunkedBlock& block)
+{
+    g_malloc_stats.number_of_thread_cache_releases++;
+    block.m_owner.store(nullptr, AK::memory_order_relaxed);
+    block.m_free_chunks += take_remote_frees(block, ChunkedBlock::closed_remote_freelist());
+
+    size_t good_size;
+    auto* allocator = allocator_for_size(block.m_size, good_size);
+    if (!block.used_chunks())
+        retire_empty_block(*allocator, block);
+    else if (block.is_full())
+        allocator->full_blocks.append(block);
+    else
+        allocator->usable_blocks.append(block);
+}
+
+static ErrorOr<ChunkedBlock*> adopt_block_from_global_pool(ThreadCache& cache, Allocator& allocator, size_t good_size)
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+    g_malloc_stats.number_of_thread_cache_refills++;
+
+    auto* block = allocator.usable_blocks.take_first();
+    if (!block)
+        block = TRY(take_empty_block(allocator, good_size));
+
+    block->m_owner.store(&cache, AK::memory_order_relaxed);
+    auto* remote_freelist = block->m_remote_freelist.exchange(nullptr, AK::memory_order_acq_rel);
+    VERIFY(remote_freelist == ChunkedBlock::closed_remote_freelist());
+    return block;
+}
+
+static ErrorOr<void*> allocate_from_thread_cache(ThreadCache& cache, Allocator& allocator, size_t good_size)
+{
+    auto& cache_class = cache.size_classes[&allocator - allocators()];
+
+    auto* block = cache_class.usable_blocks.first();
+    if (!block) {
+        block = cache_class.empty_blocks.take_first();
+        if (block) {
+            --cache_class.empty_block_count;
+            cache_class.usable_blocks.append(*block);
+        }
+    }
+
+    if (!block) {
+        // Other threads may have freed some chunks of our full blocks in the meantime.
+        for (auto& current : cache_class.full_blocks) {
+            if (!current.m_remote_freelist.load(AK::memory_order_relaxed))
+                continue;
+            if (auto freed_chunks = take_remote_frees(current)) {
+                current.m_free_chunks += freed_chunks;
+                block = &current;
+                break;
+            }
+        }
+        if (block) {
+            cache_class.full_blocks.remove(*block);
+            cache_class.usable_blocks.append(*block);
+        }
+    }
+
+    if (!block) {
+        block = TRY(adopt_block_from_global_pool(cache, allocator, good_size));
+        cache_class.usable_blocks.append(*block);
+    }
+
+    void* ptr = try_allocate_chunk_aligned(1, *block);
+    VERIFY(ptr);
+
+    if (block->is_full()) {
+        block->m_free_chunks += take_remote_frees(*block);
+        if (block->is_full()) {
+            cache_class.usable_blocks.remove(*block);
+            cache_class.full_blocks.append(*block);
+        }
+    }
+    return ptr;
+}
+
+static void trim_empty_blocks(ThreadCache::SizeClass& cache_class)
+{
+    // Give the extra empty blocks back in one go, so we only take the lock once.
+    PthreadMutexLocker locker(s_malloc_mutex);
+    while (cache_class.empty_block_count > number_of_empty_blocks_to_keep_per_thread_cache_size_class) {
+        auto* block = cache_class.empty_blocks.take_last();
+        --cache_class.empty_block_count;
+        release_block_to_global_pool(*block);
+    }
+}
+
+static void free_to_thread_cache(ThreadCache& cache, ChunkedBlock& block, FreelistEntry* entry)
+{
+    auto& cache_class = thread_cache_size_class(cache, block.m_size);
+
+    bool was_full = block.is_full();
+    entry->next = block.m_freelist;
+    block.m_freelist = entry;
+    ++block.m_free_chunks;
+
+    if (was_full) {
+        cache_class.full_blocks.remove(block);
+        cache_class.usable_blocks.prepend(block);
+    }
+
+    if (!block.used_chunks()) {
+        cache_class.usable_blocks.remove(block);
+        cache_class.empty_blocks.append(block);
+        if (++cache_class.empty_block_count > max_number_of_empty_blocks_per_thread_cache_size_class)
+            trim_empty_blocks(cache_class);
+    }
+}
+
+// Returns false if the block is not owned by a thread cache, in which case the chunk has to go back to the global pool.
+static bool try_free_without_lock(ChunkedBlock& block, void* ptr)
+{
+    auto* owner = block.m_owner.load(AK::memory_order_relaxed);
+    if (!owner)
+        return false;
+
+    if (s_scrub_free)
+        memset(ptr, FREE_SCRUB_BYTE, block.bytes_per_chunk());
+
+    auto* entry = (FreelistEntry*)ptr;
+    if (owner == reinterpret_cast<ThreadCache*>(s_thread_cache_storage)) {
+        free_to_thread_cache(*owner, block, entry);
+        return true;
+    }
+    return push_remote_free(block, entry);
+}
+
+void __malloc_thread_exit()
+{
+    if (s_thread_cache_state == ThreadCacheState::Active) {
+        auto& cache = *reinterpret_cast<ThreadCache*>(s_thread_cache_storage);
+        auto release_blocks = [](ChunkedBlock::List& blocks) {
+            while (auto* block = blocks.take_first())
+                release_block_to_global_pool(*block);
+        };
+
+        PthreadMutexLocker locker(s_malloc_mutex);
+        for (auto& cache_class : cache.size_classes) {
+            release_blocks(cache_class.usable_blocks);
+            release_blocks(cache_class.full_blocks);
+            release_blocks(cache_class.empty_blocks);
+            cache_class.empty_block_count = 0;
+        }
+    }
+    s_thread_cache_state = ThreadCacheState::Destroyed;
+}
 #endif
 
 static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
@@ -321,6 +615,18 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
+#ifndef NO_TLS
+    if (allocator && align <= 16) {
+        if (auto* cache = thread_cache()) {
+            void* ptr = TRY(allocate_from_thread_cache(*cache, *allocator, good_size));
+            if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+            ue_notify_malloc(ptr, size);
+            return ptr;
+        }
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -377,50 +683,9 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         }
     }
 
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
     if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
+        block = TRY(take_empty_block(*allocator, good_size));
         allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
     }
 
     if (!ptr) {
@@ -459,6 +724,11 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+#ifndef NO_TLS
+    if (magic == MAGIC_PAGE_HEADER && try_free_without_lock(*(ChunkedBlock*)block_base, ptr))
+        return;
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
@@ -495,6 +765,15 @@ static void free_impl(void* ptr)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
     auto* entry = (FreelistEntry*)ptr;
+
+#ifndef NO_TLS
+    // A thread cache may have adopted the block while we were waiting for the lock.
+    if (block->m_owner.load(AK::memory_order_relaxed)) {
+        VERIFY(push_remote_free(*block, entry));
+        return;
+    }
+#endif
+
     entry->next = block->m_freelist;
     block->m_freelist = entry;
 
@@ -512,27 +791,8 @@ static void free_impl(void* ptr)
     if (!block->used_chunks()) {
         size_t good_size;
         auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
         allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
+        retire_empty_block(*allocator, *block);
     }
 }
 
@@ -705,5 +965,8 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln("thread cache releases: {}", g_malloc_stats.number_of_thread_cache_releases);
 }
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Types.h>
 
@@ -22,6 +23,7 @@ static constexpr size_t num_size_classes = (sizeof(size_classes) / sizeof(unsign
 #ifndef NO_TLS
 extern "C" {
 extern __thread bool s_allocation_enabled;
+void __malloc_thread_exit();
 }
 #endif
 
@@ -53,6 +55,8 @@ struct FreelistEntry {
     FreelistEntry* next;
 };
 
+struct ThreadCache;
+
 struct ChunkedBlock : public CommonHeader {
 
     static constexpr size_t block_size = 64 * KiB;
@@ -69,6 +73,11 @@ struct ChunkedBlock : public CommonHeader {
     size_t m_next_lazy_freelist_index { 0 };
     FreelistEntry* m_freelist { nullptr };
     size_t m_free_chunks { 0 };
+    // Blocks that are owned by a thread cache are only ever touched by their owning thread.
+    // Other threads hand their chunks back via the remote freelist, which the owner picks up later.
+    // While no thread owns the block, the remote freelist is closed and frees go to the global pool.
+    Atomic<ThreadCache*> m_owner { nullptr };
+    Atomic<FreelistEntry*> m_remote_freelist { closed_remote_freelist() };
     alignas(16) unsigned char m_slot[0];
 
     void* chunk(size_t index)
@@ -81,5 +90,7 @@ struct ChunkedBlock : public CommonHeader {
     size_t used_chunks() const { return chunk_capacity() - m_free_chunks; }
     size_t chunk_capacity() const { return (block_size - sizeof(ChunkedBlock)) / m_size; }
 
+    static FreelistEntry* closed_remote_freelist() { return reinterpret_cast<FreelistEntry*>(1); }
+
     using List = IntrusiveList<&ChunkedBlock::m_list_node>;
 };
@@ -155,6 +155,14 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
+    // NOTE: Threads can't be requeued onto a priority-inheritance mutex, since only the kernel may
+    //       hand those to a sleeping waiter. Instead, we wake everybody and let them fight over it.
+    if (mutex->protocol == PTHREAD_PRIO_INHERIT) {
+        int rc = futex_wake(&cond->value, INT_MAX, false);
+        VERIFY(rc >= 0);
+        return 0;
+    }
+
     int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, nullptr, &mutex->lock, INT_MAX);
     VERIFY(rc >= 0);
     return 0;
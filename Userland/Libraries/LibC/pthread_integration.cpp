@@ -6,6 +6,7 @@
 
 #include <AK/Atomic.h>
 #include <AK/NeverDestroyed.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <bits/pthread_integration.h>
@@ -97,6 +98,63 @@ static constexpr u32 MUTEX_UNLOCKED = 0;
 static constexpr u32 MUTEX_LOCKED_NO_NEED_TO_WAKE = 1;
 static constexpr u32 MUTEX_LOCKED_NEED_TO_WAKE = 2;
 
+// How many times we check the lock word before going to sleep on a contended mutex.
+static constexpr size_t MUTEX_SPIN_COUNT = 100;
+
+static bool is_multiprocessor()
+{
+    static Atomic<long> s_processor_count { 0 };
+    long processor_count = s_processor_count.load(AK::memory_order_relaxed);
+    if (processor_count == 0) {
+        processor_count = max(sysconf(_SC_NPROCESSORS_ONLN), 1l);
+        s_processor_count.store(processor_count, AK::memory_order_relaxed);
+    }
+    return processor_count > 1;
+}
+
+static ALWAYS_INLINE void spin_loop_hint()
+{
+#if ARCH(X86_64)
+    __builtin_ia32_pause();
+#elif ARCH(AARCH64)
+    asm volatile("yield");
+#endif
+}
+
+// On a multiprocessor system, the owner is probably running right now and about to release the mutex,
+// so we spin for a little while before paying for a trip into the kernel. Once somebody is sleeping on
+// the mutex the owner has clearly been holding on to it for a while, so we stop spinning at that point.
+static bool try_lock_spinning(pthread_mutex_t* mutex, u32& value)
+{
+    if (!is_multiprocessor())
+        return false;
+    for (size_t i = 0; i < MUTEX_SPIN_COUNT && value != MUTEX_LOCKED_NEED_TO_WAKE; ++i) {
+        spin_loop_hint();
+        value = AK::atomic_load(&mutex->lock, AK::memory_order_relaxed);
+        if (value == MUTEX_UNLOCKED && AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+// Priority-inheritance mutexes store the TID of their owner in the lock word, so that the kernel
+// knows whose priority to boost while we wait. The kernel also does the spinning for us, since it
+// knows whether the owner is actually running.
+static int lock_priority_inheriting_mutex(pthread_mutex_t* mutex)
+{
+    int rc;
+    do {
+        rc = futex(&mutex->lock, FUTEX_LOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0)
+        return errno;
+
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
+    mutex->level = 0;
+    return 0;
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_init.html
 int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attributes)
 {
@@ -104,6 +162,7 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
@@ -111,7 +170,8 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
     u32 expected = MUTEX_UNLOCKED;
-    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+    u32 desired = mutex->protocol == __PTHREAD_PRIO_INHERIT ? static_cast<u32>(pthread_self()) : MUTEX_LOCKED_NO_NEED_TO_WAKE;
+    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, desired, AK::memory_order_acquire);
 
     if (exchanged) [[likely]] {
         if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
@@ -132,9 +192,12 @@ int pthread_mutex_trylock(pthread_mutex_t* mutex)
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_lock.html
 int pthread_mutex_lock(pthread_mutex_t* mutex)
 {
+    bool is_priority_inheriting = mutex->protocol == __PTHREAD_PRIO_INHERIT;
+
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
-    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+    u32 desired = is_priority_inheriting ? static_cast<u32>(pthread_self()) : MUTEX_LOCKED_NO_NEED_TO_WAKE;
+    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, desired, AK::memory_order_acquire);
     if (exchanged) [[likely]] {
         if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
             AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
@@ -149,6 +212,17 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
         }
     }
 
+    if (is_priority_inheriting)
+        return lock_priority_inheriting_mutex(mutex);
+
+    // Spin a bit, as the owner may be about to release the mutex.
+    if (try_lock_spinning(mutex, value)) {
+        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+            AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
+        mutex->level = 0;
+        return 0;
+    }
+
     // Slow path: wait, record the fact that we're going to wait, and always
     // remember to wake the next thread up once we release the mutex.
     if (value != MUTEX_LOCKED_NEED_TO_WAKE)
@@ -170,6 +244,9 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return lock_priority_inheriting_mutex(mutex);
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     while (value != MUTEX_UNLOCKED) {
         futex_wait(&mutex->lock, value, nullptr, 0, false);
@@ -193,6 +270,16 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
         AK::atomic_store(&mutex->owner, 0, AK::memory_order_relaxed);
 
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        // If anybody is waiting, the kernel has to pick who gets the mutex next.
+        u32 expected = static_cast<u32>(pthread_self());
+        if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_UNLOCKED, AK::memory_order_release)) {
+            int rc = futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+            VERIFY(rc >= 0);
+        }
+        return 0;
+    }
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_UNLOCKED, AK::memory_order_release);
     if (value == MUTEX_LOCKED_NEED_TO_WAKE) [[unlikely]] {
         int rc = futex_wake(&mutex->lock, 1, false);
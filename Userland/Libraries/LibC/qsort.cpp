@@ -7,6 +7,7 @@
 #include <AK/Assertions.h>
 #include <AK/QuickSort.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 
 class SizedObject {
@@ -32,11 +33,22 @@ inline void swap(SizedObject const& a, SizedObject const& b)
 {
     VERIFY(a.size() == b.size());
     const size_t size = a.size();
-    auto const a_data = reinterpret_cast<char*>(a.data());
-    auto const b_data = reinterpret_cast<char*>(b.data());
-    for (auto i = 0u; i < size; ++i) {
-        swap(a_data[i], b_data[i]);
+    auto const a_data = reinterpret_cast<u8*>(a.data());
+    auto const b_data = reinterpret_cast<u8*>(b.data());
+
+    // Swap a word at a time, as elements tend to be a few words in size.
+    // NOTE: The elements don't have to be aligned, so we go through memcpy, which compiles down to plain loads and stores.
+    size_t i = 0;
+    for (; i + sizeof(FlatPtr) <= size; i += sizeof(FlatPtr)) {
+        FlatPtr a_word;
+        FlatPtr b_word;
+        memcpy(&a_word, a_data + i, sizeof(FlatPtr));
+        memcpy(&b_word, b_data + i, sizeof(FlatPtr));
+        memcpy(a_data + i, &b_word, sizeof(FlatPtr));
+        memcpy(b_data + i, &a_word, sizeof(FlatPtr));
     }
+    for (; i < size; ++i)
+        swap(a_data[i], b_data[i]);
 }
 
 }
@@ -68,7 +80,7 @@ void qsort(void* bot, size_t nmemb, size_t size, int (*compar)(void const*, void
 
     SizedObjectSlice slice { bot, size };
 
-    AK::dual_pivot_quick_sort(slice, 0, nmemb - 1, [=](SizedObject const& a, SizedObject const& b) { return compar(a.data(), b.data()) < 0; });
+    AK::pattern_defeating_quick_sort(slice, 0, nmemb - 1, [=](SizedObject const& a, SizedObject const& b) { return compar(a.data(), b.data()) < 0; });
 }
 
 void qsort_r(void* bot, size_t nmemb, size_t size, int (*compar)(void const*, void const*, void*), void* arg)
@@ -79,5 +91,5 @@ void qsort_r(void* bot, size_t nmemb, size_t size, int (*compar)(void const*, vo
 
     SizedObjectSlice slice { bot, size };
 
-    AK::dual_pivot_quick_sort(slice, 0, nmemb - 1, [=](SizedObject const& a, SizedObject const& b) { return compar(a.data(), b.data(), arg) < 0; });
+    AK::pattern_defeating_quick_sort(slice, 0, nmemb - 1, [=](SizedObject const& a, SizedObject const& b) { return compar(a.data(), b.data(), arg) < 0; });
 }
@@ -101,6 +101,42 @@ int anon_create(size_t size, int options)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int io_ring_create(uint32_t entries, int options)
+{
+    int rc = syscall(SC_io_ring_create, entries, options);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(int fd, uint32_t to_submit)
+{
+    int rc = syscall(SC_io_ring_enter, fd, to_submit);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int readiness_queue_create(int options)
+{
+    int rc = syscall(SC_readiness_queue_create, options);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int readiness_queue_ctl(int queue_fd, int operation, int fd, ReadinessEvent const* event)
+{
+    int rc = syscall(SC_readiness_queue_ctl, queue_fd, operation, fd, event);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int readiness_queue_wait(int queue_fd, ReadinessEvent* events, int max_events, struct timespec const* timeout)
+{
+    int rc = syscall(SC_readiness_queue_wait, queue_fd, events, max_events, timeout);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+ssize_t sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    int rc = syscall(SC_sendfile, out_fd, in_fd, offset, count);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int serenity_readlink(char const* path, size_t path_length, char* buffer, size_t buffer_size)
 {
     Syscall::SC_readlink_params small_params {
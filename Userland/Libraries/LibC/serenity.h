@@ -61,6 +61,16 @@ int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size);
 
 int anon_create(size_t size, int options);
 
+int io_ring_create(uint32_t entries, int options);
+int io_ring_enter(int fd, uint32_t to_submit);
+
+struct ReadinessEvent;
+int readiness_queue_create(int options);
+int readiness_queue_ctl(int queue_fd, int operation, int fd, struct ReadinessEvent const* event);
+int readiness_queue_wait(int queue_fd, struct ReadinessEvent* events, int max_events, struct timespec const* timeout);
+
+ssize_t sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+
 int serenity_readlink(char const* path, size_t path_length, char* buffer, size_t buffer_size);
 
 int getkeymap(char* name_buffer, size_t name_buffer_size, uint32_t* map, uint32_t* shift_map, uint32_t* alt_map, uint32_t* altgr_map, uint32_t* shift_altgr_map);
@@ -50,6 +50,8 @@ size_t strcspn(char const* s, char const* reject)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strlen.html
+// For x86-64, an optimized ASM implementation is found in ./arch/x86_64/string.S
+#if !ARCH(X86_64)
 size_t strlen(char const* str)
 {
     size_t len = 0;
@@ -57,6 +59,7 @@ size_t strlen(char const* str)
         ++len;
     return len;
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strnlen.html
 size_t strnlen(char const* str, size_t maxlen)
@@ -92,6 +95,8 @@ char* strndup(char const* str, size_t maxlen)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strcmp.html
+// For x86-64, an optimized ASM implementation is found in ./arch/x86_64/string.S
+#if !ARCH(X86_64)
 int strcmp(char const* s1, char const* s2)
 {
     while (*s1 == *s2++)
@@ -99,6 +104,7 @@ int strcmp(char const* s1, char const* s2)
             return 0;
     return *(unsigned char const*)s1 - *(unsigned char const*)--s2;
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strncmp.html
 int strncmp(char const* s1, char const* s2, size_t n)
@@ -115,6 +121,8 @@ int strncmp(char const* s1, char const* s2, size_t n)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memcmp.html
+// For x86-64, an optimized ASM implementation is found in ./arch/x86_64/string.S
+#if !ARCH(X86_64)
 int memcmp(void const* v1, void const* v2, size_t n)
 {
     auto* s1 = (uint8_t const*)v1;
@@ -125,6 +133,7 @@ int memcmp(void const* v1, void const* v2, size_t n)
     }
     return 0;
 }
+#endif
 
 // Not in POSIX, originated in BSD
 // https://man.openbsd.org/timingsafe_memcmp.3
@@ -233,6 +242,8 @@ size_t strlcpy(char* dest, char const* src, size_t n)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strchr.html
+// For x86-64, an optimized ASM implementation is found in ./arch/x86_64/string.S
+#if !ARCH(X86_64)
 char* strchr(char const* str, int c)
 {
     char ch = c;
@@ -243,6 +254,7 @@ char* strchr(char const* str, int c)
             return nullptr;
     }
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699959399/functions/index.html
 char* index(char const* str, int c)
@@ -261,6 +273,8 @@ char* strchrnul(char const* str, int c)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memchr.html
+// For x86-64, an optimized ASM implementation is found in ./arch/x86_64/string.S
+#if !ARCH(X86_64)
 void* memchr(void const* ptr, int c, size_t size)
 {
     char ch = c;
@@ -271,6 +285,7 @@ void* memchr(void const* ptr, int c, size_t size)
     }
     return nullptr;
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strrchr.html
 char* strrchr(char const* str, int ch)
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/IDAllocator.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
@@ -16,6 +17,7 @@
 #include <LibCore/Socket.h>
 #include <LibCore/System.h>
 #include <LibCore/ThreadEventQueue.h>
+#include <poll.h>
 #include <sys/select.h>
 #include <unistd.h>
 
@@ -53,6 +55,9 @@ struct ThreadData {
     {
         pid = getpid();
         initialize_wake_pipe();
+#if defined(AK_OS_SERENITY)
+        initialize_readiness_queue();
+#endif
     }
 
     void initialize_wake_pipe()
@@ -73,10 +78,60 @@ struct ThreadData {
         VERIFY(rc == 0);
     }
 
+#if defined(AK_OS_SERENITY)
+    void initialize_readiness_queue()
+    {
+        if (readiness_queue_fd != -1)
+            close(readiness_queue_fd);
+        notifiers_by_fd.clear();
+
+        readiness_queue_fd = MUST(Core::System::readiness_queue_create(O_CLOEXEC));
+        ReadinessEvent wake_pipe_event { .user_data = static_cast<u64>(wake_pipe_fds[0]), .events = POLLIN, .reserved = 0 };
+        MUST(Core::System::readiness_queue_ctl(readiness_queue_fd, READINESS_QUEUE_ADD, wake_pipe_fds[0], &wake_pipe_event));
+    }
+
+    // Tell the kernel which events we care about for `fd`, based on the notifiers currently registered for it.
+    void update_readiness_interest(int fd)
+    {
+        u32 events = 0;
+        if (auto it = notifiers_by_fd.find(fd); it != notifiers_by_fd.end()) {
+            for (auto* notifier : it->value) {
+                if (notifier->type() == Notifier::Type::Read)
+                    events |= POLLIN;
+                if (notifier->type() == Notifier::Type::Write)
+                    events |= POLLOUT;
+                if (notifier->type() == Notifier::Type::Exceptional)
+                    TODO();
+            }
+        }
+
+        if (events == 0) {
+            notifiers_by_fd.remove(fd);
+            // NOTE: This fails harmlessly if the fd was closed before its notifier was unregistered.
+            (void)Core::System::readiness_queue_ctl(readiness_queue_fd, READINESS_QUEUE_REMOVE, fd, nullptr);
+            return;
+        }
+
+        ReadinessEvent event { .user_data = static_cast<u64>(fd), .events = events, .reserved = 0 };
+        auto result = Core::System::readiness_queue_ctl(readiness_queue_fd, READINESS_QUEUE_MODIFY, fd, &event);
+        if (result.is_error() && result.error().code() == ENOENT)
+            result = Core::System::readiness_queue_ctl(readiness_queue_fd, READINESS_QUEUE_ADD, fd, &event);
+        if (result.is_error())
+            dbgln("EventLoopImplementationUnix: Failed to watch fd {}: {}", fd, result.error());
+    }
+#endif
+
     // Each thread has its own timers, notifiers and a wake pipe.
     HashMap<int, NonnullOwnPtr<EventLoopTimer>> timers;
     HashTable<Notifier*> notifiers;
 
+#if defined(AK_OS_SERENITY)
+    // On Serenity, interest in each notifier's fd is registered with a kernel readiness queue once,
+    // so waiting for events only hands back the fds that are actually ready.
+    int readiness_queue_fd { -1 };
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+#endif
+
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
     int wake_pipe_fds[2] { -1, -1 };
@@ -139,13 +194,42 @@ void EventLoopImplementationUnix::wake()
     MUST(Core::System::write((*m_wake_pipe_fds)[1], { &wake_event, sizeof(wake_event) }));
 }
 
-void EventLoopManagerUnix::wait_for_events(EventLoopImplementation::PumpMode mode)
+#if defined(AK_OS_SERENITY)
+static int wait_for_ready_notifiers(ThreadData& thread_data, Optional<Duration> const& timeout, bool& wake_pipe_is_readable, Vector<Notifier*, 16>& ready_notifiers)
+{
+    Array<ReadinessEvent, 64> events;
+    struct timespec timeout_spec = {};
+    if (timeout.has_value())
+        timeout_spec = timeout->to_timespec();
+
+    auto ready_count_or_error = Core::System::readiness_queue_wait(thread_data.readiness_queue_fd, events.span(), timeout.has_value() ? &timeout_spec : nullptr);
+    if (ready_count_or_error.is_error())
+        return -ready_count_or_error.error().code();
+
+    auto ready_count = ready_count_or_error.value();
+    for (size_t i = 0; i < ready_count; ++i) {
+        auto fd = static_cast<int>(events[i].user_data);
+        if (fd == thread_data.wake_pipe_fds[0]) {
+            wake_pipe_is_readable = true;
+            continue;
+        }
+        auto it = thread_data.notifiers_by_fd.find(fd);
+        if (it == thread_data.notifiers_by_fd.end())
+            continue;
+        for (auto* notifier : it->value) {
+            if (notifier->type() == Notifier::Type::Read && (events[i].events & POLLIN))
+                ready_notifiers.append(notifier);
+            if (notifier->type() == Notifier::Type::Write && (events[i].events & POLLOUT))
+                ready_notifiers.append(notifier);
+        }
+    }
+    return static_cast<int>(ready_count);
+}
+#else
+static int wait_for_ready_notifiers(ThreadData& thread_data, Optional<Duration> const& timeout, bool& wake_pipe_is_readable, Vector<Notifier*, 16>& ready_notifiers)
 {
-    auto& thread_data = ThreadData::the();
-
     fd_set read_fds {};
     fd_set write_fds {};
-retry:
     int max_fd = 0;
     auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
         FD_SET(fd, &set);
@@ -165,13 +249,42 @@ retry:
             TODO();
     }
 
+    struct timeval timeout_value = {};
+    if (timeout.has_value())
+        timeout_value = timeout->to_timeval();
+
+    int marked_fd_count = select(max_fd + 1, &read_fds, &write_fds, nullptr, timeout.has_value() ? &timeout_value : nullptr);
+    if (marked_fd_count < 0)
+        return -errno;
+
+    wake_pipe_is_readable = FD_ISSET(thread_data.wake_pipe_fds[0], &read_fds);
+    for (auto& notifier : thread_data.notifiers) {
+        if (notifier->type() == Notifier::Type::Read && FD_ISSET(notifier->fd(), &read_fds))
+            ready_notifiers.append(notifier);
+        if (notifier->type() == Notifier::Type::Write && FD_ISSET(notifier->fd(), &write_fds))
+            ready_notifiers.append(notifier);
+    }
+    return marked_fd_count;
+}
+#endif
+
+void EventLoopManagerUnix::wait_for_events(EventLoopImplementation::PumpMode mode)
+{
+    auto& thread_data = ThreadData::the();
+
+    bool wake_pipe_is_readable = false;
+    Vector<Notifier*, 16> ready_notifiers;
+retry:
+    wake_pipe_is_readable = false;
+    ready_notifiers.clear_with_capacity();
+
     bool has_pending_events = ThreadEventQueue::current().has_pending_events();
 
     // Figure out how long to wait at maximum.
     // This mainly depends on the PumpMode and whether we have pending events, but also the next expiring timer.
+    // An empty timeout means we wait forever.
     MonotonicTime now = MonotonicTime::now_coarse();
-    struct timeval timeout = { 0, 0 };
-    bool should_wait_forever = false;
+    Optional<Duration> timeout = Duration::zero();
     if (mode == EventLoopImplementation::PumpMode::WaitForEvents && !has_pending_events) {
         auto next_timer_expiration = get_next_timer_expiration();
         if (next_timer_expiration.has_value()) {
@@ -179,27 +292,27 @@ retry:
             auto computed_timeout = next_timer_expiration.value() - now;
             if (computed_timeout.is_negative())
                 computed_timeout = Duration::zero();
-            timeout = computed_timeout.to_timeval();
+            timeout = computed_timeout;
         } else {
-            should_wait_forever = true;
+            timeout = {};
         }
     }
 
-try_select_again:
-    // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
-    int marked_fd_count = select(max_fd + 1, &read_fds, &write_fds, nullptr, should_wait_forever ? nullptr : &timeout);
-    // Because POSIX, we might spuriously return from select() with EINTR; just select again.
+try_wait_again:
+    // Wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+    int marked_fd_count = wait_for_ready_notifiers(thread_data, timeout, wake_pipe_is_readable, ready_notifiers);
+    // Because POSIX, we might spuriously return from waiting with EINTR; just wait again.
     if (marked_fd_count < 0) {
-        int saved_errno = errno;
+        int saved_errno = -marked_fd_count;
         if (saved_errno == EINTR)
-            goto try_select_again;
+            goto try_wait_again;
         dbgln("EventLoopImplementationUnix::wait_for_events: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
         VERIFY_NOT_REACHED();
     }
 
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (FD_ISSET(thread_data.wake_pipe_fds[0], &read_fds)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -257,14 +370,8 @@ try_select_again:
         return;
 
     // Handle file system notifiers by making them normal events.
-    for (auto& notifier : thread_data.notifiers) {
-        if (notifier->type() == Notifier::Type::Read && FD_ISSET(notifier->fd(), &read_fds)) {
-            ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
-        }
-        if (notifier->type() == Notifier::Type::Write && FD_ISSET(notifier->fd(), &write_fds)) {
-            ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
-        }
-    }
+    for (auto* notifier : ready_notifiers)
+        ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd()));
 }
 
 class SignalHandlers : public RefCounted<SignalHandlers> {
@@ -340,6 +447,9 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
     thread_data.timers.clear();
     thread_data.notifiers.clear();
     thread_data.initialize_wake_pipe();
+#if defined(AK_OS_SERENITY)
+    thread_data.initialize_readiness_queue();
+#endif
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
         info->next_signal_id = 0;
@@ -506,12 +616,29 @@ bool EventLoopManagerUnix::unregister_timer(int timer_id)
 
 void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
-    ThreadData::the().notifiers.set(&notifier);
+    auto& thread_data = ThreadData::the();
+    thread_data.notifiers.set(&notifier);
+#if defined(AK_OS_SERENITY)
+    auto& notifiers_for_fd = thread_data.notifiers_by_fd.ensure(notifier.fd());
+    if (notifiers_for_fd.contains_slow(&notifier))
+        return;
+    notifiers_for_fd.append(&notifier);
+    thread_data.update_readiness_interest(notifier.fd());
+#endif
 }
 
 void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
 {
-    ThreadData::the().notifiers.remove(&notifier);
+    auto& thread_data = ThreadData::the();
+    thread_data.notifiers.remove(&notifier);
+#if defined(AK_OS_SERENITY)
+    auto it = thread_data.notifiers_by_fd.find(notifier.fd());
+    if (it == thread_data.notifiers_by_fd.end())
+        return;
+    if (!it->value.remove_first_matching([&](auto* other) { return other == &notifier; }))
+        return;
+    thread_data.update_readiness_interest(notifier.fd());
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
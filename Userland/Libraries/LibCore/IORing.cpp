@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+namespace Core {
+
+ErrorOr<NonnullOwnPtr<IORing>> IORing::create(u32 entries)
+{
+    if (entries == 0 || entries > IO_RING_MAX_ENTRIES || !is_power_of_two(entries))
+        return Error::from_errno(EINVAL);
+
+    auto fd = TRY(System::io_ring_create(entries, O_CLOEXEC));
+    auto ring_size = io_ring_mapping_size(entries);
+    auto ring_or_error = System::mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "IORing"sv);
+    if (ring_or_error.is_error()) {
+        (void)System::close(fd);
+        return ring_or_error.release_error();
+    }
+    return adopt_nonnull_own_or_enomem(new (nothrow) IORing(fd, static_cast<u8*>(ring_or_error.value()), ring_size, entries));
+}
+
+IORing::IORing(int fd, u8* ring, size_t ring_size, u32 entries)
+    : m_fd(fd)
+    , m_ring(ring)
+    , m_ring_size(ring_size)
+    , m_submission_entries(entries)
+    , m_completion_entries(io_ring_completion_entries(entries))
+{
+}
+
+IORing::~IORing()
+{
+    auto result = System::munmap(m_ring, m_ring_size);
+    if (result.is_error())
+        dbgln("Failed to unmap IORing (@ {:p}): {}", m_ring, result.error());
+    (void)System::close(m_fd);
+}
+
+ErrorOr<void> IORing::enqueue(IORingSubmission const& submission)
+{
+    auto& ring_header = header();
+    auto tail = ring_header.submission_tail;
+    auto head = AK::atomic_load(&ring_header.submission_head, AK::memory_order_acquire);
+    if (tail - head >= m_submission_entries)
+        return Error::from_errno(EBUSY);
+
+    submissions()[tail & (m_submission_entries - 1)] = submission;
+    AK::atomic_store(&ring_header.submission_tail, tail + 1, AK::memory_order_release);
+    return {};
+}
+
+ErrorOr<void> IORing::submit_nop(u64 user_data)
+{
+    return enqueue({ .opcode = IORingOpcode::Nop, .flags = 0, .reserved = 0, .fd = -1, .offset = -1, .buffer = 0, .length = 0, .op_flags = 0, .user_data = user_data });
+}
+
+ErrorOr<void> IORing::submit_read(int fd, Bytes buffer, Optional<off_t> offset, u64 user_data)
+{
+    return enqueue({ .opcode = IORingOpcode::Read, .flags = 0, .reserved = 0, .fd = fd, .offset = offset.value_or(-1), .buffer = reinterpret_cast<FlatPtr>(buffer.data()), .length = static_cast<u32>(buffer.size()), .op_flags = 0, .user_data = user_data });
+}
+
+ErrorOr<void> IORing::submit_write(int fd, ReadonlyBytes buffer, Optional<off_t> offset, u64 user_data)
+{
+    return enqueue({ .opcode = IORingOpcode::Write, .flags = 0, .reserved = 0, .fd = fd, .offset = offset.value_or(-1), .buffer = reinterpret_cast<FlatPtr>(buffer.data()), .length = static_cast<u32>(buffer.size()), .op_flags = 0, .user_data = user_data });
+}
+
+ErrorOr<void> IORing::submit_poll(int fd, short events, u64 user_data)
+{
+    return enqueue({ .opcode = IORingOpcode::Poll, .flags = 0, .reserved = 0, .fd = fd, .offset = -1, .buffer = 0, .length = 0, .op_flags = static_cast<u16>(events), .user_data = user_data });
+}
+
+ErrorOr<void> IORing::submit_accept(int fd, int flags, u64 user_data)
+{
+    return enqueue({ .opcode = IORingOpcode::Accept, .flags = 0, .reserved = 0, .fd = fd, .offset = -1, .buffer = 0, .length = 0, .op_flags = static_cast<u32>(flags), .user_data = user_data });
+}
+
+ErrorOr<u32> IORing::submit()
+{
+    auto pending = pending_submissions();
+    if (pending == 0)
+        return 0;
+    return System::io_ring_enter(m_fd, pending);
+}
+
+u32 IORing::pending_submissions() const
+{
+    auto& ring_header = header();
+    return ring_header.submission_tail - AK::atomic_load(&ring_header.submission_head, AK::memory_order_acquire);
+}
+
+u32 IORing::available_completions() const
+{
+    auto& ring_header = header();
+    return AK::atomic_load(&ring_header.completion_tail, AK::memory_order_acquire) - ring_header.completion_head;
+}
+
+Optional<IORingCompletion> IORing::pop_completion()
+{
+    auto& ring_header = header();
+    auto head = ring_header.completion_head;
+    if (AK::atomic_load(&ring_header.completion_tail, AK::memory_order_acquire) == head)
+        return {};
+
+    auto completion = completions()[head & (m_completion_entries - 1)];
+    AK::atomic_store(&ring_header.completion_head, head + 1, AK::memory_order_release);
+    return completion;
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <Kernel/API/IORing.h>
+#include <sys/types.h>
+
+namespace Core {
+
+// A batched I/O interface backed by a submission/completion ring shared with the kernel.
+// Operations are queued with the submit_* functions, handed to the kernel all at once with
+// submit(), and their results are picked up with pop_completion().
+class IORing {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    static ErrorOr<NonnullOwnPtr<IORing>> create(u32 entries);
+    ~IORing();
+
+    u32 submission_entries() const { return m_submission_entries; }
+    u32 completion_entries() const { return m_completion_entries; }
+
+    // The submit_* functions fail with EBUSY if the submission ring is full.
+    // An empty offset means the current file offset of the descriptor is used and advanced.
+    ErrorOr<void> submit_nop(u64 user_data);
+    ErrorOr<void> submit_read(int fd, Bytes, Optional<off_t> offset, u64 user_data);
+    ErrorOr<void> submit_write(int fd, ReadonlyBytes, Optional<off_t> offset, u64 user_data);
+    ErrorOr<void> submit_poll(int fd, short events, u64 user_data);
+    ErrorOr<void> submit_accept(int fd, int flags, u64 user_data);
+
+    // Hands all queued submissions to the kernel and returns how many of them were consumed.
+    ErrorOr<u32> submit();
+
+    u32 pending_submissions() const;
+    u32 available_completions() const;
+    Optional<IORingCompletion> pop_completion();
+
+private:
+    IORing(int fd, u8* ring, size_t ring_size, u32 entries);
+
+    ErrorOr<void> enqueue(IORingSubmission const&);
+
+    IORingHeader& header() const { return *reinterpret_cast<IORingHeader*>(m_ring); }
+    IORingSubmission* submissions() const { return reinterpret_cast<IORingSubmission*>(m_ring + io_ring_submissions_offset()); }
+    IORingCompletion const* completions() const { return reinterpret_cast<IORingCompletion const*>(m_ring + io_ring_completions_offset(m_submission_entries)); }
+
+    int m_fd { -1 };
+    u8* m_ring { nullptr };
+    size_t m_ring_size { 0 };
+    u32 m_submission_entries { 0 };
+    u32 m_completion_entries { 0 };
+};
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/MemoryPressureNotifier.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if !defined(AK_OS_SERENITY)
+static_assert(false, "This file must only be used for SerenityOS");
+#endif
+
+namespace Core {
+
+ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> MemoryPressureNotifier::create()
+{
+    auto fd = TRY(System::open("/dev/memory_pressure"sv, O_RDONLY | O_NONBLOCK | O_CLOEXEC));
+    auto notifier = Notifier::construct(fd, Notifier::Type::Read);
+    auto memory_pressure_notifier = adopt_ref(*new MemoryPressureNotifier(fd, move(notifier)));
+
+    // The first read gives us the level as it is right now.
+    auto event = TRY(memory_pressure_notifier->read_event());
+    memory_pressure_notifier->m_level = event.level;
+    return memory_pressure_notifier;
+}
+
+MemoryPressureNotifier::MemoryPressureNotifier(int fd, NonnullRefPtr<Notifier> notifier)
+    : m_fd(fd)
+    , m_notifier(move(notifier))
+{
+    m_notifier->on_activation = [this] {
+        auto event_or_error = read_event();
+        if (event_or_error.is_error()) {
+            dbgln("MemoryPressureNotifier: Failed to read event: {}", event_or_error.error());
+            return;
+        }
+        auto level = event_or_error.value().level;
+        if (level == m_level)
+            return;
+        m_level = level;
+        if (on_pressure_change)
+            on_pressure_change(level);
+    };
+}
+
+MemoryPressureNotifier::~MemoryPressureNotifier()
+{
+    m_notifier->close();
+    (void)System::close(m_fd);
+}
+
+ErrorOr<MemoryPressureEvent> MemoryPressureNotifier::read_event()
+{
+    MemoryPressureEvent event {};
+    auto nread = TRY(System::read(m_fd, { &event, sizeof(event) }));
+    if (static_cast<size_t>(nread) != sizeof(event))
+        return Error::from_errno(EIO);
+    return event;
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <Kernel/API/MemoryPressure.h>
+#include <LibCore/Notifier.h>
+
+namespace Core {
+
+// Calls on_pressure_change from the event loop whenever the kernel's memory pressure level changes.
+// Processes with caches they can rebuild should use this to drop them before the system runs out of memory.
+class MemoryPressureNotifier final : public RefCounted<MemoryPressureNotifier> {
+    AK_MAKE_NONCOPYABLE(MemoryPressureNotifier);
+
+public:
+    static ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> create();
+    ~MemoryPressureNotifier();
+
+    MemoryPressureLevel level() const { return m_level; }
+
+    Function<void(MemoryPressureLevel)> on_pressure_change;
+
+private:
+    MemoryPressureNotifier(int fd, NonnullRefPtr<Notifier>);
+
+    ErrorOr<MemoryPressureEvent> read_event();
+
+    int m_fd { -1 };
+    NonnullRefPtr<Notifier> m_notifier;
+    MemoryPressureLevel m_level { MemoryPressureLevel::Normal };
+};
+
+}
@@ -336,6 +336,53 @@ ErrorOr<void> profiling_free_buffer(pid_t pid)
     int rc = ::profiling_free_buffer(pid);
     HANDLE_SYSCALL_RETURN_VALUE("profiling_free_buffer", rc, {});
 }
+
+ErrorOr<int> io_ring_create(u32 entries, int options)
+{
+    int fd = ::io_ring_create(entries, options);
+    if (fd < 0)
+        return Error::from_syscall("io_ring_create"sv, -errno);
+    return fd;
+}
+
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit)
+{
+    int rc = ::io_ring_enter(fd, to_submit);
+    if (rc < 0)
+        return Error::from_syscall("io_ring_enter"sv, -errno);
+    return static_cast<u32>(rc);
+}
+
+ErrorOr<int> readiness_queue_create(int options)
+{
+    int fd = ::readiness_queue_create(options);
+    if (fd < 0)
+        return Error::from_syscall("readiness_queue_create"sv, -errno);
+    return fd;
+}
+
+ErrorOr<void> readiness_queue_ctl(int queue_fd, int operation, int fd, ReadinessEvent const* event)
+{
+    if (::readiness_queue_ctl(queue_fd, operation, fd, event) < 0)
+        return Error::from_syscall("readiness_queue_ctl"sv, -errno);
+    return {};
+}
+
+ErrorOr<size_t> readiness_queue_wait(int queue_fd, Span<ReadinessEvent> events, struct timespec const* timeout)
+{
+    int rc = ::readiness_queue_wait(queue_fd, events.data(), static_cast<int>(events.size()), timeout);
+    if (rc < 0)
+        return Error::from_syscall("readiness_queue_wait"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    auto rc = ::sendfile(out_fd, in_fd, offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return static_cast<size_t>(rc);
+}
 #endif
 
 #if !defined(AK_OS_BSD_GENERIC) && !defined(AK_OS_ANDROID)
@@ -33,6 +33,7 @@
 
 #ifdef AK_OS_SERENITY
 #    include <Kernel/API/Jail.h>
+#    include <Kernel/API/ReadinessQueue.h>
 #endif
 
 #if !defined(AK_OS_BSD_GENERIC) && !defined(AK_OS_ANDROID)
@@ -69,6 +70,12 @@ ErrorOr<void> disown(pid_t pid);
 ErrorOr<void> profiling_enable(pid_t, u64 event_mask);
 ErrorOr<void> profiling_disable(pid_t);
 ErrorOr<void> profiling_free_buffer(pid_t);
+ErrorOr<int> io_ring_create(u32 entries, int options);
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit);
+ErrorOr<int> readiness_queue_create(int options);
+ErrorOr<void> readiness_queue_ctl(int queue_fd, int operation, int fd, ReadinessEvent const*);
+ErrorOr<size_t> readiness_queue_wait(int queue_fd, Span<ReadinessEvent> events, struct timespec const* timeout);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
 #else
 inline ErrorOr<void> unveil(StringView, StringView)
 {
@@ -14,6 +14,7 @@
 #include <AK/LexicalPath.h>
 #include <AK/Platform.h>
 #include <AK/ScopeGuard.h>
+#include <AK/Time.h>
 #include <AK/Vector.h>
 #include <Kernel/API/VirtualMemoryAnnotations.h>
 #include <Kernel/API/prctl_numbers.h>
@@ -21,6 +22,7 @@
 #include <LibELF/DynamicLinker.h>
 #include <LibELF/DynamicLoader.h>
 #include <LibELF/DynamicObject.h>
+#include <LibELF/DynamicRelocationCache.h>
 #include <LibELF/Hashes.h>
 #include <bits/dlfcn_integration.h>
 #include <bits/pthread_integration.h>
@@ -57,7 +59,10 @@ static DeprecatedString s_cwd;
 
 static bool s_allowed_to_check_environment_variables { false };
 static bool s_do_breakpoint_trap_before_entry { false };
+static bool s_bind_now { false };
+static bool s_show_relocation_time { false };
 static StringView s_ld_library_path;
+static StringView s_relocation_cache_directory;
 static StringView s_main_program_pledge_promises;
 static DeprecatedString s_loader_pledge_promises;
 
@@ -66,12 +71,34 @@ static Result<void*, DlErrorMessage> __dlopen(char const* filename, int flags);
 static Result<void*, DlErrorMessage> __dlsym(void* handle, char const* symbol_name);
 static Result<void, DlErrorMessage> __dladdr(void const* addr, Dl_info* info);
 
-Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(StringView name)
+// While linking, the same symbols get looked up over and over again, as every library that calls e.g. malloc()
+// or uses a vtable from LibCore needs a relocation for it. Since the set of global objects doesn't change until
+// we are done linking, we remember the results of those lookups, keyed by the GNU hash of the symbol name.
+// NOTE: The names are owned by the string tables of the objects being linked, which stay mapped for as long as
+//       we are linking them. The cache is dropped once we are done.
+struct SymbolLookupCacheKey {
+    StringView name;
+    u32 hash { 0 };
+};
+
+struct SymbolLookupCacheKeyTraits : public GenericTraits<SymbolLookupCacheKey> {
+    static unsigned hash(SymbolLookupCacheKey const& key) { return key.hash; }
+    static bool equals(SymbolLookupCacheKey const& a, SymbolLookupCacheKey const& b) { return a.hash == b.hash && a.name == b.name; }
+};
+
+static HashMap<SymbolLookupCacheKey, Optional<DynamicObject::SymbolLookupResult>, SymbolLookupCacheKeyTraits> s_symbol_lookup_cache;
+static bool s_symbol_lookup_cache_enabled { false };
+static size_t s_symbol_lookup_count { 0 };
+static size_t s_symbol_lookup_cache_hit_count { 0 };
+
+// The results of the lookups made by the previous runs of this program, see DynamicRelocationCache.
+// This is only set up while linking the main program.
+static Optional<DynamicRelocationCache> s_relocation_cache;
+
+static Optional<DynamicObject::SymbolLookupResult> find_global_symbol(DynamicObject::HashSymbol const& symbol)
 {
     Optional<DynamicObject::SymbolLookupResult> weak_result;
 
-    auto symbol = DynamicObject::HashSymbol { name };
-
     for (auto& lib : s_global_objects) {
         auto res = lib.value->lookup_symbol(symbol);
         if (!res.has_value())
@@ -85,6 +112,38 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return weak_result;
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(StringView name)
+{
+    return find_global_symbol(DynamicObject::HashSymbol { name });
+}
+
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol_while_linking(DynamicObject::Symbol const& symbol)
+{
+    auto name = symbol.name();
+    auto hash_symbol = DynamicObject::HashSymbol { name };
+    if (!s_symbol_lookup_cache_enabled)
+        return find_global_symbol(hash_symbol);
+
+    ++s_symbol_lookup_count;
+
+    Optional<DynamicObject::SymbolLookupResult> result;
+    if (s_relocation_cache.has_value() && s_relocation_cache->lookup(symbol, result))
+        return result;
+
+    SymbolLookupCacheKey key { name, hash_symbol.gnu_hash() };
+    if (auto it = s_symbol_lookup_cache.find(key); it != s_symbol_lookup_cache.end()) {
+        ++s_symbol_lookup_cache_hit_count;
+        result = it->value;
+    } else {
+        result = find_global_symbol(hash_symbol);
+        s_symbol_lookup_cache.set(key, result);
+    }
+
+    if (s_relocation_cache.has_value())
+        s_relocation_cache->record(symbol, result);
+    return result;
+}
+
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(DeprecatedString const& filepath, int fd)
 {
     VERIFY(filepath.starts_with('/'));
@@ -390,15 +449,57 @@ static Result<void, DlErrorMessage> link_main_library(DeprecatedString const& pa
             s_global_objects.set(dynamic_object->filepath(), *dynamic_object);
     }
 
-    for (auto& loader : loaders) {
-        bool success = loader->link(flags);
+    auto drop_symbol_lookup_cache = [] {
+        s_symbol_lookup_cache_enabled = false;
+        s_symbol_lookup_cache.clear();
+        s_relocation_cache.clear();
+    };
+    s_symbol_lookup_cache_enabled = true;
+    ScopeGuard symbol_lookup_cache_guard = drop_symbol_lookup_cache;
+
+    struct RelocationStatistics {
+        Duration time;
+        size_t symbol_lookups { 0 };
+        size_t symbol_lookup_cache_hits { 0 };
+        size_t relocation_cache_hits { 0 };
+    };
+    Vector<RelocationStatistics> relocation_statistics;
+    if (s_show_relocation_time)
+        relocation_statistics.resize(loaders.size());
+
+    auto relocation_cache_hit_count = [] {
+        return s_relocation_cache.has_value() ? s_relocation_cache->hit_count() : 0;
+    };
+
+    auto measure_relocation = [&](size_t loader_index, auto callback) {
+        if (!s_show_relocation_time)
+            return callback();
+
+        auto start_time = MonotonicTime::now();
+        auto symbol_lookups_before = s_symbol_lookup_count;
+        auto symbol_lookup_cache_hits_before = s_symbol_lookup_cache_hit_count;
+        auto relocation_cache_hits_before = relocation_cache_hit_count();
+        auto result = callback();
+
+        auto& statistics = relocation_statistics[loader_index];
+        statistics.time += MonotonicTime::now() - start_time;
+        statistics.symbol_lookups += s_symbol_lookup_count - symbol_lookups_before;
+        statistics.symbol_lookup_cache_hits += s_symbol_lookup_cache_hit_count - symbol_lookup_cache_hits_before;
+        statistics.relocation_cache_hits += relocation_cache_hit_count() - relocation_cache_hits_before;
+        return result;
+    };
+
+    for (size_t i = 0; i < loaders.size(); ++i) {
+        auto& loader = loaders[i];
+        bool success = measure_relocation(i, [&] { return loader->link(flags); });
         if (!success) {
             return DlErrorMessage { DeprecatedString::formatted("Failed to link library {}", loader->filepath()) };
         }
     }
 
-    for (auto& loader : loaders) {
-        auto result = loader->load_stage_3(flags);
+    for (size_t i = 0; i < loaders.size(); ++i) {
+        auto& loader = loaders[i];
+        auto result = measure_relocation(i, [&] { return loader->load_stage_3(); });
         VERIFY(!result.is_error());
         auto& object = result.value();
 
@@ -424,6 +525,22 @@ static Result<void, DlErrorMessage> link_main_library(DeprecatedString const& pa
         }
     }
 
+    if (s_show_relocation_time) {
+        Duration total_time;
+        for (size_t i = 0; i < loaders.size(); ++i) {
+            auto const& statistics = relocation_statistics[i];
+            warnln("Loader.so: Relocated {} in {}us ({} symbol lookups, {} cached, {} from the relocation cache)", loaders[i]->filepath(), statistics.time.to_microseconds(), statistics.symbol_lookups, statistics.symbol_lookup_cache_hits, statistics.relocation_cache_hits);
+            total_time += statistics.time;
+        }
+        warnln("Loader.so: Relocated {} objects in {}us", loaders.size(), total_time.to_microseconds());
+    }
+
+    if (s_relocation_cache.has_value())
+        s_relocation_cache->save();
+
+    // NOTE: Initializers may dlopen() more libraries, which would make the cached results of our lookups stale.
+    drop_symbol_lookup_cache();
+
     drop_loader_promise("prot_exec"sv);
 
     for (auto& loader : loaders) {
@@ -602,11 +719,26 @@ static void read_environment_variables()
             s_do_breakpoint_trap_before_entry = true;
         }
 
+        if (env_string == "_LOADER_SHOW_RELOCATION_TIME=1"sv) {
+            s_show_relocation_time = true;
+        }
+
+        // Like on other systems, setting LD_BIND_NOW to anything resolves all PLT entries up front instead of on first use.
+        constexpr auto bind_now_string = "LD_BIND_NOW="sv;
+        if (env_string.starts_with(bind_now_string) && env_string.length() > bind_now_string.length()) {
+            s_bind_now = true;
+        }
+
         constexpr auto library_path_string = "LD_LIBRARY_PATH="sv;
         if (env_string.starts_with(library_path_string)) {
             s_ld_library_path = env_string.substring_view(library_path_string.length());
         }
 
+        constexpr auto relocation_cache_string = "_LOADER_RELOCATION_CACHE="sv;
+        if (env_string.starts_with(relocation_cache_string)) {
+            s_relocation_cache_directory = env_string.substring_view(relocation_cache_string.length());
+        }
+
         constexpr auto main_pledge_promises_key = "_LOADER_MAIN_PROGRAM_PLEDGE_PROMISES="sv;
         if (env_string.starts_with(main_pledge_promises_key)) {
             s_main_program_pledge_promises = env_string.substring_view(main_pledge_promises_key.length());
@@ -619,6 +751,24 @@ static void read_environment_variables()
     }
 }
 
+static void open_relocation_cache()
+{
+    if (s_relocation_cache_directory.is_empty())
+        return;
+
+    // The loader isn't allowed to touch any files once the program is pledged, and trying to do so would kill it.
+    if (!s_main_program_pledge_promises.is_empty())
+        return;
+
+    Vector<DynamicRelocationCache::LoadedObject> objects;
+    for (auto const& it : s_global_objects) {
+        auto loader = s_loaders.get(it.key);
+        VERIFY(loader.has_value());
+        objects.append({ it.value.ptr(), loader.value()->identity() });
+    }
+    s_relocation_cache = DynamicRelocationCache::open(s_relocation_cache_directory, s_main_program_path, move(objects));
+}
+
 void ELF::DynamicLinker::linker_main(DeprecatedString&& main_program_path, int main_program_fd, bool is_secure, int argc, char** argv, char** envp)
 {
     VERIFY(main_program_path.starts_with('/'));
@@ -659,8 +809,10 @@ void ELF::DynamicLinker::linker_main(DeprecatedString&& main_program_path, int m
 
     allocate_tls();
 
+    open_relocation_cache();
+
     auto entry_point_function = [&main_program_path] {
-        auto result = link_main_library(main_program_path, RTLD_GLOBAL | RTLD_LAZY);
+        auto result = link_main_library(main_program_path, RTLD_GLOBAL | (s_bind_now ? RTLD_NOW : RTLD_LAZY));
         if (result.is_error()) {
             warnln("{}", result.error().text);
             _exit(1);
@@ -15,6 +15,10 @@ namespace ELF {
 class DynamicLinker {
 public:
     static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol(StringView symbol);
+    // Like lookup_global_symbol() for the name of the given symbol, but remembers the result until we are done linking the current set
+    // of libraries. When linking the main program, this can also take the result from the DynamicRelocationCache.
+    // NOTE: This must only be called while linking, and only from the thread that is doing it.
+    static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol_while_linking(DynamicObject::Symbol const& symbol);
     [[noreturn]] static void linker_main(DeprecatedString&& main_program_path, int fd, bool is_secure, int argc, char** argv, char** envp);
 
     static Optional<DeprecatedString> resolve_library(DeprecatedString const& name, DynamicObject const& parent_object);
@@ -60,6 +60,15 @@ Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> DynamicLoader::try_create(i
     auto loader = adopt_ref(*new DynamicLoader(fd, move(filepath), data, size));
     if (!loader->is_valid())
         return DlErrorMessage { "ELF image validation failed" };
+
+    if (auto build_id = loader->find_build_id(); build_id.has_value()) {
+        loader->m_identity = build_id.release_value();
+    } else {
+        // Without a build ID, the best we can do is to assume that the file didn't change if it wasn't touched.
+        u64 file_identity[] = { static_cast<u64>(stat.st_dev), static_cast<u64>(stat.st_ino), static_cast<u64>(stat.st_size), static_cast<u64>(stat.st_mtime) };
+        static_assert(sizeof(file_identity) == sizeof(loader->m_identity));
+        memcpy(loader->m_identity.data(), file_identity, sizeof(file_identity));
+    }
     return loader;
 }
 
@@ -106,6 +115,39 @@ DynamicObject const& DynamicLoader::dynamic_object() const
     return *m_cached_dynamic_object;
 }
 
+Optional<DynamicObjectIdentity> DynamicLoader::find_build_id() const
+{
+    Optional<DynamicObjectIdentity> build_id;
+    image().for_each_program_header([&](auto program_header) {
+        if (program_header.type() != PT_NOTE)
+            return IterationDecision::Continue;
+
+        // NOTE: The validation made sure that the notes are within the file.
+        ReadonlyBytes notes { program_header.raw_data(), program_header.size_in_image() };
+        while (notes.size() >= sizeof(ElfW(Nhdr))) {
+            ElfW(Nhdr) note;
+            memcpy(&note, notes.data(), sizeof(note));
+            if (note.n_namesz > notes.size() || note.n_descsz > notes.size())
+                break;
+            size_t name_offset = sizeof(note);
+            size_t description_offset = name_offset + align_up_to(static_cast<size_t>(note.n_namesz), 4);
+            size_t next_note_offset = description_offset + align_up_to(static_cast<size_t>(note.n_descsz), 4);
+            if (next_note_offset > notes.size())
+                break;
+
+            if (note.n_type == NT_GNU_BUILD_ID && StringView { notes.slice(name_offset, note.n_namesz) } == "GNU\0"sv) {
+                DynamicObjectIdentity identity {};
+                notes.slice(description_offset, note.n_descsz).copy_trimmed_to(identity.span());
+                build_id = identity;
+                return IterationDecision::Break;
+            }
+            notes = notes.slice(next_note_offset);
+        }
+        return IterationDecision::Continue;
+    });
+    return build_id;
+}
+
 void DynamicLoader::find_tls_size_and_alignment()
 {
     image().for_each_program_header([this](auto program_header) {
@@ -194,11 +236,11 @@ bool DynamicLoader::load_stage_2(unsigned flags)
             }
         }
     }
-    do_main_relocations();
+    do_main_relocations(flags);
     return true;
 }
 
-void DynamicLoader::do_main_relocations()
+void DynamicLoader::do_main_relocations(unsigned flags)
 {
     do_relr_relocations();
 
@@ -225,15 +267,14 @@ void DynamicLoader::do_main_relocations()
             *((FlatPtr*)relocation.address().as_ptr()) += m_dynamic_object->base_address().get();
     };
 
-    // FIXME: Or LD_BIND_NOW is set?
-    if (m_dynamic_object->must_bind_now()) {
+    if (m_dynamic_object->must_bind_now() || (flags & RTLD_NOW)) {
         m_dynamic_object->plt_relocation_section().for_each_relocation([&](DynamicObject::Relocation const& relocation) {
             if (relocation.type() == R_X86_64_IRELATIVE || relocation.type() == R_AARCH64_IRELATIVE) {
                 m_direct_ifunc_relocations.append(relocation);
                 return;
             }
 
-            switch (do_plt_relocation(relocation, ShouldCallIfuncResolver::No)) {
+            switch (do_plt_relocation(relocation, ShouldCallIfuncResolver::No, ShouldUseSymbolLookupCache::Yes)) {
             case RelocationResult::Failed:
                 dbgln("Loader.so: {} unresolved symbol '{}'", m_filepath, relocation.symbol().name());
                 VERIFY_NOT_REACHED();
@@ -259,18 +300,18 @@ void DynamicLoader::do_main_relocations()
     }
 }
 
-Result<NonnullRefPtr<DynamicObject>, DlErrorMessage> DynamicLoader::load_stage_3(unsigned flags)
+Result<NonnullRefPtr<DynamicObject>, DlErrorMessage> DynamicLoader::load_stage_3()
 {
     do_lazy_relocations();
-    if (flags & RTLD_LAZY) {
-        if (m_dynamic_object->has_plt())
-            setup_plt_trampoline();
-    }
+
+    // NOTE: Even if all PLT entries were bound in stage 2, the ones for IFUNCs are still lazy at this point.
+    if (m_dynamic_object->has_plt())
+        setup_plt_trampoline();
 
     // IFUNC resolvers can only be called after the PLT has been populated,
     // as they may call arbitrary functions via the PLT.
     for (auto const& relocation : m_plt_ifunc_relocations) {
-        auto result = do_plt_relocation(relocation, ShouldCallIfuncResolver::Yes);
+        auto result = do_plt_relocation(relocation, ShouldCallIfuncResolver::Yes, ShouldUseSymbolLookupCache::Yes);
         VERIFY(result == RelocationResult::Success);
     }
 
@@ -536,7 +577,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_direct_relocation(DynamicObjec
     case R_AARCH64_ABS64:
     case R_X86_64_64: {
         auto symbol = relocation.symbol();
-        auto res = lookup_symbol(symbol);
+        auto res = lookup_symbol(symbol, ShouldUseSymbolLookupCache::Yes);
         if (!res.has_value()) {
             if (symbol.bind() == STB_WEAK)
                 return RelocationResult::ResolveLater;
@@ -558,7 +599,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_direct_relocation(DynamicObjec
     case R_AARCH64_GLOB_DAT:
     case R_X86_64_GLOB_DAT: {
         auto symbol = relocation.symbol();
-        auto res = lookup_symbol(symbol);
+        auto res = lookup_symbol(symbol, ShouldUseSymbolLookupCache::Yes);
         VirtualAddress symbol_location;
         if (!res.has_value()) {
             if (symbol.bind() == STB_WEAK) {
@@ -605,7 +646,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_direct_relocation(DynamicObjec
         FlatPtr symbol_value;
         DynamicObject const* dynamic_object_of_symbol;
         if (relocation.symbol_index() != 0) {
-            auto res = lookup_symbol(symbol);
+            auto res = lookup_symbol(symbol, ShouldUseSymbolLookupCache::Yes);
             if (!res.has_value())
                 break;
             VERIFY(symbol.type() != STT_GNU_IFUNC);
@@ -654,14 +695,14 @@ DynamicLoader::RelocationResult DynamicLoader::do_direct_relocation(DynamicObjec
     return RelocationResult::Success;
 }
 
-DynamicLoader::RelocationResult DynamicLoader::do_plt_relocation(DynamicObject::Relocation const& relocation, ShouldCallIfuncResolver should_call_ifunc_resolver)
+DynamicLoader::RelocationResult DynamicLoader::do_plt_relocation(DynamicObject::Relocation const& relocation, ShouldCallIfuncResolver should_call_ifunc_resolver, ShouldUseSymbolLookupCache should_use_symbol_lookup_cache)
 {
     VERIFY(relocation.type() == R_X86_64_JUMP_SLOT || relocation.type() == R_AARCH64_JUMP_SLOT);
     auto symbol = relocation.symbol();
     auto* relocation_address = (FlatPtr*)relocation.address().as_ptr();
 
     VirtualAddress symbol_location {};
-    if (auto result = lookup_symbol(symbol); result.has_value()) {
+    if (auto result = lookup_symbol(symbol, should_use_symbol_lookup_cache); result.has_value()) {
         auto address = result.value().address;
 
         if (result.value().type == STT_GNU_IFUNC) {
@@ -730,7 +771,8 @@ void DynamicLoader::setup_plt_trampoline()
 extern "C" FlatPtr _fixup_plt_entry(DynamicObject* object, u32 relocation_offset)
 {
     auto const& relocation = object->plt_relocation_section().relocation_at_offset(relocation_offset);
-    auto result = DynamicLoader::do_plt_relocation(relocation, ShouldCallIfuncResolver::Yes);
+    // NOTE: This can happen on any thread at any time, so we can't use the symbol lookup cache of the linker here.
+    auto result = DynamicLoader::do_plt_relocation(relocation, ShouldCallIfuncResolver::Yes, ShouldUseSymbolLookupCache::No);
     if (result != DynamicLoader::RelocationResult::Success) {
         dbgln("Loader.so: {} unresolved symbol '{}'", object->filepath(), relocation.symbol().name());
         VERIFY_NOT_REACHED();
@@ -763,12 +805,15 @@ void DynamicLoader::call_object_init_functions()
     }
 }
 
-Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const ELF::DynamicObject::Symbol& symbol)
+Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const ELF::DynamicObject::Symbol& symbol, ShouldUseSymbolLookupCache should_use_symbol_lookup_cache)
 {
-    if (symbol.is_undefined() || symbol.bind() == STB_WEAK)
+    if (symbol.is_undefined() || symbol.bind() == STB_WEAK) {
+        if (should_use_symbol_lookup_cache == ShouldUseSymbolLookupCache::Yes)
+            return DynamicLinker::lookup_global_symbol_while_linking(symbol);
         return DynamicLinker::lookup_global_symbol(symbol.name());
+    }
 
-    return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), symbol.type(), &symbol.object() };
+    return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), symbol.type(), &symbol.object(), symbol.index() };
 }
 
 } // end namespace ELF
@@ -12,6 +12,7 @@
 #include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <LibELF/DynamicObject.h>
+#include <LibELF/DynamicRelocationCache.h>
 #include <LibELF/ELFABI.h>
 #include <LibELF/Image.h>
 #include <bits/dlfcn_integration.h>
@@ -45,6 +46,11 @@ enum class ShouldCallIfuncResolver {
     No
 };
 
+enum class ShouldUseSymbolLookupCache {
+    Yes,
+    No
+};
+
 extern "C" FlatPtr _fixup_plt_entry(DynamicObject* object, u32 relocation_offset);
 
 class DynamicLoader : public RefCounted<DynamicLoader> {
@@ -67,7 +73,7 @@ public:
     bool load_stage_2(unsigned flags);
 
     // Stage 3 of loading: lazy relocations
-    Result<NonnullRefPtr<DynamicObject>, DlErrorMessage> load_stage_3(unsigned flags);
+    Result<NonnullRefPtr<DynamicObject>, DlErrorMessage> load_stage_3();
 
     // Stage 4 of loading: initializers
     void load_stage_4();
@@ -85,11 +91,14 @@ public:
     Vector<LoadedSegment> const text_segments() const { return m_text_segments; }
     bool is_dynamic() const { return image().is_dynamic(); }
 
-    static Optional<DynamicObject::SymbolLookupResult> lookup_symbol(const ELF::DynamicObject::Symbol&);
+    static Optional<DynamicObject::SymbolLookupResult> lookup_symbol(const ELF::DynamicObject::Symbol&, ShouldUseSymbolLookupCache);
     void copy_initial_tls_data_into(ByteBuffer& buffer) const;
 
     DynamicObject const& dynamic_object() const;
 
+    // Tells whether the object we loaded is the exact same one as the last time we saw it, see DynamicRelocationCache.
+    DynamicObjectIdentity const& identity() const { return m_identity; }
+
     bool is_fully_relocated() const { return m_fully_relocated; }
     bool is_fully_initialized() const { return m_fully_initialized; }
 
@@ -124,7 +133,7 @@ private:
     void load_program_headers();
 
     // Stage 2
-    void do_main_relocations();
+    void do_main_relocations(unsigned flags);
 
     // Stage 3
     void do_lazy_relocations();
@@ -134,6 +143,7 @@ private:
     void call_object_init_functions();
 
     bool validate();
+    Optional<DynamicObjectIdentity> find_build_id() const;
 
     friend FlatPtr _fixup_plt_entry(DynamicObject*, u32);
 
@@ -145,7 +155,7 @@ private:
     };
     RelocationResult do_direct_relocation(DynamicObject::Relocation const&, ShouldInitializeWeak, ShouldCallIfuncResolver);
     // Will be called from _fixup_plt_entry, as part of the PLT trampoline
-    static RelocationResult do_plt_relocation(DynamicObject::Relocation const&, ShouldCallIfuncResolver);
+    static RelocationResult do_plt_relocation(DynamicObject::Relocation const&, ShouldCallIfuncResolver, ShouldUseSymbolLookupCache);
     void do_relr_relocations();
     void find_tls_size_and_alignment();
 
@@ -155,6 +165,7 @@ private:
     void* m_file_data { nullptr };
     OwnPtr<ELF::Image> m_elf_image;
     bool m_valid { true };
+    DynamicObjectIdentity m_identity {};
 
     RefPtr<DynamicObject> m_dynamic_object;
 
@@ -62,6 +62,28 @@ void DynamicObject::dump() const
     }
 }
 
+// The GNU hash table doesn't store the number of symbols, but the hashed symbols come last in the symbol table,
+// sorted by bucket. So the chain of the last non-empty bucket ends with the last symbol.
+static unsigned gnu_hash_symbol_count(u32 const* hash_table_begin)
+{
+    const size_t num_buckets = hash_table_begin[0];
+    const size_t num_omitted_symbols = hash_table_begin[1];
+    const u32 num_maskwords = hash_table_begin[2];
+
+    u32 const* const buckets = (u32 const*)&((FlatPtr const*)&hash_table_begin[4])[num_maskwords];
+    u32 const* const chains = &buckets[num_buckets];
+
+    size_t last_symbol = 0;
+    for (size_t i = 0; i < num_buckets; ++i)
+        last_symbol = max<size_t>(last_symbol, buckets[i]);
+    if (last_symbol < num_omitted_symbols)
+        return num_omitted_symbols;
+
+    while ((chains[last_symbol - num_omitted_symbols] & 1) == 0)
+        ++last_symbol;
+    return last_symbol + 1;
+}
+
 void DynamicObject::parse()
 {
     for_each_dynamic_entry([&](DynamicEntry const& entry) {
@@ -191,8 +213,12 @@ void DynamicObject::parse()
 
     auto hash_section_address = hash_section().address().as_ptr();
     // TODO: consider base address - it might not be zero
-    auto num_hash_chains = ((u32*)hash_section_address)[1];
-    m_symbol_count = num_hash_chains;
+    if (m_hash_type == HashType::SYSV) {
+        auto num_hash_chains = ((u32*)hash_section_address)[1];
+        m_symbol_count = num_hash_chains;
+    } else {
+        m_symbol_count = gnu_hash_symbol_count((u32 const*)hash_section_address);
+    }
 }
 
 DynamicObject::Relocation DynamicObject::RelocationSection::relocation(unsigned index) const
@@ -472,7 +498,7 @@ auto DynamicObject::lookup_symbol(HashSymbol const& symbol) const -> Optional<Sy
     auto symbol_result = result.value();
     if (symbol_result.is_undefined())
         return {};
-    return SymbolLookupResult { symbol_result.value(), symbol_result.size(), symbol_result.address(), symbol_result.bind(), symbol_result.type(), this };
+    return SymbolLookupResult { symbol_result.value(), symbol_result.size(), symbol_result.address(), symbol_result.bind(), symbol_result.type(), this, symbol_result.index() };
 }
 
 NonnullRefPtr<DynamicObject> DynamicObject::create(DeprecatedString const& filepath, VirtualAddress base_address, VirtualAddress dynamic_section_address)
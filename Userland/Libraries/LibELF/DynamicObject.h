@@ -309,6 +309,7 @@ public:
         unsigned bind { STB_LOCAL };
         unsigned type { STT_FUNC };
         const ELF::DynamicObject* dynamic_object { nullptr }; // The object in which the symbol is defined
+        unsigned symbol_index { 0 };                           // The index of the symbol in that object
     };
 
     Optional<SymbolLookupResult> lookup_symbol(StringView name) const;
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/LexicalPath.h>
+#include <AK/MemoryStream.h>
+#include <AK/ScopeGuard.h>
+#include <AK/StringHash.h>
+#include <LibELF/DynamicRelocationCache.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ELF {
+
+// The cache file starts with a FileHeader, followed by a FileObject and the path of each object,
+// and finally all the known resolutions as FileResolutions.
+static constexpr u32 file_magic = 0x454c5243; // "CRLE"
+static constexpr u32 file_version = 1;
+static constexpr size_t max_file_size = 16 * MiB;
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+    u32 object_count;
+    u32 resolution_count;
+};
+
+struct FileObject {
+    DynamicObjectIdentity identity;
+    u32 path_length;
+};
+
+struct FileResolution {
+    u32 object;
+    u32 symbol_index;
+    u32 defining_object;
+    u32 defining_symbol_index;
+};
+
+DynamicRelocationCache DynamicRelocationCache::open(StringView directory, StringView program_path, Vector<LoadedObject> objects)
+{
+    // Programs with the same name may live in different directories, so we tell their caches apart by a hash of the path.
+    auto path_hash = string_hash(program_path.characters_without_null_termination(), program_path.length());
+    auto path = DeprecatedString::formatted("{}/{}-{:08x}", directory, LexicalPath::basename(program_path), path_hash);
+
+    DynamicRelocationCache cache(move(path), move(objects));
+    if (auto result = cache.load(); result.is_error()) {
+        dbgln_if(DYNAMIC_LOAD_DEBUG, "Not using relocation cache {}: {}", cache.m_path, result.error());
+        for (auto& resolutions : cache.m_resolutions)
+            resolutions.clear();
+    }
+    return cache;
+}
+
+DynamicRelocationCache::DynamicRelocationCache(DeprecatedString path, Vector<LoadedObject> objects)
+    : m_path(move(path))
+    , m_objects(move(objects))
+{
+    for (size_t i = 0; i < m_objects.size(); ++i)
+        m_object_indices.set(m_objects[i].object, i);
+    m_resolutions.resize(m_objects.size());
+}
+
+ErrorOr<void> DynamicRelocationCache::load()
+{
+    int fd = ::open(m_path.characters(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return Error::from_errno(errno);
+    ScopeGuard close_fd = [fd] { close(fd); };
+
+    struct stat stat;
+    if (fstat(fd, &stat) < 0)
+        return Error::from_errno(errno);
+    // Whoever can write the cache decides which definitions our symbols resolve to, so it has to be ours alone.
+    if (!S_ISREG(stat.st_mode) || stat.st_uid != geteuid() || (stat.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+        return Error::from_string_literal("Cache file is not exclusively owned by us");
+    if (stat.st_size < 0 || static_cast<size_t>(stat.st_size) > max_file_size)
+        return Error::from_string_literal("Cache file is too large");
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(stat.st_size));
+    size_t nread = 0;
+    while (nread < buffer.size()) {
+        auto rc = read(fd, buffer.offset_pointer(nread), buffer.size() - nread);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return Error::from_errno(errno);
+        }
+        if (rc == 0)
+            return Error::from_string_literal("Cache file was truncated while reading it");
+        nread += rc;
+    }
+
+    FixedMemoryStream stream { buffer.bytes() };
+
+    FileHeader header;
+    TRY(stream.read_until_filled({ &header, sizeof(header) }));
+    if (header.magic != file_magic || header.version != file_version)
+        return Error::from_string_literal("Cache file has an unknown format");
+
+    // The cache is only valid for the exact same objects, loaded in the same order.
+    if (header.object_count != m_objects.size())
+        return Error::from_string_literal("Cache file is for a different set of objects");
+    for (auto const& object : m_objects) {
+        FileObject file_object;
+        TRY(stream.read_until_filled({ &file_object, sizeof(file_object) }));
+        auto const& path = object.object->filepath();
+        if (file_object.identity != object.identity || file_object.path_length != path.length() || file_object.path_length > stream.remaining())
+            return Error::from_string_literal("Cache file is for a different set of objects");
+        if (path.view() != StringView { stream.bytes().slice(stream.offset(), file_object.path_length) })
+            return Error::from_string_literal("Cache file is for a different set of objects");
+        TRY(stream.discard(file_object.path_length));
+    }
+
+    if (header.resolution_count != stream.remaining() / sizeof(FileResolution) || stream.remaining() % sizeof(FileResolution) != 0)
+        return Error::from_string_literal("Cache file has an unexpected size");
+
+    for (u32 i = 0; i < header.resolution_count; ++i) {
+        FileResolution file_resolution;
+        TRY(stream.read_until_filled({ &file_resolution, sizeof(file_resolution) }));
+
+        if (file_resolution.object >= m_objects.size())
+            return Error::from_string_literal("Cache file refers to an object that doesn't exist");
+        if (file_resolution.defining_object == 0 || (file_resolution.defining_object > m_objects.size() && file_resolution.defining_object != not_found))
+            return Error::from_string_literal("Cache file refers to an object that doesn't exist");
+        if (file_resolution.symbol_index >= m_objects[file_resolution.object].object->symbol_count())
+            return Error::from_string_literal("Cache file refers to a symbol that doesn't exist");
+
+        // NOTE: The defining symbol is only checked once we look it up, as most of the resolutions in here are never used
+        //       by a program that binds lazily.
+        auto& resolutions = m_resolutions[file_resolution.object];
+        if (file_resolution.symbol_index >= resolutions.size())
+            resolutions.resize(file_resolution.symbol_index + 1);
+        resolutions[file_resolution.symbol_index] = { file_resolution.defining_object, file_resolution.defining_symbol_index };
+    }
+
+    return {};
+}
+
+bool DynamicRelocationCache::lookup(DynamicObject::Symbol const& symbol, Optional<DynamicObject::SymbolLookupResult>& result)
+{
+    auto object_index = m_object_indices.get(&symbol.object());
+    if (!object_index.has_value())
+        return false;
+
+    auto const& resolutions = m_resolutions[object_index.value()];
+    if (symbol.index() >= resolutions.size())
+        return false;
+
+    auto resolution = resolutions[symbol.index()];
+    if (resolution.defining_object == 0)
+        return false;
+
+    if (resolution.defining_object == not_found) {
+        result = {};
+        ++m_hit_count;
+        return true;
+    }
+
+    auto const& defining_object = *m_objects[resolution.defining_object - 1].object;
+    if (resolution.symbol_index >= defining_object.symbol_count())
+        return false;
+
+    // This can only fail if one of the objects changed without us noticing. In that case, we fall back to a regular lookup,
+    // which then replaces the stale resolution.
+    auto definition = defining_object.symbol(resolution.symbol_index);
+    if (definition.is_undefined() || definition.bind() == STB_LOCAL || definition.name() != symbol.name())
+        return false;
+
+    result = DynamicObject::SymbolLookupResult { definition.value(), definition.size(), definition.address(), definition.bind(), definition.type(), &defining_object, definition.index() };
+    ++m_hit_count;
+    return true;
+}
+
+void DynamicRelocationCache::record(DynamicObject::Symbol const& symbol, Optional<DynamicObject::SymbolLookupResult> const& result)
+{
+    auto object_index = m_object_indices.get(&symbol.object());
+    if (!object_index.has_value())
+        return;
+
+    Resolution resolution { not_found, 0 };
+    if (result.has_value()) {
+        auto defining_object_index = m_object_indices.get(result->dynamic_object);
+        if (!defining_object_index.has_value())
+            return;
+        resolution = { static_cast<u32>(defining_object_index.value() + 1), result->symbol_index };
+    }
+
+    auto& resolutions = m_resolutions[object_index.value()];
+    if (symbol.index() >= resolutions.size())
+        resolutions.resize(symbol.index() + 1);
+    resolutions[symbol.index()] = resolution;
+    m_is_dirty = true;
+}
+
+void DynamicRelocationCache::save() const
+{
+    if (!m_is_dirty)
+        return;
+
+    // The cache is merely an optimization, so failing to write it is not an error.
+    if (auto result = try_save(); result.is_error())
+        dbgln_if(DYNAMIC_LOAD_DEBUG, "Failed to save relocation cache {}: {}", m_path, result.error());
+}
+
+ErrorOr<ByteBuffer> DynamicRelocationCache::serialize() const
+{
+    ByteBuffer buffer;
+
+    u32 resolution_count = 0;
+    for (auto const& resolutions : m_resolutions) {
+        for (auto const& resolution : resolutions) {
+            if (resolution.defining_object != 0)
+                ++resolution_count;
+        }
+    }
+
+    FileHeader header { file_magic, file_version, static_cast<u32>(m_objects.size()), resolution_count };
+    TRY(buffer.try_append(&header, sizeof(header)));
+
+    for (auto const& object : m_objects) {
+        auto const& path = object.object->filepath();
+        FileObject file_object { object.identity, static_cast<u32>(path.length()) };
+        TRY(buffer.try_append(&file_object, sizeof(file_object)));
+        TRY(buffer.try_append(path.characters(), path.length()));
+    }
+
+    for (u32 object = 0; object < m_resolutions.size(); ++object) {
+        auto const& resolutions = m_resolutions[object];
+        for (u32 symbol_index = 0; symbol_index < resolutions.size(); ++symbol_index) {
+            auto const& resolution = resolutions[symbol_index];
+            if (resolution.defining_object == 0)
+                continue;
+            FileResolution file_resolution { object, symbol_index, resolution.defining_object, resolution.symbol_index };
+            TRY(buffer.try_append(&file_resolution, sizeof(file_resolution)));
+        }
+    }
+
+    return buffer;
+}
+
+ErrorOr<void> DynamicRelocationCache::try_save() const
+{
+    auto buffer = TRY(serialize());
+
+    // We write a new file and move it into place, so that other instances of the program never see a partially written cache.
+    auto temporary_path = DeprecatedString::formatted("{}.{}", m_path, getpid());
+    int fd = ::open(temporary_path.characters(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return Error::from_errno(errno);
+    ArmedScopeGuard unlink_temporary_file = [&] { unlink(temporary_path.characters()); };
+
+    {
+        ScopeGuard close_fd = [fd] { close(fd); };
+        size_t nwritten = 0;
+        while (nwritten < buffer.size()) {
+            auto rc = write(fd, buffer.offset_pointer(nwritten), buffer.size() - nwritten);
+            if (rc < 0) {
+                if (errno == EINTR)
+                    continue;
+                return Error::from_errno(errno);
+            }
+            nwritten += rc;
+        }
+    }
+
+    if (rename(temporary_path.characters(), m_path.characters()) < 0)
+        return Error::from_errno(errno);
+    unlink_temporary_file.disarm();
+    return {};
+}
+
+}
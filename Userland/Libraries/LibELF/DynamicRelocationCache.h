@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibELF/DynamicObject.h>
+
+namespace ELF {
+
+// Identifies the exact build of an object, so we can tell whether it changed: This is its GNU build ID if it has one,
+// and the device, inode, size and modification time of the file it was loaded from otherwise.
+using DynamicObjectIdentity = Array<u8, 32>;
+
+// A prelink-style cache of the global symbol lookups needed to link a program, which is kept on disk.
+// It is keyed by the paths and identities of all objects that were loaded for the program. As long as none of them
+// changed, every symbol resolves to the same definition as last time, so the linker can take it from the cache
+// instead of searching every loaded object for it.
+// NOTE: Objects are loaded at random addresses, so we can only cache which symbol a relocation resolves to,
+//       not the relocated values themselves.
+class DynamicRelocationCache {
+public:
+    struct LoadedObject {
+        DynamicObject const* object { nullptr };
+        DynamicObjectIdentity identity;
+    };
+
+    // The objects have to be passed in the order they were loaded in.
+    // If there is no usable cache for them in the given directory, this starts out empty.
+    static DynamicRelocationCache open(StringView directory, StringView program_path, Vector<LoadedObject> objects);
+
+    // Returns whether the cache knows what the symbol resolves to. If it does, `result` is set to the definition, if any.
+    bool lookup(DynamicObject::Symbol const&, Optional<DynamicObject::SymbolLookupResult>& result);
+    void record(DynamicObject::Symbol const&, Optional<DynamicObject::SymbolLookupResult> const& result);
+
+    size_t hit_count() const { return m_hit_count; }
+
+    // Writes the cache back to disk, if we had to add anything to it.
+    void save() const;
+
+private:
+    DynamicRelocationCache(DeprecatedString path, Vector<LoadedObject> objects);
+
+    struct Resolution {
+        // The index of the defining object plus one, so zero means that we don't know yet.
+        u32 defining_object { 0 };
+        u32 symbol_index { 0 };
+    };
+    static constexpr u32 not_found = NumericLimits<u32>::max();
+
+    ErrorOr<void> load();
+    ErrorOr<void> try_save() const;
+    ErrorOr<ByteBuffer> serialize() const;
+
+    DeprecatedString m_path;
+    Vector<LoadedObject> m_objects;
+    HashMap<DynamicObject const*, size_t> m_object_indices;
+    // The resolutions of the symbols referenced by each object, indexed by the symbol index within that object.
+    Vector<Vector<Resolution>> m_resolutions;
+
+    size_t m_hit_count { 0 };
+    bool m_is_dirty { false };
+};
+
+}
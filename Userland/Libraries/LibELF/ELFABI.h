@@ -626,6 +626,9 @@ typedef struct {
 #define NT_FPREGSET 2 /* Floating point registers. */
 #define NT_PRPSINFO 3 /* Process state info. */
 
+/* Values for n_type in notes named "GNU". */
+#define NT_GNU_BUILD_ID 3 /* Unique build ID bitstring. */
+
 /*
  * OpenBSD-specific core file information.
  *
@@ -11,6 +11,12 @@
 
 namespace Gfx {
 
+static ScaledFont::List& all_scaled_fonts()
+{
+    static ScaledFont::List list;
+    return list;
+}
+
 ScaledFont::ScaledFont(NonnullRefPtr<VectorFont> font, float point_width, float point_height, unsigned dpi_x, unsigned dpi_y)
     : m_font(move(font))
     , m_point_width(point_width)
@@ -34,6 +40,19 @@ ScaledFont::ScaledFont(NonnullRefPtr<VectorFont> font, float point_width, float
         .descent = metrics.descender,
         .line_gap = metrics.line_gap,
     };
+
+    all_scaled_fonts().append(*this);
+}
+
+ScaledFont::~ScaledFont()
+{
+    all_scaled_fonts().remove(*this);
+}
+
+void ScaledFont::purge_all_cached_glyph_bitmaps()
+{
+    for (auto& font : all_scaled_fonts())
+        font.m_cached_glyph_bitmaps.clear();
 }
 
 int ScaledFont::width_rounded_up(StringView view) const
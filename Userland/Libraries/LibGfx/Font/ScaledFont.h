@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/Font.h>
 #include <LibGfx/Font/VectorFont.h>
@@ -27,6 +28,12 @@ struct GlyphIndexWithSubpixelOffset {
 class ScaledFont final : public Gfx::Font {
 public:
     ScaledFont(NonnullRefPtr<VectorFont>, float point_width, float point_height, unsigned dpi_x = DEFAULT_DPI, unsigned dpi_y = DEFAULT_DPI);
+    virtual ~ScaledFont() override;
+
+    // Drops the rasterized glyphs of every ScaledFont, e.g. when the system is running low on memory.
+    // They are rasterized again the next time they are needed.
+    static void purge_all_cached_glyph_bitmaps();
+
     u32 glyph_id_for_code_point(u32 code_point) const { return m_font->glyph_id_for_code_point(code_point); }
     ScaledFontMetrics metrics() const { return m_font->metrics(m_x_scale, m_y_scale); }
     ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const { return m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale, m_point_width, m_point_height); }
@@ -82,6 +89,7 @@ private:
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
     mutable HashMap<GlyphIndexWithSubpixelOffset, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
+    IntrusiveListNode<ScaledFont> m_all_scaled_fonts_list_node;
     Gfx::FontPixelMetrics m_pixel_metrics;
 
     float m_pixel_size { 0.0f };
@@ -89,6 +97,9 @@ private:
 
     template<typename T>
     float unicode_view_width(T const& view) const;
+
+public:
+    using List = IntrusiveList<&ScaledFont::m_all_scaled_fonts_list_node>;
 };
 
 }
@@ -9,9 +9,11 @@
 #include <LibAudio/Loader.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/MemoryPressureNotifier.h>
 #include <LibCore/StandardPaths.h>
 #include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
+#include <LibGfx/Font/ScaledFont.h>
 #include <LibIPC/SingleServer.h>
 #include <LibMain/Main.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
@@ -29,6 +31,11 @@ ErrorOr<int> serenity_main(Main::Arguments)
     Core::EventLoop event_loop;
     TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath thread proc"));
 
+    // NOTE: This has to be opened before we unveil anything.
+    auto memory_pressure_notifier = Core::MemoryPressureNotifier::create();
+    if (memory_pressure_notifier.is_error())
+        dbgln("WebContent: Unable to watch the memory pressure: {}", memory_pressure_notifier.error());
+
     // This must be first; we can't check if /tmp/webdriver exists once we've unveiled other paths.
     auto webdriver_socket_path = DeprecatedString::formatted("{}/webdriver", TRY(Core::StandardPaths::runtime_directory()));
     if (FileSystem::exists(webdriver_socket_path))
@@ -55,6 +62,17 @@ ErrorOr<int> serenity_main(Main::Arguments)
     Web::ResourceLoader::initialize(TRY(WebView::RequestServerAdapter::try_create()));
     TRY(Web::Bindings::initialize_main_thread_vm());
 
+    if (!memory_pressure_notifier.is_error()) {
+        memory_pressure_notifier.value()->on_pressure_change = [](MemoryPressureLevel level) {
+            if (level == MemoryPressureLevel::Normal)
+                return;
+            // Everything we drop here can be loaded or rasterized again when it's needed.
+            Web::ResourceLoader::the().clear_cache();
+            Gfx::ScaledFont::purge_all_cached_glyph_bitmaps();
+            Web::Bindings::main_thread_vm().heap().collect_garbage();
+        };
+    }
+
     auto client = TRY(IPC::take_over_accepted_client_from_system_server<WebContent::ConnectionFromClient>());
     return event_loop.exec();
 }
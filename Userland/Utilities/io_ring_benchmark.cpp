@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct Result {
+    u64 write_bps {};
+    u64 read_bps {};
+    u64 syscalls {};
+};
+
+static u64 bytes_per_second(size_t file_size, Core::ElapsedTimer const& timer)
+{
+    return (u64)(timer.elapsed_milliseconds() ? (file_size / timer.elapsed_milliseconds()) : file_size) * 1000;
+}
+
+static ErrorOr<Result> benchmark_syscalls(int fd, size_t file_size, ByteBuffer& buffer)
+{
+    Result result;
+
+    auto timer = Core::ElapsedTimer::start_new();
+    for (size_t offset = 0; offset < file_size; offset += buffer.size()) {
+        if (pwrite(fd, buffer.data(), buffer.size(), offset) < 0)
+            return Error::from_syscall("pwrite"sv, -errno);
+        ++result.syscalls;
+    }
+    result.write_bps = bytes_per_second(file_size, timer);
+
+    timer.start();
+    for (size_t offset = 0; offset < file_size; offset += buffer.size()) {
+        if (pread(fd, buffer.data(), buffer.size(), offset) < 0)
+            return Error::from_syscall("pread"sv, -errno);
+        ++result.syscalls;
+    }
+    result.read_bps = bytes_per_second(file_size, timer);
+
+    return result;
+}
+
+static ErrorOr<void> run_ring_batches(Core::IORing& ring, bool write, int fd, size_t file_size, ByteBuffer& buffer, Result& result)
+{
+    size_t next_offset = 0;
+    size_t completed = 0;
+    size_t const block_count = file_size / buffer.size();
+    while (completed < block_count) {
+        while (next_offset < file_size) {
+            // All requests use the same buffer; we only care about the cost of getting them into the kernel.
+            auto queued = write
+                ? ring.submit_write(fd, buffer, static_cast<off_t>(next_offset), next_offset)
+                : ring.submit_read(fd, buffer, static_cast<off_t>(next_offset), next_offset);
+            if (queued.is_error())
+                break;
+            next_offset += buffer.size();
+        }
+
+        TRY(ring.submit());
+        ++result.syscalls;
+
+        while (auto completion = ring.pop_completion()) {
+            if (completion->result < 0)
+                return Error::from_errno(static_cast<int>(-completion->result));
+            ++completed;
+        }
+    }
+    return {};
+}
+
+static ErrorOr<Result> benchmark_ring(Core::IORing& ring, int fd, size_t file_size, ByteBuffer& buffer)
+{
+    Result result;
+
+    auto timer = Core::ElapsedTimer::start_new();
+    TRY(run_ring_batches(ring, true, fd, file_size, buffer, result));
+    result.write_bps = bytes_per_second(file_size, timer);
+
+    timer.start();
+    TRY(run_ring_batches(ring, false, fd, file_size, buffer, result));
+    result.read_bps = bytes_per_second(file_size, timer);
+
+    return result;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    DeprecatedString directory = ".";
+    size_t file_size = 4 * MiB;
+    size_t block_size = 4096;
+    u32 ring_entries = 64;
+    bool allow_cache = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(allow_cache, "Allow using disk cache", "cache", 'c');
+    args_parser.add_option(directory, "Path to a directory where we can store the benchmark temp file", "directory", 'd', "directory");
+    args_parser.add_option(file_size, "File size", "file-size", 'f', "file-size");
+    args_parser.add_option(block_size, "Block size", "block-size", 'b', "block-size");
+    args_parser.add_option(ring_entries, "Number of submission ring entries (power of two)", "entries", 'e', "entries");
+    args_parser.parse(arguments);
+
+    if (block_size == 0 || file_size % block_size != 0) {
+        warnln("File size must be a non-zero multiple of the block size");
+        return 1;
+    }
+
+    auto filename = DeprecatedString::formatted("{}/io_ring_benchmark.tmp", directory);
+    int flags = O_CREAT | O_TRUNC | O_RDWR;
+    if (!allow_cache)
+        flags |= O_DIRECT;
+
+    int fd = TRY(Core::System::open(filename, flags, 0644));
+    ScopeGuard fd_cleanup = [fd, &filename] {
+        (void)Core::System::close(fd);
+        (void)Core::System::unlink(filename);
+    };
+
+    auto buffer = TRY(ByteBuffer::create_zeroed(block_size));
+    auto ring = TRY(Core::IORing::create(ring_entries));
+
+    outln("Running: file_size={} block_size={} ring_entries={}", file_size, block_size, ring_entries);
+
+    auto syscall_result = TRY(benchmark_syscalls(fd, file_size, buffer));
+    outln("syscalls: write_bps={} read_bps={} syscalls={}", syscall_result.write_bps, syscall_result.read_bps, syscall_result.syscalls);
+
+    auto ring_result = TRY(benchmark_ring(*ring, fd, file_size, buffer));
+    outln("io_ring:  write_bps={} read_bps={} syscalls={}", ring_result.write_bps, ring_result.read_bps, ring_result.syscalls);
+
+    return 0;
+}
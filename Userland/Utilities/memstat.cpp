@@ -9,6 +9,7 @@
 #include <AK/JsonValue.h>
 #include <AK/NumberFormat.h>
 #include <AK/String.h>
+#include <Kernel/API/MemoryPressure.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
 #include <LibCore/System.h>
@@ -20,6 +21,19 @@ static inline u64 page_count_to_bytes(size_t count)
     return count * PAGE_SIZE;
 }
 
+static StringView memory_pressure_level_name(u32 level)
+{
+    switch (static_cast<MemoryPressureLevel>(level)) {
+    case MemoryPressureLevel::Normal:
+        return "normal"sv;
+    case MemoryPressureLevel::Moderate:
+        return "moderate"sv;
+    case MemoryPressureLevel::Critical:
+        return "critical"sv;
+    }
+    return "unknown"sv;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     TRY(Core::System::unveil("/sys/kernel/memstat", "r"));
@@ -45,6 +59,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     u64 physical_uncommitted = json.get_u64("physical_uncommitted"sv).value_or(0);
     u32 kmalloc_call_count = json.get_u32("kmalloc_call_count"sv).value_or(0);
     u32 kfree_call_count = json.get_u32("kfree_call_count"sv).value_or(0);
+    u64 large_pages_mapped = json.get_u64("large_pages_mapped"sv).value_or(0);
+    u64 large_page_allocations = json.get_u64("large_page_allocations"sv).value_or(0);
+    u64 large_page_splits = json.get_u64("large_page_splits"sv).value_or(0);
+    u64 same_page_merging_full_scans = json.get_u64("same_page_merging_full_scans"sv).value_or(0);
+    u64 same_page_merging_pages_merged = json.get_u64("same_page_merging_pages_merged"sv).value_or(0);
+    u64 same_page_merging_pages_sharing = json.get_u64("same_page_merging_pages_sharing"sv).value_or(0);
+    u32 memory_pressure_level = json.get_u32("memory_pressure_level"sv).value_or(0);
+    u64 memory_pressure_pages_purged = json.get_u64("memory_pressure_pages_purged"sv).value_or(0);
 
     u64 kmalloc_bytes_total = kmalloc_allocated + kmalloc_available;
     u64 physical_pages_total = physical_allocated + physical_available;
@@ -66,5 +88,19 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     outln("Kmalloc call count: {}", kmalloc_call_count);
     outln("Kfree call count: {}", kfree_call_count);
     outln("Kmalloc/Kfree delta: {}", TRY(String::formatted("{:+}", kmalloc_call_count - kfree_call_count)));
+    outln("Large pages (mapped) count: {}", large_pages_mapped);
+    outln("Large page allocations: {}", large_page_allocations);
+    outln("Large page splits: {}", large_page_splits);
+    outln("Same-page merging full scans: {}", same_page_merging_full_scans);
+    outln("Same-page merging pages merged: {}", same_page_merging_pages_merged);
+    if (flag_human_readable)
+        outln("Same-page merging saved: {}", human_readable_size_long(page_count_to_bytes(same_page_merging_pages_sharing), UseThousandsSeparator::Yes));
+    else
+        outln("Same-page merging saved: {}", page_count_to_bytes(same_page_merging_pages_sharing));
+    outln("Memory pressure: {}", memory_pressure_level_name(memory_pressure_level));
+    if (flag_human_readable)
+        outln("Memory pressure purged: {}", human_readable_size_long(page_count_to_bytes(memory_pressure_pages_purged), UseThousandsSeparator::Yes));
+    else
+        outln("Memory pressure purged: {}", page_count_to_bytes(memory_pressure_pages_purged));
     return 0;
 }
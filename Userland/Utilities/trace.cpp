@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/DeprecatedString.h>
+#include <AK/IPv4Address.h>
+#include <AK/QuickSort.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <Kernel/API/SyscallString.h>
+#include <Kernel/API/Tracepoint.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr Array<StringView, to_underlying(TracepointID::__Count)> s_tracepoint_names = {
+    "context-switch"sv,
+    "page-fault"sv,
+    "block-submit"sv,
+    "block-complete"sv,
+    "syscall-enter"sv,
+    "syscall-exit"sv,
+    "tcp-state"sv,
+};
+
+static constexpr Array<StringView, 11> s_tcp_state_names = {
+    "Closed"sv,
+    "Listen"sv,
+    "SynSent"sv,
+    "SynReceived"sv,
+    "Established"sv,
+    "CloseWait"sv,
+    "LastAck"sv,
+    "FinWait1"sv,
+    "FinWait2"sv,
+    "Closing"sv,
+    "TimeWait"sv,
+};
+
+static volatile sig_atomic_t s_interrupted = false;
+
+static void handle_sigint(int)
+{
+    s_interrupted = true;
+}
+
+static ErrorOr<u32> parse_tracepoint_mask(StringView events)
+{
+    if (events.is_empty())
+        return all_tracepoints_mask;
+
+    u32 mask = 0;
+    for (auto event : events.split_view(',')) {
+        auto index = s_tracepoint_names.first_index_of(event);
+        if (!index.has_value()) {
+            warnln("Unknown tracepoint '{}', expected one of: {}", event, DeprecatedString::join(", "sv, s_tracepoint_names));
+            return Error::from_errno(EINVAL);
+        }
+        mask |= tracepoint_mask(static_cast<TracepointID>(index.value()));
+    }
+    return mask;
+}
+
+static StringView tcp_state_name(u64 state)
+{
+    return state < s_tcp_state_names.size() ? s_tcp_state_names[state] : "Unknown"sv;
+}
+
+static ErrorOr<void> print_record(Core::File& output, TraceRecord const& record)
+{
+    auto const& arguments = record.arguments;
+    TRY(output.write_formatted("[{}] {}.{:09} {}:{} {} ", record.processor, record.timestamp_ns / 1'000'000'000, record.timestamp_ns % 1'000'000'000, record.pid, record.tid, s_tracepoint_names[to_underlying(record.id)]));
+
+    switch (record.id) {
+    case TracepointID::ContextSwitch:
+        TRY(output.write_formatted("{} -> {} (pid {}), previous state {}\n", arguments[0], arguments[1], arguments[3], arguments[2]));
+        break;
+    case TracepointID::PageFault:
+        TRY(output.write_formatted("address={:p} ip={:p} {}{}{}\n", arguments[0], arguments[1],
+            arguments[2] & TRACE_PAGE_FAULT_WRITE ? "write"sv : "read"sv,
+            arguments[2] & TRACE_PAGE_FAULT_USER ? " user"sv : " kernel"sv,
+            arguments[2] & TRACE_PAGE_FAULT_PROTECTION_VIOLATION ? " protection-violation"sv : ""sv));
+        break;
+    case TracepointID::BlockIOSubmit:
+    case TracepointID::BlockIOComplete:
+        TRY(output.write_formatted("device={},{} {} block={} count={}", arguments[0] >> 32, arguments[0] & 0xffffffff, arguments[3] ? "write"sv : "read"sv, arguments[1], arguments[2]));
+        if (record.id == TracepointID::BlockIOComplete)
+            TRY(output.write_formatted(" result={}", arguments[4]));
+        TRY(output.write_until_depleted("\n"sv.bytes()));
+        break;
+    case TracepointID::SyscallEnter:
+        TRY(output.write_formatted("{}({:#x}, {:#x}, {:#x}, {:#x})\n", Syscall::to_string(static_cast<Syscall::Function>(arguments[0])), arguments[1], arguments[2], arguments[3], arguments[4]));
+        break;
+    case TracepointID::SyscallExit:
+        TRY(output.write_formatted("{} = {}\n", Syscall::to_string(static_cast<Syscall::Function>(arguments[0])), static_cast<i64>(arguments[1])));
+        break;
+    case TracepointID::TCPStateChange:
+        TRY(output.write_formatted("{}:{} -> {}:{} {} -> {}\n",
+            IPv4Address(static_cast<u32>(arguments[0])), arguments[2] >> 16,
+            IPv4Address(static_cast<u32>(arguments[1])), arguments[2] & 0xffff,
+            tcp_state_name(arguments[3]), tcp_state_name(arguments[4])));
+        break;
+    default:
+        TRY(output.write_formatted("{:#x} {:#x} {:#x} {:#x} {:#x}\n", arguments[0], arguments[1], arguments[2], arguments[3], arguments[4]));
+        break;
+    }
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView events;
+    StringView output_filename;
+    pid_t pid_filter = -1;
+    double duration = 0;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Stream records from the kernel tracepoints until interrupted.");
+    args_parser.add_option(events, "Comma-delimited tracepoints to enable (default: all)", "events", 'e', "events");
+    args_parser.add_option(pid_filter, "Only show records from the given PID", "pid", 'p', "pid");
+    args_parser.add_option(duration, "Stop after the given number of seconds", "duration", 'd', "seconds");
+    args_parser.add_option(output_filename, "Filename to write output to", "output", 'o', "output");
+    args_parser.parse(arguments);
+
+    auto mask = TRY(parse_tracepoint_mask(events));
+
+    auto output = output_filename.is_empty()
+        ? TRY(Core::File::standard_output())
+        : TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+
+    int fd = TRY(Core::System::open("/dev/trace"sv, O_RDONLY | O_CLOEXEC));
+    TraceInfo info {};
+    TRY(Core::System::ioctl(fd, TRACE_IOCTL_GET_INFO, &info));
+
+    Vector<TraceBufferHeader*> buffers;
+    for (u32 processor = 0; processor < info.processor_count; ++processor) {
+        auto* buffer = TRY(Core::System::mmap(nullptr, info.buffer_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(processor) * info.buffer_size, 0, "trace buffer"sv));
+        auto* header = static_cast<TraceBufferHeader*>(buffer);
+        // Skip whatever an earlier reader left behind.
+        AK::atomic_store(&header->tail, AK::atomic_load(&header->head, AK::memory_order_acquire), AK::memory_order_release);
+        TRY(buffers.try_append(header));
+    }
+
+    struct sigaction sa = {};
+    sa.sa_handler = handle_sigint;
+    TRY(Core::System::sigaction(SIGINT, &sa, nullptr));
+
+    u64 initial_dropped = 0;
+    for (auto* header : buffers)
+        initial_dropped += AK::atomic_load(&header->dropped, AK::memory_order_relaxed);
+
+    TRY(Core::System::ioctl(fd, TRACE_IOCTL_ENABLE, mask));
+
+    // Records are drained from all processors in batches, and each batch is printed in timestamp order.
+    // NOTE: We leave out our own records, since printing them would only generate more of them.
+    auto own_pid = static_cast<u32>(getpid());
+    Vector<TraceRecord> batch;
+    auto timer = Core::ElapsedTimer::start_new();
+    while (!s_interrupted && (duration <= 0 || timer.elapsed_milliseconds() < duration * 1000)) {
+        batch.clear_with_capacity();
+        for (auto* header : buffers) {
+            auto* records = reinterpret_cast<TraceRecord const*>(reinterpret_cast<u8 const*>(header) + header->records_offset);
+            auto head = AK::atomic_load(&header->head, AK::memory_order_acquire);
+            auto tail = header->tail;
+            for (; tail != head; ++tail) {
+                auto const& record = records[tail % header->record_count];
+                if (record.pid == own_pid)
+                    continue;
+                if (pid_filter == -1 || record.pid == static_cast<u32>(pid_filter))
+                    TRY(batch.try_append(record));
+            }
+            AK::atomic_store(&header->tail, tail, AK::memory_order_release);
+        }
+
+        if (batch.is_empty()) {
+            usleep(10'000);
+            continue;
+        }
+
+        quick_sort(batch, [](auto const& a, auto const& b) { return a.timestamp_ns < b.timestamp_ns; });
+        for (auto const& record : batch)
+            TRY(print_record(*output, record));
+    }
+
+    TRY(Core::System::ioctl(fd, TRACE_IOCTL_DISABLE));
+
+    u64 dropped = 0;
+    for (auto* header : buffers)
+        dropped += AK::atomic_load(&header->dropped, AK::memory_order_relaxed);
+    if (dropped > initial_dropped)
+        warnln("trace: {} records were dropped because the trace buffers were full", dropped - initial_dropped);
+
+    return 0;
+}